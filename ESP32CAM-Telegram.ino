@@ -19,19 +19,34 @@ WebServer server(80);
 int captureMode = 0;          // 0 motion, 1 time, 2 mixed
 int timeInterval = 5;         // minutes (1..1000)
 bool motionEnabled = true;
-int motionThreshold = 5000;   // threshold for length-diff heuristic
+int motionThreshold = 5000;   // sensitivity 1000..20000 (lower = more sensitive)
+int preEventKB = PREBUFFER_DEFAULT_KB;  // pre-event ring budget (0 = off)
+int preEventFrames = 3;       // frames before the trigger in a motion album
+int postEventFrames = 2;      // frames after it
+ScheduleRule scheduleRules[SCHED_MAX_RULES];   // extra wall-clock captures (/schedule)
+int scheduleRuleCount = 0;
+int dedupDistance = DEDUP_DEFAULT_DISTANCE;    // pHash bits; 0 = upload every scheduled capture
+bool dedupHeartbeat = false;                   // text instead of a suppressed photo
 
 // Statistics
 int capturedCount = 0;
 int sentCount = 0;
-String lastCaptureTime = "Never";
-String lastTelegramResult = "Never";
-String lastCaptureType = "None";
-String telegramDebug = "";
+StatusText lastCaptureTime = "Never";
+StatusText lastTelegramResult = "Never";
+StatusText lastCaptureType = "None";
+DebugText telegramDebug;
+SemaphoreHandle_t statusMutex = nullptr;
+SemaphoreHandle_t settingsMutex = nullptr;
 
 // Motion detection
-uint8_t* previousFrame = nullptr;
-size_t previousFrameSize = 0;
+MotionEngine motionEngine;
+MotionResult lastMotion;
+unsigned long lastMotionCostUs = 0;
+unsigned long lastMotionCheckMs = 0;
+unsigned long motionGapMs = 0;       // time between the last two checks
+unsigned long motionMaxGapMs = 0;
+bool motionFromStream = false;       // last check used a /mjpeg frame
+size_t previousFrameSize = 0;     // fallback length heuristic only
 unsigned long lastMotionTime = 0;
 unsigned long lastCaptureMillis = 0;
 
@@ -42,6 +57,7 @@ static int dirtySinceLastPersist = 0;
 
 // Include HTML page
 #include "html_page.h"
+#include "html_page_gz.h"
 
 // Forward
 static void markStatsDirty();
@@ -52,7 +68,13 @@ void setup() {
   delay(100);
   Serial.println("\n=== ESP32-CAM Security System (Stable Build) ===");
 
-  // EEPROM
+  startEventLog((int)esp_reset_reason());
+  statusMutex = xSemaphoreCreateRecursiveMutex();
+  settingsMutex = xSemaphoreCreateMutex();
+  startTelegramTransport();
+  startTelegramFanout();
+
+  // EEPROM (legacy settings, migrated to the settings store on first boot)
   EEPROM.begin(EEPROM_SIZE);
 
   // SPIFFS mount ONCE
@@ -61,8 +83,11 @@ void setup() {
   } else {
     Serial.println("SPIFFS mounted successfully");
   }
+  loadUpdateOffset();
+  loadOutbox();
 
   loadSettings();
+  startPrebuffer();
 
   // Camera
   if (!initializeCamera()) {
@@ -74,6 +99,12 @@ void setup() {
  setupTimeTehran();
 
   setupServerRoutes();
+  startLiveEvents();
+  startWebServer();
+  startUploadPipeline();
+  startBurst();
+  startMjpegStream();
+  startTelegramPolling();
 
   Serial.println("=== System Ready ===");
   Serial.println("Web: http://" + WiFi.localIP().toString());
@@ -83,44 +114,51 @@ void setup() {
 }
 
 void loop() {
-  server.handleClient();
+#if !WEB_SERVER_TASK
+  serviceWebServer();
+#endif
   checkTelegramCommands();
+  sendParkedReplies();
 
   unsigned long currentMillis = millis();
-
-  // Persist stats/settings throttled (avoid flash wear & stalls)
-  maybePersistStats();
-
-  // Time-based capture check (each second)
-  static unsigned long lastTimeCheck = 0;
-  if (currentMillis - lastTimeCheck >= 1000) {
-    lastTimeCheck = currentMillis;
-
-    unsigned long intervalSeconds = (unsigned long)timeInterval * 60UL;
-    if (intervalSeconds < 60) intervalSeconds = 60;
-
-    unsigned long currentSeconds = currentMillis / 1000UL;
-
-    if ((captureMode == 1 || captureMode == 2) &&
-        (currentSeconds % intervalSeconds == 0) &&
-        (currentMillis - lastCaptureMillis > 30000)) {
-      captureImage("Time Based");
-    }
-  }
-
-  // Motion-based capture check (each 500ms)
   static unsigned long lastMotionCheck = 0;
-  if (currentMillis - lastMotionCheck >= 500) {
-    lastMotionCheck = currentMillis;
-
-    if ((captureMode == 0 || captureMode == 2) &&
-        detectMotion() &&
-        (currentMillis - lastCaptureMillis > 10000)) {
-      captureImage("Motion Detection");
+  {
+    // /save-settings (web task) waits for this pass, never lands in the middle of it
+    SettingsLock lock;
+
+    // Persist stats/settings throttled (avoid flash wear & stalls)
+    maybePersistStats();
+    flushUpdateOffset(false);
+    settingsStoreTick();
+    heapWatchTick();
+
+    // Time-based and wall-clock captures (absolute deadlines, scheduler.h)
+    schedulerTick();
+
+    // Motion-based capture check (small frames, see camera_profile.h)
+    if (currentMillis - lastMotionCheck >= MOTION_CHECK_MS) {
+      lastMotionCheck = currentMillis;
+
+      if ((captureMode == 0 || captureMode == 2) &&
+          detectMotion() &&
+          (currentMillis - lastCaptureMillis > 10000)) {
+        captureMotionEvent();
+      }
     }
+    prebufferTick();
   }
 
-  delay(5);
+  // Sleep until the next deadline or motion check; a Telegram command wakes us early
+  unsigned long wait = schedMsUntilNext();
+  if (captureMode == 0 || captureMode == 2) {
+    unsigned long since = millis() - lastMotionCheck;
+    unsigned long motionWait = since >= MOTION_CHECK_MS ? 0 : MOTION_CHECK_MS - since;
+    if (motionWait < wait) wait = motionWait;
+  }
+#if !WEB_SERVER_TASK
+  if (wait > 5) wait = 5;     // handleClient() still runs from here
+#endif
+  waitTelegramCommand(wait ? wait : 1);
 }
 
 static void setupTimeTehran() {
@@ -135,6 +173,7 @@ static void setupTimeTehran() {
   struct tm timeinfo;
   for (int i = 0; i < 20; i++) {
     if (getLocalTime(&timeinfo, 500)) {
+      logEvent(EV_TIME_SYNC, (int32_t)time(nullptr));
       Serial.printf("Time synced (Tehran): %04d-%02d-%02d %02d:%02d:%02d\n",
                     timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
                     timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
@@ -148,17 +187,20 @@ static void setupTimeTehran() {
 
 
 static void markStatsDirty() {
+  StatusLock lock;
   statsDirty = true;
   dirtySinceLastPersist++;
+  markStatusChanged();
 }
 
 static void maybePersistStats() {
+  StatusLock lock;
   const unsigned long now = millis();
   const bool timeDue = (now - lastPersistMillis) > 60000UL;   // 60s
   const bool countDue = dirtySinceLastPersist >= 10;          // or 10 changes
 
   if (statsDirty && (timeDue || countDue)) {
-    saveSettings(); // writes struct + commit
+    saveSettings(); // appends changed settings / counter deltas
     statsDirty = false;
     dirtySinceLastPersist = 0;
     lastPersistMillis = now;
@@ -166,4 +208,24 @@ static void maybePersistStats() {
 }
 
 // Include all function implementations
+#include "event_log.h"
+#include "metrics.h"
+#include "camera_profile.h"
+#include "offset_journal.h"
+#include "settings_store.h"
+#include "outbox.h"
+#include "telegram_request.h"
+#include "telegram_transport.h"
+#include "telegram_fanout.h"
+#include "telegram_poll.h"
+#include "upload_queue.h"
+#include "prebuffer.h"
+#include "burst.h"
+#include "mjpeg_stream.h"
+#include "web_jobs.h"
+#include "dedup.h"
+#include "scheduler.h"
+#include "web_status.h"
+#include "live_events.h"
 #include "functions.h"
+#include "telegram_commands.h"
@@ -0,0 +1,221 @@
+#ifndef BURST_H
+#define BURST_H
+
+// ------------ Burst capture ------------
+// /burst N [interval_ms] grabs N frames at the capture profile, back to back
+// (or every interval_ms), copying each into PSRAM and handing the frame
+// buffer straight back so the sensor keeps going. The set then goes to the
+// upload task as one sendMediaGroup whose body parts point at the copies.
+// Adding "single" sends the same frames as N sendPhoto calls instead, so
+// both upload styles can be timed on the same link; /debug -> burst shows
+// the capture FPS and average upload time per frame for each style.
+
+#define BURST_MAX_FRAMES TELEGRAM_ALBUM_MAX
+#define BURST_SLOTS 2
+#ifndef BURST_MAX_KB
+#define BURST_MAX_KB 2048
+#endif
+#define BURST_MAX_INTERVAL_MS 5000
+
+struct BurstSet {
+  bool used;
+  bool single;                   // upload as separate sendPhoto calls
+  uint8_t count;
+  uint16_t sentMask;             // frames already delivered (single mode)
+  uint8_t* bufs[BURST_MAX_FRAMES];
+  size_t lens[BURST_MAX_FRAMES];
+  char caption[96];
+};
+
+struct BurstStats {
+  uint32_t bursts = 0;
+  uint32_t rejected = 0;         // no free slot / no frame / no memory
+  uint8_t lastFrames = 0;
+  size_t lastBytes = 0;
+  unsigned long lastCaptureMs = 0;
+  float lastFps = 0;
+  bool lastSingle = false;
+  unsigned long lastUploadMs = 0;
+  uint32_t albumFrames = 0;      // uploaded frames and time, per style
+  uint32_t singleFrames = 0;
+  uint64_t albumMs = 0;
+  uint64_t singleMs = 0;
+};
+
+static BurstSet burstSets[BURST_SLOTS];
+static BurstStats burstStats;
+static SemaphoreHandle_t burstMutex = nullptr;
+
+void startBurst() {
+  burstMutex = xSemaphoreCreateMutex();
+}
+
+void releaseBurst(int b) {
+  if (!burstMutex || b < 0 || b >= BURST_SLOTS) return;
+  BurstSet& s = burstSets[b];
+  for (int i = 0; i < s.count; i++) {
+    free(s.bufs[i]);
+    s.bufs[i] = nullptr;
+  }
+  xSemaphoreTake(burstMutex, portMAX_DELAY);
+  s.count = 0;
+  s.used = false;
+  xSemaphoreGive(burstMutex);
+}
+
+// Grabs the frames and queues the upload. `result` is a one-line summary.
+bool captureBurst(int n, unsigned long intervalMs, bool single, FixedText& result) {
+  if (!burstMutex) return false;
+  if (n < 2) n = 2;
+  if (n > BURST_MAX_FRAMES) n = BURST_MAX_FRAMES;
+  if (intervalMs > BURST_MAX_INTERVAL_MS) intervalMs = BURST_MAX_INTERVAL_MS;
+
+  int b = -1;
+  xSemaphoreTake(burstMutex, portMAX_DELAY);
+  for (int i = 0; i < BURST_SLOTS; i++) {
+    if (!burstSets[i].used) { b = i; burstSets[i].used = true; break; }
+  }
+  xSemaphoreGive(burstMutex);
+  if (b < 0) {
+    burstStats.rejected++;
+    result.add("previous bursts still uploading");
+    return false;
+  }
+
+  BurstSet& s = burstSets[b];
+  s.single = single;
+  s.count = 0;
+  s.sentMask = 0;
+  size_t total = 0;
+  unsigned long tStart = millis(), tFirst = 0, tLast = 0;
+  {
+    // Back to back, motion checks must not flip the sensor mid-burst. With
+    // an interval each grab locks on its own, so /stream, MJPEG and motion
+    // checks are not held off for up to (N-1) x interval.
+    CameraLock lock(intervalMs == 0);
+    for (int i = 0; i < n; i++) {
+      if (i && intervalMs) {
+        long wait = (long)(tStart + i * intervalMs - millis());
+        if (wait > 0) delay(wait);
+      }
+      camera_fb_t* fb = grabFrame(PROFILE_CAPTURE);
+      if (!fb) break;
+      uint8_t* copy = nullptr;
+      if (total + fb->len <= BURST_MAX_KB * 1024UL) copy = (uint8_t*)uploadAlloc(fb->len);
+      if (copy) memcpy(copy, fb->buf, fb->len);
+      size_t len = fb->len;
+      esp_camera_fb_return(fb);
+      if (!copy) break;
+      tLast = millis();
+      if (i == 0) tFirst = tLast;
+      s.bufs[s.count] = copy;
+      s.lens[s.count] = len;
+      s.count++;
+      total += len;
+    }
+  }
+
+  if (s.count < 2) {
+    burstStats.rejected++;
+    releaseBurst(b);
+    result.add("camera or memory failure");
+    return false;
+  }
+
+  InlineText<12> when = timeText();
+  {
+    StatusLock lock;
+    capturedCount += s.count;
+    lastCaptureTime = when;
+    lastCaptureType = "Burst";
+  }
+  lastCaptureMillis = millis();
+  extern void markStatsDirty(); // from .ino
+  markStatsDirty();
+
+  float fps = tLast > tFirst ? (s.count - 1) * 1000.0f / (tLast - tFirst) : 0.0f;
+  burstStats.bursts++;
+  burstStats.lastFrames = s.count;
+  burstStats.lastBytes = total;
+  burstStats.lastCaptureMs = tLast - tStart;
+  burstStats.lastFps = fps;
+  logEvent(EV_BURST, s.count, (int32_t)(fps * 10));
+
+  FixedText caption(s.caption, sizeof(s.caption));
+  caption.addf("ESP32-CAM: Burst x%u | %s", (unsigned)s.count, when.c_str());
+
+  result.addf("%u frames, %lu KB in %lu ms (%.1f fps), ", (unsigned)s.count, (unsigned long)(total / 1024),
+              tLast - tStart, fps);
+  if (!enqueueBurst(b, total, s.caption)) {
+    releaseBurst(b);
+    result.add("upload queue full");
+    return false;
+  }
+  result.add(single ? "queued as single photos" : "queued as album");
+  return true;
+}
+
+// Upload task
+bool sendBurst(int b) {
+  BurstSet& s = burstSets[b];
+  unsigned long t0 = millis();
+  bool ok = true;
+  if (s.single) {
+    for (int i = 0; i < s.count; i++) {
+      if (s.sentMask & (1U << i)) continue;
+      InlineText<24> part;
+      part.addf("Burst %d/%u", i + 1, (unsigned)s.count);
+      if (sendPhotoBuffer(s.bufs[i], s.lens[i], i == 0 ? s.caption : part.c_str())) s.sentMask |= 1U << i;
+      else ok = false;
+    }
+  } else {
+    ok = sendAlbumBuffers(s.bufs, s.lens, s.count, s.caption);
+  }
+
+  unsigned long dt = millis() - t0;
+  burstStats.lastSingle = s.single;
+  burstStats.lastUploadMs = dt;
+  if (ok) {
+    if (s.single) { burstStats.singleFrames += s.count; burstStats.singleMs += dt; }
+    else { burstStats.albumFrames += s.count; burstStats.albumMs += dt; }
+  }
+  return ok;
+}
+
+// Upload task: park the frames that did not go out
+void storeBurstInOutbox(int b) {
+  BurstSet& s = burstSets[b];
+  uint8_t parts = 0;
+  for (int i = 0; i < s.count; i++) {
+    if (!(s.sentMask & (1U << i))) parts++;
+  }
+  uint8_t part = 0;
+  for (int i = 0; i < s.count; i++) {
+    if (s.sentMask & (1U << i)) continue;
+    InlineText<24> label;
+    label.addf("Burst %d/%u", i + 1, (unsigned)s.count);
+    outboxStore(s.bufs[i], s.lens[i], i == 0 ? s.caption : label.c_str(), part++, parts);
+  }
+}
+
+void fillBurstStats(JsonObject o) {
+  o["bursts"] = burstStats.bursts;
+  o["rejected"] = burstStats.rejected;
+  o["lastFrames"] = burstStats.lastFrames;
+  o["lastKB"] = burstStats.lastBytes / 1024;
+  o["lastCaptureMs"] = burstStats.lastCaptureMs;
+  o["lastFps"] = burstStats.lastFps;
+  o["lastUpload"] = burstStats.lastSingle ? "single" : "album";
+  o["lastUploadMs"] = burstStats.lastUploadMs;
+  o["albumMsPerFrame"] = burstStats.albumFrames ? (uint32_t)(burstStats.albumMs / burstStats.albumFrames) : 0;
+  o["singleMsPerFrame"] = burstStats.singleFrames ? (uint32_t)(burstStats.singleMs / burstStats.singleFrames) : 0;
+}
+
+void burstStatsLine(FixedText& out) {
+  out.addf("burst: last %u frames at %.1f fps, upload/frame album %lu ms vs single %lu ms",
+           (unsigned)burstStats.lastFrames, burstStats.lastFps,
+           burstStats.albumFrames ? (unsigned long)(burstStats.albumMs / burstStats.albumFrames) : 0UL,
+           burstStats.singleFrames ? (unsigned long)(burstStats.singleMs / burstStats.singleFrames) : 0UL);
+}
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef CAMERA_PROFILE_H
+#define CAMERA_PROFILE_H
+
+// ------------ Sensor profiles: small frames for motion, full size for captures ------------
+// The camera is initialised at the capture size (its frame buffers are sized
+// for that) and motion checks run on a small, low-quality JPEG that is cheap
+// to DMA, copy and DC-decode. A grab for a capture switches the sensor to
+// the capture profile, drops the frames that were already queued at the old
+// size, and leaves it there until the next motion check switches back.
+// Switches and grabs are serialised by cameraMutex; a switch is timed from
+// the register writes to the first frame at the new size.
+//
+// Motion frames also feed the pre-event ring, so while the ring is enabled
+// the motion profile uses MOTION_RING_FRAME_SIZE to keep albums readable.
+// While /mjpeg has viewers, motion analyses stream frames and the sensor
+// stays on the capture profile.
+
+#ifndef MOTION_FRAME_SIZE
+#define MOTION_FRAME_SIZE FRAMESIZE_QVGA        // pre-event ring off
+#endif
+#ifndef MOTION_RING_FRAME_SIZE
+#define MOTION_RING_FRAME_SIZE FRAMESIZE_VGA    // motion frames end up in albums
+#endif
+#ifndef MOTION_JPEG_QUALITY
+#define MOTION_JPEG_QUALITY 18
+#endif
+#define PROFILE_FLUSH_MAX 3      // stale frames dropped at most after a resize
+
+struct CameraProfileSpec {
+  framesize_t size;
+  int quality;
+};
+
+struct CameraProfileStats {
+  uint32_t switches = 0;
+  uint32_t flushed = 0;
+  uint32_t grabs[2] = { 0, 0 };
+  unsigned long lastSwitchUs = 0;
+  unsigned long maxSwitchUs = 0;
+  uint64_t totalSwitchUs = 0;
+  size_t lastLen[2] = { 0, 0 };   // JPEG bytes of the last frame per profile
+};
+
+static CameraProfileSpec captureSpec = { FRAMESIZE_SVGA, 10 };
+static CameraProfileSpec sensorSpec = { FRAMESIZE_SVGA, 10 };   // what the sensor runs now
+static SemaphoreHandle_t cameraMutex = nullptr;
+static CameraProfileStats camStats;
+
+// Called by initializeCamera() once esp_camera_init() succeeded
+void startCameraProfiles(framesize_t size, int quality) {
+  captureSpec.size = sensorSpec.size = size;
+  captureSpec.quality = sensorSpec.quality = quality;
+  cameraMutex = xSemaphoreCreateRecursiveMutex();
+}
+
+// Keeps the sensor to one caller across several grabs (burst capture);
+// CameraLock(false) takes nothing, for callers that lock only sometimes
+struct CameraLock {
+  bool held;
+  explicit CameraLock(bool take = true) : held(take && cameraMutex) {
+    if (held) xSemaphoreTakeRecursive(cameraMutex, portMAX_DELAY);
+  }
+  ~CameraLock() { if (held) xSemaphoreGiveRecursive(cameraMutex); }
+};
+
+static CameraProfileSpec profileSpec(CameraProfile p) {
+  if (p == PROFILE_CAPTURE) return captureSpec;
+  CameraProfileSpec s;
+  s.size = preEventKB > 0 ? MOTION_RING_FRAME_SIZE : MOTION_FRAME_SIZE;
+  if (s.size > captureSpec.size) s.size = captureSpec.size;   // never above the buffer size
+  s.quality = MOTION_JPEG_QUALITY;
+  return s;
+}
+
+// cameraMutex held. True if the sensor was reconfigured.
+static bool applyProfileLocked(CameraProfile p, bool& resized) {
+  CameraProfileSpec want = profileSpec(p);
+  resized = false;
+  if (want.size == sensorSpec.size && want.quality == sensorSpec.quality) return false;
+  sensor_t* s = esp_camera_sensor_get();
+  if (!s) return false;
+  resized = want.size != sensorSpec.size;
+  if (resized) s->set_framesize(s, want.size);
+  if (want.quality != sensorSpec.quality) s->set_quality(s, want.quality);
+  sensorSpec = want;
+  camStats.switches++;
+  return true;
+}
+
+// esp_camera_fb_get() at the given profile, timed
+camera_fb_t* grabFrame(CameraProfile profile) {
+  if (!cameraMutex) return esp_camera_fb_get();
+  CameraLock lock;
+
+  unsigned long t0 = micros();
+  bool resized;
+  bool switched = applyProfileLocked(profile, resized);
+  camera_fb_t* fb = esp_camera_fb_get();
+  if (resized) {
+    // Frames queued before the switch still have the old size
+    size_t w = resolution[sensorSpec.size].width;
+    for (int i = 0; fb && fb->width != w && i < PROFILE_FLUSH_MAX; i++) {
+      esp_camera_fb_return(fb);
+      camStats.flushed++;
+      fb = esp_camera_fb_get();
+    }
+  }
+  uint32_t dt = micros() - t0;
+  if (switched) {
+    camStats.lastSwitchUs = dt;
+    camStats.totalSwitchUs += dt;
+    if (dt > camStats.maxSwitchUs) camStats.maxSwitchUs = dt;
+    metricObserve(MET_PROFILE_SWITCH, dt);
+  } else {
+    metricObserve(MET_CAMERA_GRAB, dt);
+  }
+  camStats.grabs[profile]++;
+  if (fb) camStats.lastLen[profile] = fb->len;
+  return fb;
+}
+
+void fillCameraStats(JsonObject o) {
+  CameraProfileSpec m = profileSpec(PROFILE_MOTION);
+  o["motionWidth"] = resolution[m.size].width;
+  o["motionQuality"] = m.quality;
+  o["captureWidth"] = resolution[captureSpec.size].width;
+  o["captureQuality"] = captureSpec.quality;
+  o["sensorWidth"] = resolution[sensorSpec.size].width;
+  o["switches"] = camStats.switches;
+  o["flushedFrames"] = camStats.flushed;
+  o["lastSwitchUs"] = camStats.lastSwitchUs;
+  o["maxSwitchUs"] = camStats.maxSwitchUs;
+  o["avgSwitchUs"] = camStats.switches ? (uint32_t)(camStats.totalSwitchUs / camStats.switches) : 0;
+  o["motionGrabs"] = camStats.grabs[PROFILE_MOTION];
+  o["captureGrabs"] = camStats.grabs[PROFILE_CAPTURE];
+  o["motionFrameBytes"] = camStats.lastLen[PROFILE_MOTION];
+  o["captureFrameBytes"] = camStats.lastLen[PROFILE_CAPTURE];
+}
+
+void cameraStatsLine(FixedText& out) {
+  CameraProfileSpec m = profileSpec(PROFILE_MOTION);
+  out.addf("camera: motion %upx q%d (%lu KB), capture %upx (%lu KB), %lu switches, %lu ms avg, %lu flushed",
+           (unsigned)resolution[m.size].width, (int)m.quality,
+           (unsigned long)(camStats.lastLen[PROFILE_MOTION] / 1024), (unsigned)resolution[captureSpec.size].width,
+           (unsigned long)(camStats.lastLen[PROFILE_CAPTURE] / 1024), (unsigned long)camStats.switches,
+           camStats.switches ? (unsigned long)(camStats.totalSwitchUs / camStats.switches / 1000) : 0UL,
+           (unsigned long)camStats.flushed);
+}
+
+#endif
@@ -9,6 +9,12 @@ const char* PASSWORD = "YOUR_WIFI_PASSWORD_HERE";
 // ========== TELEGRAM CONFIGURATION ==========
 const char* TELEGRAM_BOT_TOKEN = "YOUR_BOT_TOKEN_HERE";
 const char* TELEGRAM_CHANNEL = "@YOUR_CHANNEL_HERE";
+// More chats for the same photos (ops channel, on-call person, archive
+// group). TELEGRAM_CHANNEL gets the upload, these get it by file_id:
+// #define TELEGRAM_FANOUT_CHATS "-1001234567890,123456789,@archive_group"
+// Bench testing against a local mock Bot API server (TLS, any cert):
+// #define TELEGRAM_HOST "192.168.1.50"
+// #define TELEGRAM_PORT 8443
 
 // ========== CAMERA PINS ==========
 #define PWDN_GPIO_NUM     32
@@ -0,0 +1,160 @@
+#ifndef DEDUP_H
+#define DEDUP_H
+
+#include <math.h>
+
+// ------------ Perceptual-hash dedup for scheduled captures ------------
+// Time-based and /schedule captures get a 64-bit perceptual hash: the JPEG's
+// DC luma is averaged into a 32x32 grid (the motion engine's decoder, no
+// IDCT), a 2-D DCT keeps the 8x8 lowest frequencies and each bit says
+// whether a coefficient is above their median. Lighting drift and JPEG noise
+// move few bits; a person or a parked car moves many. When the Hamming
+// distance to the last uploaded scheduled frame is at most `dedupDistance`
+// the photo is dropped, or replaced by a one-line text heartbeat when
+// `dedupHeartbeat` is set. 0 turns it off. Manual, motion and burst
+// captures are never deduplicated and do not move the reference.
+//
+// Only called from loop() (schedulerTick), so the decoder needs no lock.
+
+#define PHASH_GRID 32            // luma grid fed to the DCT
+#define PHASH_SIDE 8             // low frequencies kept per axis: 64 bits
+
+struct PHash {
+  bool valid = false;
+  uint64_t bits = 0;
+  int distance = -1;             // to the reference, -1 = nothing to compare
+};
+
+struct DedupStats {
+  uint32_t hashed = 0;
+  uint32_t suppressed = 0;
+  uint32_t heartbeats = 0;
+  uint32_t undecodable = 0;
+  uint64_t bytesSaved = 0;
+  int lastDistance = -1;
+  unsigned long lastHashUs = 0;
+};
+
+static JpegLumaDecoder dedupDecoder;
+static LumaGrid dedupGrid;
+static float phashCos[PHASH_SIDE][PHASH_GRID];   // DCT-II basis, built once
+static bool phashCosReady = false;
+static uint64_t dedupRefBits = 0;
+static bool dedupHaveRef = false;
+static DedupStats dedupStats;
+
+// 64-bit DCT hash of a PHASH_GRID x PHASH_GRID luma grid
+static uint64_t phashFromGrid(const LumaGrid& g) {
+  if (!phashCosReady) {
+    for (int u = 0; u < PHASH_SIDE; u++)
+      for (int x = 0; x < PHASH_GRID; x++)
+        phashCos[u][x] = cosf((2 * x + 1) * u * (float)M_PI / (2 * PHASH_GRID));
+    phashCosReady = true;
+  }
+
+  // Separable DCT, only the low PHASH_SIDE frequencies on each axis
+  float rows[PHASH_GRID][PHASH_SIDE];
+  for (int y = 0; y < PHASH_GRID; y++) {
+    const uint8_t* px = g.px + y * PHASH_GRID;
+    for (int u = 0; u < PHASH_SIDE; u++) {
+      float s = 0;
+      for (int x = 0; x < PHASH_GRID; x++) s += px[x] * phashCos[u][x];
+      rows[y][u] = s;
+    }
+  }
+  float coef[PHASH_SIDE * PHASH_SIDE];
+  for (int v = 0; v < PHASH_SIDE; v++) {
+    for (int u = 0; u < PHASH_SIDE; u++) {
+      float s = 0;
+      for (int y = 0; y < PHASH_GRID; y++) s += rows[y][u] * phashCos[v][y];
+      coef[v * PHASH_SIDE + u] = s;
+    }
+  }
+
+  // Median of the AC terms; the DC term (overall brightness) is left out
+  const int n = PHASH_SIDE * PHASH_SIDE - 1;
+  float ac[n];
+  for (int i = 0; i < n; i++) {          // insertion sort, 63 values
+    float v = coef[i + 1];
+    int j = i;
+    for (; j > 0 && ac[j - 1] > v; j--) ac[j] = ac[j - 1];
+    ac[j] = v;
+  }
+  float median = ac[n / 2];
+
+  uint64_t bits = 0;
+  for (int i = 1; i < PHASH_SIDE * PHASH_SIDE; i++) {
+    if (coef[i] > median) bits |= 1ULL << i;
+  }
+  return bits;
+}
+
+// Hashes the frame and decides. True = drop it; `h` is kept for dedupRemember().
+bool dedupSuppress(const uint8_t* jpg, size_t len, PHash& h) {
+  h = PHash();
+  if (dedupDistance <= 0) return false;
+
+  unsigned long t0 = micros();
+  if (!dedupDecoder.decode(jpg, len, PHASH_GRID, PHASH_GRID, dedupGrid)) {
+    dedupStats.undecodable++;
+    return false;
+  }
+  h.valid = true;
+  h.bits = phashFromGrid(dedupGrid);
+  dedupStats.hashed++;
+  dedupStats.lastHashUs = micros() - t0;
+
+  if (!dedupHaveRef) return false;
+  h.distance = __builtin_popcountll(h.bits ^ dedupRefBits);
+  dedupStats.lastDistance = h.distance;
+  if (h.distance > dedupDistance) return false;
+
+  dedupStats.suppressed++;
+  dedupStats.bytesSaved += len;
+  logEvent(EV_DEDUP_SKIP, h.distance, (int32_t)len);
+  return true;
+}
+
+// The frame was queued for upload: it is the new reference
+void dedupRemember(const PHash& h) {
+  if (!h.valid) return;
+  dedupRefBits = h.bits;
+  dedupHaveRef = true;
+}
+
+// A suppressed capture: text heartbeat or nothing
+void dedupReport(const String& type, size_t len, const PHash& h) {
+  Serial.printf("Dedup: %s unchanged (distance %d), %u bytes not sent\n", type.c_str(), h.distance,
+                (unsigned)len);
+  if (!dedupHeartbeat) return;
+  dedupStats.heartbeats++;
+  InlineText<192> msg;
+  msg.addf("💤 ESP32-CAM: %s | %s\nScene unchanged (distance %d/64), photo not sent. %lu skipped, %lu KB saved",
+           type.c_str(), timeText().c_str(), h.distance, (unsigned long)dedupStats.suppressed,
+           (unsigned long)(dedupStats.bytesSaved / 1024));
+  sendTelegramMessage(msg.c_str());
+}
+
+void fillDedupStatus(JsonObject o) {
+  o["distance"] = dedupDistance;
+  o["heartbeat"] = dedupHeartbeat;
+  o["hashed"] = dedupStats.hashed;
+  o["suppressed"] = dedupStats.suppressed;
+  o["bytesSaved"] = dedupStats.bytesSaved;
+  o["heartbeats"] = dedupStats.heartbeats;
+  o["undecodable"] = dedupStats.undecodable;
+  o["lastDistance"] = dedupStats.lastDistance;
+  o["lastHashUs"] = dedupStats.lastHashUs;
+}
+
+void dedupSettingsLine(FixedText& out) {
+  if (dedupDistance <= 0) {
+    out.add("Dedup: off");
+    return;
+  }
+  out.addf("Dedup: distance <= %d/64, %s, %lu skipped, %lu KB saved", dedupDistance,
+           dedupHeartbeat ? "heartbeat" : "silent", (unsigned long)dedupStats.suppressed,
+           (unsigned long)(dedupStats.bytesSaved / 1024));
+}
+
+#endif
@@ -10,6 +10,31 @@
 #include <EEPROM.h>
 #include <SPIFFS.h>
 
+#include "fixed_text.h"
+#include "motion_engine.h"
+#include "telegram_update_parser.h"
+
+#ifndef MOTION_CHECK_MS
+#define MOTION_CHECK_MS 250        // was 500 with full-size motion frames
+#endif
+#ifndef DEDUP_DEFAULT_DISTANCE
+#define DEDUP_DEFAULT_DISTANCE 0   // scheduled-capture pHash dedup off (dedup.h)
+#endif
+#define DEDUP_MAX_DISTANCE 32
+#ifndef PREBUFFER_DEFAULT_KB
+#define PREBUFFER_DEFAULT_KB 768   // pre-event ring budget (prebuffer.h)
+#endif
+
+// Wall-clock capture rules (scheduler.h); start == end means all day
+#define SCHED_MAX_RULES 4
+enum SchedPolicy : uint8_t { SCHED_SKIP, SCHED_CATCH_UP };
+struct ScheduleRule {
+  uint16_t periodMin;
+  uint16_t startMin;      // minute of day, local time
+  uint16_t endMin;        // exclusive
+  uint8_t policy;         // SchedPolicy
+};
+
 // Globals
 extern WebServer server;
 
@@ -17,16 +42,48 @@ extern int captureMode;
 extern int timeInterval;
 extern bool motionEnabled;
 extern int motionThreshold;
+extern int preEventKB;
+extern int preEventFrames;
+extern int postEventFrames;
+extern ScheduleRule scheduleRules[SCHED_MAX_RULES];
+extern int scheduleRuleCount;
+extern int dedupDistance;
+extern bool dedupHeartbeat;
 
 extern int capturedCount;
 extern int sentCount;
 
-extern String lastCaptureTime;
-extern String lastTelegramResult;
-extern String lastCaptureType;
-extern String telegramDebug;
+// Fixed-size status text: reassigning it never touches the heap
+typedef InlineText<48> StatusText;
+typedef InlineText<128> DebugText;
+extern StatusText lastCaptureTime;
+extern StatusText lastTelegramResult;
+extern StatusText lastCaptureType;
+extern DebugText telegramDebug;
 
-extern uint8_t* previousFrame;
+// Guards the status text/counters shared between loop() and the upload task
+extern SemaphoreHandle_t statusMutex;
+struct StatusLock {
+  StatusLock() { if (statusMutex) xSemaphoreTakeRecursive(statusMutex, portMAX_DELAY); }
+  ~StatusLock() { if (statusMutex) xSemaphoreGiveRecursive(statusMutex); }
+};
+
+// Guards the capture settings (mode, interval, threshold, ring, dedup):
+// loop() holds it while it reads them, /save-settings in the web task and
+// the Telegram setters while they change them
+extern SemaphoreHandle_t settingsMutex;
+struct SettingsLock {
+  SettingsLock() { if (settingsMutex) xSemaphoreTake(settingsMutex, portMAX_DELAY); }
+  ~SettingsLock() { if (settingsMutex) xSemaphoreGive(settingsMutex); }
+};
+
+extern MotionEngine motionEngine;
+extern MotionResult lastMotion;
+extern unsigned long lastMotionCostUs;
+extern unsigned long lastMotionCheckMs;
+extern unsigned long motionGapMs;
+extern unsigned long motionMaxGapMs;
+extern bool motionFromStream;
 extern size_t previousFrameSize;
 extern unsigned long lastMotionTime;
 extern unsigned long lastCaptureMillis;
@@ -39,21 +96,99 @@ void connectToWiFi();
 void setupServerRoutes();
 
 bool detectMotion();
-void captureImage(String type);
+bool captureImage(String type, bool dedup = false);
+void captureMotionEvent();
 
-bool sendTelegramMessage(String message);
+bool sendTelegramMessage(const char* text);
+bool sendTelegramMessage(const String& message);
+void sendParkedReplies();
 bool sendPhotoToTelegram(camera_fb_t *fb, String caption);
+bool sendPhotoBuffer(const uint8_t* buf, size_t len, const char* caption);
+bool sendAlbumBuffers(const uint8_t* const* bufs, const size_t* lens, int n, const char* caption);
+int uploadFailStatus();
+bool uploadFailureRetryable();
+void setTelegramDebug(const char* s);
+void setTelegramDebugf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+void markStatusChanged();
+void onUploadFinished(bool ok, bool countSent = true);
+
+void startTelegramTransport();
+void startTelegramFanout();
+void startUploadPipeline();
+bool enqueueUpload(const uint8_t* buf, size_t len, const char* caption);
+void fillUploadQueueStatus(JsonObject q);
+int uploadQueueDepth();
+bool enqueueAlbum(int event, const char* caption);
+bool enqueueBurst(int burst, size_t bytes, const char* caption);
+bool sendBurst(int burst);
+void storeBurstInOutbox(int burst);
+void releaseBurst(int burst);
+void startBurst();
+bool captureBurst(int n, unsigned long intervalMs, bool single, FixedText& result);
+void startPrebuffer();
+void applyPrebufferSettings();
+void clampPrebufferSettings();
+void prebufferPush(const uint8_t* buf, size_t len);
+bool prebufferTrigger(const char* caption);
+void prebufferTick();
+void releasePreEvent(int event);
+bool sendPreEventAlbum(int event);
+void storePreEventInOutbox(int event);
+void loadOutbox();
+bool outboxStore(const uint8_t* buf, size_t len, const char* caption, uint8_t part = 0, uint8_t parts = 1);
+bool outboxDrainOne();
+void outboxKick();
+void outboxRefused();
+int outboxMetricsText(char* buf, size_t size);
+#ifndef WEB_SERVER_TASK
+#define WEB_SERVER_TASK 1     // 0 = handleClient() from loop() (old behaviour)
+#endif
+void startWebServer();
+void serviceWebServer();
+void startLiveEvents();
+void liveEventsTick();
+void startMjpegStream();
+void handleMjpegStream();
+int acquireStreamFrame(unsigned long maxAgeMs, const uint8_t** buf, size_t* len);
+void releaseStreamFrame(int slot);
+enum EventId : uint8_t {
+  EV_BOOT, EV_WIFI_CONNECTED, EV_WIFI_FAILED, EV_TIME_SYNC, EV_CAMERA_INIT_FAIL,
+  EV_CAPTURE, EV_CAPTURE_FAIL, EV_QUEUE_DROP, EV_MOTION, EV_UPLOAD_OK, EV_UPLOAD_FAIL,
+  EV_OUTBOX_STORE, EV_OUTBOX_SENT, EV_TLS_CONNECT, EV_TLS_FAIL, EV_POLL_ERROR, EV_COMMAND,
+  EV_SCHED_MISSED, EV_DEDUP_SKIP, EV_BURST, EV_STORE_COMPACT, EV_REBOOT, EV_FANOUT, EV_OUTBOX_DROP,
+  EV_COUNT
+};
+void startEventLog(int resetCode);
+void logEvent(EventId id, int32_t a = 0, int32_t b = 0);
+void handleLog();
+void eventLogText(FixedText& out, int n);
+enum CameraProfile : uint8_t { PROFILE_MOTION, PROFILE_CAPTURE };
+void startCameraProfiles(framesize_t size, int quality);
+camera_fb_t* grabFrame(CameraProfile profile);
+void handleMetrics();
+void metricsSummary(FixedText& out);
 bool sendPhotoToTelegramAlternative(camera_fb_t *fb, String caption);
 
-void testTelegramConnection();
+bool testTelegramConnection();
 
-String getTimeString();
-String getUptimeString();
+InlineText<12> timeText();
+InlineText<24> uptimeText();
 
+void startTelegramPolling();
 void checkTelegramCommands();
-void handleTelegramCommand(String command);
-String parseTelegramCommand(String message);
+void handleTelegramCommand(const char* text);
+void fillCommandStats(JsonObject o);
+void commandStatsLine(FixedText& out);
+void waitTelegramCommand(unsigned long ms);
+
+void schedulerTick();
+unsigned long schedMsUntilNext();
+size_t parseTelegramCommand(char* text);
+void loadUpdateOffset();
 long getLastUpdateID();
-void saveLastUpdateID(long update_id);
+bool saveLastUpdateID(long update_id, bool durable = true);
+bool flushUpdateOffset(bool force);
+void settingsStoreTick();
+void heapWatchTick();
 
 #endif
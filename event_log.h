@@ -0,0 +1,166 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+// ------------ Binary event log ------------
+// logEvent() stores a 16-byte record (boot number, uptime ms, event id, two
+// integer args) in a fixed ring: a spinlock, a millis() read and a few
+// stores, no formatting and no heap, so it is cheap enough for the upload
+// task and the hot paths. Text is only produced when someone reads the ring:
+// GET /log?n=N or Telegram /log N.
+//
+// The ring lives in RTC slow memory that is not cleared on reset
+// (RTC_NOINIT_ATTR), so the events that led up to ESP.restart(), a watchdog
+// or a panic are still there after the reboot; a power cycle starts a fresh
+// ring. Serial output is unchanged.
+
+#ifndef EVENT_LOG_SIZE
+#define EVENT_LOG_SIZE 128               // records, 16 bytes each (2 KB of RTC RAM)
+#endif
+#define EVENT_LOG_MAGIC 0xE7E10601UL
+#define EVENT_LOG_TELEGRAM_MAX 40        // lines per /log message
+
+struct EventRecord {
+  uint16_t boot;
+  uint8_t id;                            // EventId
+  uint8_t reserved;
+  uint32_t ms;                           // millis() at the event
+  int32_t a;
+  int32_t b;
+};
+
+struct EventRing {
+  uint32_t magic;
+  uint32_t head;                         // next slot
+  uint32_t count;
+  uint32_t total;                        // ever logged (survives resets)
+  uint16_t boot;
+  EventRecord rec[EVENT_LOG_SIZE];
+};
+
+// Names and argument formats, indexed by EventId (definitions.h)
+static const char* const eventFormats[EV_COUNT] = {
+  "boot reset=%ld (#%ld)",
+  "wifi connected rssi=%ld dBm",
+  "wifi failed status=%ld",
+  "time synced epoch=%ld",
+  "camera init failed err=0x%lx",
+  "capture %ld bytes, queue %ld",
+  "capture failed (no frame)",
+  "upload queue full, dropped %ld",
+  "motion %ld cells, peak %ld",
+  "upload ok %ld bytes in %ld ms",
+  "upload failed http=%ld after %ld ms",
+  "outbox stored %ld bytes, %ld pending",
+  "outbox sent %ld bytes, %ld pending",
+  "tls connect %ld ms",
+  "tls connect failed",
+  "getUpdates error http=%ld",
+  "command '%.4s' len %ld",
+  "schedule job %ld missed by %ld ms",
+  "dedup skipped distance %ld, %ld bytes",
+  "burst %ld frames, %ld.%ld fps",
+  "settings store compacted to %ld bytes",
+  "reboot requested",
+  "fanout to %ld chats, saved %ld bytes",
+  "outbox gave up http=%ld after %ld attempt(s)",
+};
+
+RTC_NOINIT_ATTR static EventRing eventRing;
+static portMUX_TYPE eventMux = portMUX_INITIALIZER_UNLOCKED;
+
+// setup(), first thing: keep the ring across a reset, start a new one after power-on
+void startEventLog(int resetCode) {
+  if (eventRing.magic != EVENT_LOG_MAGIC || eventRing.head >= EVENT_LOG_SIZE ||
+      eventRing.count > EVENT_LOG_SIZE || resetCode == ESP_RST_POWERON) {
+    memset(&eventRing, 0, sizeof(eventRing));
+    eventRing.magic = EVENT_LOG_MAGIC;
+  }
+  eventRing.boot++;
+  logEvent(EV_BOOT, resetCode, eventRing.boot);
+}
+
+void logEvent(EventId id, int32_t a, int32_t b) {
+  uint32_t ms = millis();
+  portENTER_CRITICAL(&eventMux);
+  EventRecord& r = eventRing.rec[eventRing.head];
+  r.boot = eventRing.boot;
+  r.id = (uint8_t)id;
+  r.ms = ms;
+  r.a = a;
+  r.b = b;
+  eventRing.head = (eventRing.head + 1) % EVENT_LOG_SIZE;
+  if (eventRing.count < EVENT_LOG_SIZE) eventRing.count++;
+  eventRing.total++;
+  portEXIT_CRITICAL(&eventMux);
+}
+
+// Copies the newest `n` records (oldest first) into `out`; returns how many
+static int eventLogSnapshot(EventRecord* out, int n) {
+  portENTER_CRITICAL(&eventMux);
+  if (n > (int)eventRing.count) n = (int)eventRing.count;
+  uint32_t start = (eventRing.head + EVENT_LOG_SIZE - n) % EVENT_LOG_SIZE;
+  for (int i = 0; i < n; i++) out[i] = eventRing.rec[(start + i) % EVENT_LOG_SIZE];
+  portEXIT_CRITICAL(&eventMux);
+  return n;
+}
+
+// "b3 +123.456s  upload ok 48211 bytes in 812 ms"
+static int formatEvent(char* buf, size_t size, const EventRecord& r) {
+  int n = snprintf(buf, size, "b%u +%lu.%03lus  ", (unsigned)r.boot, (unsigned long)(r.ms / 1000),
+                   (unsigned long)(r.ms % 1000));
+  if (n < 0 || (size_t)n >= size) return n;
+  const char* fmt = r.id < EV_COUNT ? eventFormats[r.id] : "event %ld %ld";
+  int m;
+  if (r.id == EV_COMMAND) {
+    char text[5];
+    memcpy(text, &r.a, 4);
+    text[4] = 0;
+    m = snprintf(buf + n, size - n, fmt, text, (long)r.b);
+  } else if (r.id == EV_BURST) {
+    m = snprintf(buf + n, size - n, fmt, (long)r.a, (long)(r.b / 10), (long)(r.b % 10));
+  } else {
+    m = snprintf(buf + n, size - n, fmt, (long)r.a, (long)r.b);
+  }
+  return m < 0 ? n : n + m;
+}
+
+// GET /log?n=N (default: the whole ring), plain text, oldest first
+void handleLog() {
+  int n = server.hasArg("n") ? server.arg("n").toInt() : EVENT_LOG_SIZE;
+  if (n < 1) n = 1;
+  if (n > EVENT_LOG_SIZE) n = EVENT_LOG_SIZE;
+  static EventRecord snap[EVENT_LOG_SIZE];   // web handlers run one at a time
+  n = eventLogSnapshot(snap, n);
+
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/plain", "");
+  char line[96];
+  int len = snprintf(line, sizeof(line), "# %d of %lu events, boot %u, uptime %lu s\n", n,
+                     (unsigned long)eventRing.total, (unsigned)eventRing.boot, millis() / 1000UL);
+  server.sendContent(line, len);
+  for (int i = 0; i < n; i++) {
+    len = formatEvent(line, sizeof(line) - 1, snap[i]);
+    if (len < 0) continue;
+    if (len > (int)sizeof(line) - 2) len = sizeof(line) - 2;
+    line[len++] = '\n';
+    server.sendContent(line, len);
+  }
+  server.sendContent("");
+}
+
+// Telegram /log N
+void eventLogText(FixedText& out, int n) {
+  if (n < 1) n = 1;
+  if (n > EVENT_LOG_TELEGRAM_MAX) n = EVENT_LOG_TELEGRAM_MAX;
+  EventRecord snap[EVENT_LOG_TELEGRAM_MAX];
+  n = eventLogSnapshot(snap, n);
+
+  out.addf("📜 Last %d events (boot %u):\n", n, (unsigned)eventRing.boot);
+  char line[96];
+  for (int i = 0; i < n; i++) {
+    if (formatEvent(line, sizeof(line), snap[i]) < 0) continue;
+    out.add(line).add("\n");
+  }
+}
+
+#endif
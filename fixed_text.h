@@ -0,0 +1,148 @@
+#ifndef FIXED_TEXT_H
+#define FIXED_TEXT_H
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// ------------ Fixed-capacity text ------------
+// Request framing, status fields and Telegram replies are formatted into
+// fixed arrays instead of chained String + operations. Nothing here touches
+// the heap, so weeks of status updates and replies do not slowly cut it into
+// small holes. FixedText appends into caller memory (usually a stack array);
+// InlineText<N> carries its own N bytes and is what the long-lived status
+// globals use. Text that does not fit is cut at a character boundary and
+// ok() turns false.
+
+// Appends into a fixed array; on overflow it stops and ok() turns false
+class FixedText {
+ public:
+  FixedText(char* mem, size_t cap) : buf(mem), cap(cap) { buf[0] = 0; }
+
+  FixedText& add(const char* s) { return add(s, strlen(s)); }
+
+  FixedText& add(const char* s, size_t n) {
+    if (len + n >= cap) {
+      overflow = true;
+      n = cap - 1 - len;
+    }
+    memcpy(buf + len, s, n);
+    len += n;
+    buf[len] = 0;
+    if (overflow) dropPartialChar();
+    return *this;
+  }
+
+  FixedText& addNum(unsigned long v) {
+    char tmp[12];
+    int n = snprintf(tmp, sizeof(tmp), "%lu", v);
+    return add(tmp, (size_t)n);
+  }
+
+  // printf-style, straight into the free space
+  __attribute__((format(printf, 2, 3))) FixedText& addf(const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    addv(fmt, ap);
+    va_end(ap);
+    return *this;
+  }
+
+  FixedText& addv(const char* fmt, va_list ap) {
+    size_t room = cap - len;
+    int n = vsnprintf(buf + len, room, fmt, ap);
+    if (n < 0) {
+      buf[len] = 0;
+      overflow = true;
+    } else if ((size_t)n >= room) {
+      len = cap - 1;
+      overflow = true;
+      dropPartialChar();
+    } else {
+      len += n;
+    }
+    return *this;
+  }
+
+  // JSON string contents (quotes, backslashes and control chars escaped)
+  FixedText& addJson(const char* s) {
+    for (; *s; s++) {
+      unsigned char c = (unsigned char)*s;
+      if (c == '"' || c == '\\') {
+        char e[2] = { '\\', (char)c };
+        add(e, 2);
+      } else if (c < 0x20) {
+        char e[8];
+        int n = snprintf(e, sizeof(e), "\\u%04x", c);
+        add(e, (size_t)n);
+      } else {
+        add((const char*)&c, 1);
+      }
+    }
+    return *this;
+  }
+
+  FixedText& set(const char* s) {
+    if (s == buf) return *this;
+    clear();
+    return add(s);
+  }
+
+  void clear() {
+    len = 0;
+    overflow = false;
+    buf[0] = 0;
+  }
+
+  const char* c_str() const { return buf; }
+  size_t length() const { return len; }
+  bool ok() const { return !overflow; }
+
+ private:
+  // A cut must not leave half a UTF-8 sequence (Telegram rejects the message)
+  void dropPartialChar() {
+    size_t i = len;
+    while (i > 0 && ((uint8_t)buf[i - 1] & 0xC0) == 0x80) i--;
+    if (i == 0) return;
+    uint8_t lead = (uint8_t)buf[i - 1];
+    size_t need = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+    if (len - (i - 1) < need) {
+      len = i - 1;
+      buf[len] = 0;
+    }
+  }
+
+  char* buf;
+  size_t cap;
+  size_t len = 0;
+  bool overflow = false;
+};
+
+// FixedText with its own storage; copies copy the text, not the pointer
+template <size_t N>
+class InlineText : public FixedText {
+ public:
+  InlineText() : FixedText(mem, N) {}
+  InlineText(const char* s) : FixedText(mem, N) { add(s); }
+  InlineText(const InlineText& o) : FixedText(mem, N) { add(o.c_str(), o.length()); }
+
+  InlineText& operator=(const InlineText& o) {
+    set(o.c_str());
+    return *this;
+  }
+
+  InlineText& operator=(const FixedText& t) {
+    set(t.c_str());
+    return *this;
+  }
+
+  InlineText& operator=(const char* s) {
+    set(s);
+    return *this;
+  }
+
+ private:
+  char mem[N];
+};
+
+#endif
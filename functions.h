@@ -3,7 +3,7 @@
 
 #include "esp_system.h"   // ✅ for esp_reset_reason()
 
-// ------------ Persisted struct (EEPROM) ------------
+// ------------ Persisted struct (legacy EEPROM layout, read once to migrate) ------------
 static const uint8_t PERSIST_MAGIC = 0xA7;
 
 struct Persisted {
@@ -14,14 +14,22 @@ struct Persisted {
   uint16_t threshold;      // 1000..20000
   uint32_t captured;
   uint32_t sent;
-  uint32_t reserved;       // future
+  uint16_t preKB;          // pre-event ring, 0..PREBUFFER_MAX_KB
+  uint8_t preFrames;       // bit7 = set (older builds wrote 0 here)
+  uint8_t postFrames;
+  uint8_t schedMagic;      // SCHED_PERSIST_MAGIC once rules were saved
+  uint8_t schedCount;
+  ScheduleRule sched[SCHED_MAX_RULES];
+  uint8_t dedup;           // bit7 = set, bit6 = heartbeat, bits0-5 = distance
 };
+#define SCHED_PERSIST_MAGIC 0x5C
+static_assert(sizeof(Persisted) <= EEPROM_SIZE, "Persisted does not fit EEPROM_SIZE");
 
 // Forward from main for throttling
 extern void (*__dummy_throttling_hook)(); // not used, just to avoid warnings
 
 // ------------ Utils ------------
-static String resetReasonString() {
+static const char* resetReasonString() {
   esp_reset_reason_t r = esp_reset_reason();
   switch (r) {
     case ESP_RST_UNKNOWN:    return "UNKNOWN";
@@ -39,6 +47,27 @@ static String resetReasonString() {
   }
 }
 
+// telegramDebug / lastTelegramResult are written from loop() and the upload task
+void setTelegramDebug(const char* s) {
+  {
+    StatusLock lock;
+    telegramDebug = s;
+  }
+  markStatusChanged();
+}
+
+void setTelegramDebugf(const char* fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  {
+    StatusLock lock;
+    telegramDebug.clear();
+    telegramDebug.addv(fmt, ap);
+  }
+  va_end(ap);
+  markStatusChanged();
+}
+
 static int resetReasonCode() {
   return (int)esp_reset_reason();
 }
@@ -52,7 +81,7 @@ static void printMemStats(const char* tag) {
 #endif
   Serial.printf("[%s] freeHeap=%u  minHeap=%u  freePSRAM=%u  reset=%s(%d)\n",
                 tag, freeHeap, minHeap, freePs,
-                resetReasonString().c_str(), resetReasonCode());
+                resetReasonString(), resetReasonCode());
 }
 
 // ------------ Camera ------------
@@ -93,30 +122,82 @@ bool initializeCamera() {
   esp_err_t err = esp_camera_init(&config);
   if (err != ESP_OK) {
     Serial.printf("esp_camera_init failed: 0x%x\n", (int)err);
+    logEvent(EV_CAMERA_INIT_FAIL, (int32_t)err);
     return false;
   }
 
+  startCameraProfiles(config.frame_size, config.jpeg_quality);
   Serial.println("Camera initialized");
   printMemStats("cam_init");
   return true;
 }
 
-// ------------ Settings (EEPROM) ------------
-void loadSettings() {
-  Persisted p;
-  EEPROM.get(0, p);
+// ------------ Settings (settings_store.h, legacy EEPROM) ------------
+static void loadDefaultSettings() {
+  captureMode = 0;
+  timeInterval = 5;
+  motionEnabled = true;
+  motionThreshold = 5000;
+  preEventKB = PREBUFFER_DEFAULT_KB;
+  preEventFrames = 3;
+  postEventFrames = 2;
+  capturedCount = 0;
+  sentCount = 0;
+}
 
-  if (p.magic != PERSIST_MAGIC) {
-    // Defaults
-    captureMode = 0;
-    timeInterval = 5;
-    motionEnabled = true;
-    motionThreshold = 5000;
-    capturedCount = 0;
-    sentCount = 0;
-    Serial.println("EEPROM: no valid data, using defaults");
-    return;
+static void collectStoredSettings(StoredSettings& s) {
+  memset(&s, 0, sizeof(s));   // padding is compared by settingsStoreSave()
+  s.mode = (uint8_t)captureMode;
+  s.motionEn = (uint8_t)(motionEnabled ? 1 : 0);
+  s.intervalMin = (uint16_t)timeInterval;
+  s.threshold = (uint16_t)motionThreshold;
+  s.preKB = (uint16_t)preEventKB;
+  s.preFrames = (uint8_t)preEventFrames;
+  s.postFrames = (uint8_t)postEventFrames;
+  s.dedupDistance = (uint8_t)dedupDistance;
+  s.dedupHeartbeat = (uint8_t)(dedupHeartbeat ? 1 : 0);
+  s.schedCount = (uint8_t)scheduleRuleCount;
+  for (int i = 0; i < scheduleRuleCount; i++) s.sched[i] = scheduleRules[i];
+}
+
+static void applyScheduleRules(const ScheduleRule* rules, int count) {
+  scheduleRuleCount = 0;
+  for (int i = 0; i < count && i < SCHED_MAX_RULES; i++) {
+    const ScheduleRule& r = rules[i];
+    if (r.periodMin < 1 || r.periodMin > 1440 || r.startMin >= 1440 || r.endMin >= 1440) continue;
+    scheduleRules[scheduleRuleCount++] = r;
   }
+}
+
+static void applyStoredSettings(const StoredSettings& s) {
+  captureMode = (s.mode <= 2) ? s.mode : 0;
+
+  int ti = (int)s.intervalMin;
+  if (ti < 1 || ti > 1000) ti = 5;
+  timeInterval = ti;
+
+  motionEnabled = (s.motionEn != 0);
+
+  int th = (int)s.threshold;
+  if (th < 1000 || th > 20000) th = 5000;
+  motionThreshold = th;
+
+  preEventKB = s.preKB;
+  preEventFrames = s.preFrames;
+  postEventFrames = s.postFrames;
+  clampPrebufferSettings();
+
+  dedupDistance = s.dedupDistance > DEDUP_MAX_DISTANCE ? DEDUP_MAX_DISTANCE : s.dedupDistance;
+  dedupHeartbeat = s.dedupHeartbeat != 0;
+
+  applyScheduleRules(s.sched, s.schedCount);
+}
+
+// Pre-store firmware kept everything in the EEPROM Persisted struct
+static bool loadLegacySettings() {
+  Persisted p;
+  EEPROM.get(0, p);
+  if (p.magic != PERSIST_MAGIC) return false;
 
   captureMode = (p.mode <= 2) ? p.mode : 0;
 
@@ -133,23 +214,53 @@ void loadSettings() {
   capturedCount = (int)p.captured;
   sentCount = (int)p.sent;
 
-  Serial.println("EEPROM settings loaded");
+  if (p.preFrames & 0x80) {
+    preEventKB = p.preKB;
+    preEventFrames = p.preFrames & 0x7F;
+    postEventFrames = p.postFrames;
+    clampPrebufferSettings();
+  }
+
+  if (p.schedMagic == SCHED_PERSIST_MAGIC && p.schedCount <= SCHED_MAX_RULES) {
+    applyScheduleRules(p.sched, p.schedCount);
+  }
+
+  if (p.dedup & 0x80) {
+    dedupDistance = p.dedup & 0x3F;
+    if (dedupDistance > DEDUP_MAX_DISTANCE) dedupDistance = DEDUP_MAX_DISTANCE;
+    dedupHeartbeat = (p.dedup & 0x40) != 0;
+  }
+  return true;
 }
 
-void saveSettings() {
-  Persisted p;
-  p.magic = PERSIST_MAGIC;
-  p.mode = (uint8_t)captureMode;
-  p.intervalMin = (uint16_t)timeInterval;
-  p.motionEn = (uint8_t)(motionEnabled ? 1 : 0);
-  p.threshold = (uint16_t)motionThreshold;
-  p.captured = (uint32_t)capturedCount;
-  p.sent = (uint32_t)sentCount;
-  p.reserved = 0;
+void loadSettings() {
+  loadDefaultSettings();
+
+  StoredSettings s;
+  uint32_t captured = 0, sent = 0;
+  if (settingsStoreLoad(s, captured, sent)) {
+    applyStoredSettings(s);
+    capturedCount = (int)captured;
+    sentCount = (int)sent;
+    Serial.println("Settings loaded from store");
+    return;
+  }
 
-  EEPROM.put(0, p);
-  EEPROM.commit();
-  Serial.println("EEPROM committed (throttled)");
+  if (!loadLegacySettings()) {
+    Serial.println("Settings: no saved data, using defaults");
+    return;
+  }
+  // The EEPROM copy is left as it is (older firmware can still boot from it)
+  collectStoredSettings(s);
+  settingsStoreMigrate(s, (uint32_t)capturedCount, (uint32_t)sentCount);
+  Serial.println("EEPROM settings migrated to the settings store");
+}
+
+// Throttled by maybePersistStats(); appends only what changed
+void saveSettings() {
+  StoredSettings s;
+  collectStoredSettings(s);
+  settingsStoreSave(s, (uint32_t)capturedCount, (uint32_t)sentCount);
 }
 
 // ------------ WiFi ------------
@@ -170,8 +281,10 @@ void connectToWiFi() {
 
   if (WiFi.status() == WL_CONNECTED) {
     Serial.println("\nWiFi connected! IP: " + WiFi.localIP().toString());
+    logEvent(EV_WIFI_CONNECTED, WiFi.RSSI());
   } else {
     Serial.println("\nWiFi failed!");
+    logEvent(EV_WIFI_FAILED, (int32_t)WiFi.status());
   }
 
   printMemStats("wifi");
@@ -179,12 +292,11 @@ void connectToWiFi() {
 
 // ------------ Web routes ------------
 void setupServerRoutes() {
-  server.on("/", HTTP_GET, []() {
-    server.send(200, "text/html", INDEX_HTML);
-  });
+  collectWebCacheHeaders();
+  webRoute("/", HTTP_GET, handleIndex);
 
-  server.on("/stream", HTTP_GET, []() {
-    camera_fb_t *fb = esp_camera_fb_get();
+  webRoute("/stream", HTTP_GET, []() {
+    camera_fb_t *fb = grabFrame(PROFILE_CAPTURE);
     if (fb) {
       server.send_P(200, "image/jpeg", (const char*)fb->buf, fb->len);
       esp_camera_fb_return(fb);
@@ -193,30 +305,23 @@ void setupServerRoutes() {
     }
   });
 
-  server.on("/status", HTTP_GET, []() {
-    StaticJsonDocument<768> doc;
-    doc["capturedCount"] = capturedCount;
-    doc["sentCount"] = sentCount;
-    doc["lastCaptureTime"] = lastCaptureTime;
-    doc["lastCaptureType"] = lastCaptureType;
-    doc["lastTelegramResult"] = lastTelegramResult;
-    doc["captureMode"] = captureMode;
-    doc["timeInterval"] = timeInterval;
-    doc["motionThreshold"] = motionThreshold;
-    doc["uptime"] = getUptimeString();
-    doc["telegramDebug"] = telegramDebug;
-    doc["currentMode"] = (captureMode == 0) ? "Motion Detection" :
-                         (captureMode == 1) ? "Time Based" : "Mixed Mode";
-
-    String response;
-    serializeJson(doc, response);
-    server.send(200, "application/json", response);
-  });
+  webRoute("/mjpeg", HTTP_GET, handleMjpegStream);
+  webRoute("/metrics", HTTP_GET, handleMetrics);
+  webRoute("/log", HTTP_GET, handleLog);
 
-  server.on("/debug", HTTP_GET, []() {
-    StaticJsonDocument<768> doc;
+  webRoute("/status", HTTP_GET, handleStatus);
+  webRoute("/events", HTTP_GET, handleEvents);
+
+  webRoute("/debug", HTTP_GET, []() {
+    JsonDocument& doc = webJsonDoc;
+    doc.clear();
+    InlineText<24> uptime = uptimeText();
     doc["freeHeap"] = ESP.getFreeHeap();
     doc["minFreeHeap"] = ESP.getMinFreeHeap();
+    doc["maxAllocHeap"] = ESP.getMaxAllocHeap();   // largest free block
+    doc["minMaxAllocHeap"] = heapWatch.minMaxAlloc;
+    doc["heapFragmentationPct"] = heapFragmentationPct();
+    doc["maxHeapFragmentationPct"] = heapWatch.maxFragPct;
     doc["resetReason"] = resetReasonString();
     doc["resetReasonCode"] = resetReasonCode();
 #if defined(BOARD_HAS_PSRAM) || defined(CONFIG_SPIRAM_SUPPORT)
@@ -225,24 +330,43 @@ void setupServerRoutes() {
     doc["freePsram"] = 0;
 #endif
     doc["wifiRSSI"] = (WiFi.status() == WL_CONNECTED) ? WiFi.RSSI() : 0;
-    doc["uptime"] = getUptimeString();
+    doc["uptime"] = uptime.c_str();
+    telegramLink.fillStats(doc.createNestedObject("telegramLink"));
+    fillTelegramPollStats(doc.createNestedObject("telegramPoll"));
+    fillCommandStats(doc.createNestedObject("commands"));
+    fillOffsetJournalStats(doc.createNestedObject("offsetJournal"));
+    fillSettingsStoreStats(doc.createNestedObject("settingsStore"));
+    fillMjpegStats(doc.createNestedObject("mjpeg"));
+    fillWebStats(doc.createNestedObject("web"));
+    fillOutboxStats(doc.createNestedObject("outbox"));
+    fillCameraStats(doc.createNestedObject("camera"));
+    fillBurstStats(doc.createNestedObject("burst"));
+    fillWebCacheStats(doc.createNestedObject("webCache"));
+    fillLiveEventStats(doc.createNestedObject("events"));
+    fillFanoutStats(doc.createNestedObject("fanout"));
+    noteWebJsonDoc();
+    sendJsonDoc(doc, true);
+  });
 
-    String response;
-    serializeJsonPretty(doc, response);
-    server.send(200, "application/json", response);
+  // Long operations run on the job worker; poll /job?id=N for the result
+  webRoute("/capture-now", HTTP_GET, []() {
+    replyJobQueued(enqueueWebJob(JOB_CAPTURE));
   });
 
-  server.on("/capture-now", HTTP_GET, []() {
-    captureImage("Manual");
-    server.send(200, "text/plain", "Capture attempted");
+  webRoute("/test-telegram", HTTP_GET, []() {
+    replyJobQueued(enqueueWebJob(JOB_TELEGRAM_TEST));
   });
 
-  server.on("/test-telegram", HTTP_GET, []() {
-    testTelegramConnection();
-    server.send(200, "text/plain", "Telegram test completed");
+  // /burst?n=5&interval=0&single=1
+  webRoute("/burst", HTTP_GET, []() {
+    int n = server.hasArg("n") ? server.arg("n").toInt() : 5;
+    uint32_t interval = (uint32_t)server.arg("interval").toInt();
+    replyJobQueued(enqueueWebJob(JOB_BURST, (uint32_t)n, interval, server.arg("single").toInt() ? 1 : 0));
   });
 
-  server.on("/save-settings", HTTP_POST, []() {
+  webRoute("/job", HTTP_GET, handleJobStatus);
+
+  webRoute("/save-settings", HTTP_POST, []() {
     String body = server.arg("plain");
     StaticJsonDocument<256> doc;
     DeserializationError err = deserializeJson(doc, body);
@@ -250,16 +374,38 @@ void setupServerRoutes() {
       server.send(400, "text/plain", "Bad JSON");
       return;
     }
-    captureMode = (int)doc["mode"];
-    if (captureMode < 0 || captureMode > 2) captureMode = 0;
-
-    timeInterval = (int)doc["interval"];
-    if (timeInterval < 1) timeInterval = 1;
-    if (timeInterval > 1000) timeInterval = 1000;
-
-    motionThreshold = (int)doc["threshold"];
-    if (motionThreshold < 1000) motionThreshold = 1000;
-    if (motionThreshold > 20000) motionThreshold = 20000;
+    int mode = (int)doc["mode"];
+    if (mode < 0 || mode > 2) mode = 0;
+
+    int interval = (int)doc["interval"];
+    if (interval < 1) interval = 1;
+    if (interval > 1000) interval = 1000;
+
+    int threshold = (int)doc["threshold"];
+    if (threshold < 1000) threshold = 1000;
+    if (threshold > 20000) threshold = 20000;
+
+    int dedup = (int)doc["dedup"];
+    if (dedup < 0) dedup = 0;
+    if (dedup > DEDUP_MAX_DISTANCE) dedup = DEDUP_MAX_DISTANCE;
+
+    // Usually the web task: loop() sees all of the change or none of it
+    {
+      SettingsLock lock;
+      captureMode = mode;
+      timeInterval = interval;
+      motionThreshold = threshold;
+
+      // Pre-event ring (optional fields)
+      if (doc.containsKey("ringKB")) preEventKB = (int)doc["ringKB"];
+      if (doc.containsKey("preFrames")) preEventFrames = (int)doc["preFrames"];
+      if (doc.containsKey("postFrames")) postEventFrames = (int)doc["postFrames"];
+      applyPrebufferSettings();
+
+      // Scheduled-capture dedup (optional fields)
+      if (doc.containsKey("dedup")) dedupDistance = dedup;
+      if (doc.containsKey("dedupHeartbeat")) dedupHeartbeat = (bool)doc["dedupHeartbeat"];
+    }
 
     // Mark dirty (throttled commit)
     extern void markStatsDirty(); // from .ino
@@ -272,219 +418,446 @@ void setupServerRoutes() {
   Serial.println("HTTP server started");
 }
 
-// ------------ Motion detection (safe) ------------
+// ------------ Motion detection (DC luma grid) ------------
+// Slider 1000..20000 -> per-cell luma delta 4..80 (lower = more sensitive)
+static uint8_t motionCellDelta() {
+  int d = motionThreshold / 250;
+  if (d < 4) d = 4;
+  if (d > 80) d = 80;
+  return (uint8_t)d;
+}
+
 bool detectMotion() {
   if (!motionEnabled) return false;
 
-  camera_fb_t *fb = esp_camera_fb_get();
-  if (!fb) return false;
-
-  // First frame init
-  if (previousFrame == nullptr) {
-    previousFrame = (uint8_t*)malloc(fb->len);
-    if (previousFrame) {
-      memcpy(previousFrame, fb->buf, fb->len);
-      previousFrameSize = fb->len;
-    }
-    esp_camera_fb_return(fb);
-    return false;
+  // Check cadence, so the effect of the live stream on motion checks is visible
+  unsigned long now = millis();
+  if (lastMotionCheckMs) {
+    motionGapMs = now - lastMotionCheckMs;
+    if (motionGapMs > motionMaxGapMs) motionMaxGapMs = motionGapMs;
+  }
+  lastMotionCheckMs = now;
+
+  // While someone watches /mjpeg, analyse its newest frame instead of
+  // grabbing another one from the camera
+  const uint8_t* buf = nullptr;
+  size_t len = 0;
+  camera_fb_t *fb = nullptr;
+  int slot = acquireStreamFrame(MOTION_STREAM_MAX_AGE_MS, &buf, &len);
+  motionFromStream = slot >= 0;
+  if (slot < 0) {
+    fb = grabFrame(PROFILE_MOTION);
+    if (!fb) return false;
+    buf = fb->buf;
+    len = fb->len;
+  }
+
+  motionEngine.configure(motionCellDelta(), MOTION_MIN_CHANGED_CELLS);
+
+  unsigned long t0 = micros();
+  MotionResult r;
+  bool decoded = motionEngine.analyze(buf, len, r);
+  lastMotionCostUs = micros() - t0;
+  metricObserve(MET_MOTION, lastMotionCostUs);
+
+  bool motion;
+  if (decoded) {
+    StatusLock lock;
+    lastMotion = r;
+    motion = r.motion;
+  } else {
+    // Not a baseline JPEG: fall back to the old length-diff heuristic
+    long diff = labs((long)len - (long)previousFrameSize);
+    motion = (previousFrameSize > 0) && (diff > motionThreshold);
   }
+  previousFrameSize = len;
+
+  // Keep it for pre-event albums before the camera buffer goes back
+  prebufferPush(buf, len);
 
-  // Heuristic: compare jpeg size changes (simple, fast)
-  long diff = labs((long)fb->len - (long)previousFrameSize);
-  bool motion = (diff > motionThreshold);
+  if (fb) esp_camera_fb_return(fb);
+  else releaseStreamFrame(slot);
 
-  // ensure buffer can hold new size before memcpy
   if (motion) {
-    if (fb->len > previousFrameSize) {
-      uint8_t* p = (uint8_t*)realloc(previousFrame, fb->len);
-      if (!p) {
-        esp_camera_fb_return(fb);
-        return false;
-      }
-      previousFrame = p;
-      previousFrameSize = fb->len;
-    }
-    memcpy(previousFrame, fb->buf, fb->len);
-    previousFrameSize = fb->len;
     lastMotionTime = millis();
+    logEvent(EV_MOTION, r.changedCells, r.peakDelta);
   }
-
-  esp_camera_fb_return(fb);
   return motion;
 }
 
 // ------------ Capture ------------
-void captureImage(String type) {
-  camera_fb_t *fb = esp_camera_fb_get();
+// Grabs a frame, hands a PSRAM copy to the upload queue and returns the
+// camera buffer right away; the upload result lands in onUploadFinished().
+bool captureImage(String type, bool dedup) {
+  camera_fb_t *fb = grabFrame(PROFILE_CAPTURE);
   if (!fb) {
+    logEvent(EV_CAPTURE_FAIL);
+    StatusLock lock;
     lastCaptureTime = "Failed: No frame";
-    lastCaptureType = type;
-    return;
+    lastCaptureType = type.c_str();
+    return false;
   }
 
-  capturedCount++;
-  lastCaptureTime = getTimeString();
-  lastCaptureType = type;
+  // Scheduled captures of an unchanged scene are not uploaded
+  PHash hash;
+  if (dedup && dedupSuppress(fb->buf, fb->len, hash)) {
+    size_t len = fb->len;
+    esp_camera_fb_return(fb);
+    lastCaptureMillis = millis();
+    {
+      StatusLock lock;
+      lastCaptureTime = timeText();
+      lastCaptureType.set(type.c_str()).add(" (unchanged, not sent)");
+    }
+    dedupReport(type, len, hash);
+    return true;
+  }
 
-  Serial.printf("Captured: %u bytes, Type: %s\n", (unsigned)fb->len, type.c_str());
-  telegramDebug = "Captured " + String((unsigned)fb->len) + " bytes";
-
-  bool telegramSuccess = sendPhotoToTelegram(fb, type);
-  if (telegramSuccess) {
-    sentCount++;
-    lastTelegramResult = "Success at " + getTimeString();
-    telegramDebug = "✅ Photo sent successfully!";
-    Serial.println("Photo sent successfully");
-  } else {
-    lastTelegramResult = "Failed at " + getTimeString();
-    telegramDebug = "❌ Failed to send photo";
-    Serial.println("Failed to send photo");
+  InlineText<96> caption;
+  {
+    // Also called from the web job worker, so status updates are locked
+    StatusLock lock;
+    capturedCount++;
+    lastCaptureTime = timeText();
+    lastCaptureType = type.c_str();
+    caption.addf("ESP32-CAM: %s | %s", type.c_str(), lastCaptureTime.c_str());
   }
 
+  Serial.printf("Captured: %u bytes, Type: %s\n", (unsigned)fb->len, type.c_str());
+
+  bool queued = enqueueUpload(fb->buf, fb->len, caption.c_str());
+  size_t len = fb->len;
   esp_camera_fb_return(fb);
   lastCaptureMillis = millis();
 
+  logEvent(EV_CAPTURE, (int32_t)len, queued ? uploadQueueDepth() : -1);
+  if (queued) {
+    dedupRemember(hash);
+    setTelegramDebugf("Captured %u bytes, queued (%d pending)", (unsigned)len, uploadQueueDepth());
+  } else {
+    {
+      StatusLock lock;
+      lastTelegramResult.clear();
+      lastTelegramResult.addf("Failed at %s (queue)", timeText().c_str());
+    }
+    setTelegramDebug("❌ Upload queue full / out of memory");
+    Serial.println("Upload queue rejected capture");
+  }
+
   // Throttle persistence
   extern void markStatsDirty(); // from .ino
   markStatsDirty();
 
   printMemStats("after_capture");
+  return queued;
 }
 
-// ------------ Telegram: text ------------
-bool sendTelegramMessage(String message) {
-  if (WiFi.status() != WL_CONNECTED) return false;
-
-  WiFiClientSecure client;
-  client.setInsecure();
-  client.setTimeout(10000);
+// Motion: an album of the frames around the trigger from the pre-event
+// ring, or a single fresh capture when the ring is off or busy
+void captureMotionEvent() {
+  InlineText<12> when = timeText();
+  InlineText<96> caption;
+  caption.addf("ESP32-CAM: Motion Detection | %s (%d before, %d after)", when.c_str(), preEventFrames,
+               postEventFrames);
+  if (!prebufferTrigger(caption.c_str())) {
+    captureImage("Motion Detection");
+    return;
+  }
 
-  HTTPClient http;
-  String url = "https://api.telegram.org/bot" + String(TELEGRAM_BOT_TOKEN) + "/sendMessage";
+  {
+    StatusLock lock;
+    capturedCount++;
+    lastCaptureTime = when;
+    lastCaptureType = "Motion Detection (album)";
+  }
+  lastCaptureMillis = millis();
+  setTelegramDebugf("Motion event: collecting %d post-event frame(s)", postEventFrames);
 
-  if (!http.begin(client, url)) return false;
+  extern void markStatsDirty(); // from .ino
+  markStatsDirty();
+}
 
-  http.addHeader("Content-Type", "application/json");
+// Called from the upload task once an item has been sent (or given up on).
+// countSent false: a later photo of an album already counted.
+void onUploadFinished(bool ok, bool countSent) {
+  {
+    InlineText<12> when = timeText();
+    StatusLock lock;
+    lastTelegramResult.clear();
+    if (ok) {
+      if (countSent) sentCount++;
+      lastTelegramResult.addf("Success at %s", when.c_str());
+      telegramDebug = "✅ Photo sent successfully!";
+    } else {
+      lastTelegramResult.addf("Failed at %s", when.c_str());
+      telegramDebug = "❌ Failed to send photo";
+    }
+  }
+  Serial.println(ok ? "Photo sent successfully" : "Failed to send photo");
 
-  StaticJsonDocument<512> doc;
-  doc["chat_id"] = String(TELEGRAM_CHANNEL);
-  doc["text"] = message;
+  extern void markStatsDirty(); // from .ino
+  markStatsDirty();
+}
 
-  String payload;
-  serializeJson(doc, payload);
+// ------------ Telegram: text ------------
+// Replies are sent from loop(), and an upload can hold the shared link for
+// up to 90 s. A message waits at most TELEGRAM_REPLY_WAIT_MS for the link;
+// after that it is parked and loop() sends it once the link is free, so
+// motion checks and the scheduler keep running meanwhile. Parked messages
+// go out in order, and a new message queues behind them.
+#ifndef TELEGRAM_REPLY_WAIT_MS
+#define TELEGRAM_REPLY_WAIT_MS 50
+#endif
+#define TELEGRAM_PARKED_BYTES 4096   // parked texts, NUL-terminated, back to back
 
-  int httpCode = http.POST(payload);
-  http.end();
+struct TelegramReplyStats {
+  uint32_t parked = 0;
+  uint32_t dropped = 0;          // no room left to park
+  size_t maxParkedBytes = 0;
+};
 
-  Serial.printf("Text message http=%d\n", httpCode);
-  return httpCode == 200;
+static char parkedReplies[TELEGRAM_PARKED_BYTES];
+static size_t parkedBytes = 0;   // appended by any task, consumed by loop() only
+static portMUX_TYPE parkedMux = portMUX_INITIALIZER_UNLOCKED;
+static TelegramReplyStats replyStats;
+
+// One sendMessage; waits up to `lockWait` ticks for the link.
+// Returns the HTTP status or TELEGRAM_LINK_BUSY.
+static int postMessage(const char* text, TickType_t lockWait) {
+  // multipart: the text goes out as-is, no JSON escaping or copy
+  char path[96];
+  char framing[320];
+  MultipartBuilder body(framing, sizeof(framing));
+  body.field("chat_id", TELEGRAM_CHANNEL);
+  body.fieldRef("text", (const uint8_t*)text, strlen(text));
+  if (!telegramPath(path, sizeof(path), "sendMessage") || !body.finish()) return 0;
+
+  TelegramResponse resp;
+  int httpCode = telegramLink.request("POST", path, body.contentType(), body.parts(), body.partCount(), resp,
+                                      TELEGRAM_IO_TIMEOUT_MS, lockWait);
+  if (httpCode != TELEGRAM_LINK_BUSY) Serial.printf("Text message http=%d\n", httpCode);
+  return httpCode;
 }
 
-// ------------ Telegram: photo (STREAMING, no big malloc) ------------
-static bool readHttpResponse(WiFiClientSecure& client, String& out) {
-  unsigned long start = millis();
-  out = "";
-
-  while (client.connected() && (millis() - start) < 15000UL) {
-    while (client.available()) {
-      char c = (char)client.read();
-      out += c;
-      if (out.length() > 3000) {
-        out.remove(0, 1500);
-      }
-    }
-    if (!client.available()) delay(10);
+static bool parkReply(const char* text) {
+  size_t len = strlen(text) + 1;
+  bool parked = false;
+  portENTER_CRITICAL(&parkedMux);
+  if (parkedBytes + len <= sizeof(parkedReplies)) {
+    memcpy(parkedReplies + parkedBytes, text, len);
+    parkedBytes += len;
+    parked = true;
+    replyStats.parked++;
+    if (parkedBytes > replyStats.maxParkedBytes) replyStats.maxParkedBytes = parkedBytes;
+  } else {
+    replyStats.dropped++;
   }
-  return out.length() > 0;
+  portEXIT_CRITICAL(&parkedMux);
+  return parked;
 }
 
-bool sendPhotoToTelegram(camera_fb_t *fb, String caption) {
-  telegramDebug = "🔄 Upload (streaming)...";
+// True once the message is sent or parked
+bool sendTelegramMessage(const char* text) {
+  if (WiFi.status() != WL_CONNECTED) return false;
+  if (parkedBytes == 0) {
+    int httpCode = postMessage(text, pdMS_TO_TICKS(TELEGRAM_REPLY_WAIT_MS));
+    if (httpCode != TELEGRAM_LINK_BUSY) return httpCode == 200;
+  }
+  return parkReply(text);
+}
 
-  if (WiFi.status() != WL_CONNECTED) {
-    telegramDebug = "❌ WiFi not connected";
-    return false;
+// Called from loop(): parked messages, oldest first, while the link is free.
+// A message that fails is dropped like a direct send that fails.
+void sendParkedReplies() {
+  while (parkedBytes > 0 && WiFi.status() == WL_CONNECTED) {
+    if (postMessage(parkedReplies, 0) == TELEGRAM_LINK_BUSY) return;
+    size_t len = strlen(parkedReplies) + 1;
+    portENTER_CRITICAL(&parkedMux);
+    memmove(parkedReplies, parkedReplies + len, parkedBytes - len);
+    parkedBytes -= len;
+    portEXIT_CRITICAL(&parkedMux);
   }
+}
 
-  WiFiClientSecure client;
-  client.setInsecure();
-  client.setTimeout(60000);
+bool sendTelegramMessage(const String& message) {
+  return sendTelegramMessage(message.c_str());
+}
 
-  const char* host = "api.telegram.org";
-  if (!client.connect(host, 443)) {
-    telegramDebug = "❌ TLS connect failed";
-    return false;
-  }
+// ------------ Telegram: photo (STREAMING, no big malloc) ------------
+bool sendPhotoToTelegram(camera_fb_t *fb, String caption) {
+  InlineText<96> full;
+  full.addf("ESP32-CAM: %s | %s", caption.c_str(), timeText().c_str());
+  return sendPhotoBuffer(fb->buf, fb->len, full.c_str());
+}
 
-  String boundary = "----ESP32CAM" + String(millis());
+// One sendPhoto upload of `buf` to `chat`; `bytes` gets the request body
+// size. 0 when the request does not fit the framing buffer.
+static int postPhoto(const char* chat, const uint8_t* buf, size_t len, const char* caption,
+                     TelegramResponse& resp, size_t& bytes) {
+  char path[96];
+  char framing[512];
+  MultipartBuilder body(framing, sizeof(framing));
+  body.field("chat_id", chat);
+  body.field("caption", caption);
+  body.file("photo", "image.jpg", "image/jpeg", buf, len);
+  if (!telegramPath(path, sizeof(path), "sendPhoto") || !body.finish()) return 0;
+  bytes = body.contentLength();
+  return telegramLink.request("POST", path, body.contentType(),
+                              body.parts(), body.partCount(), resp, 60000UL);
+}
 
-  String part1 =
-    "--" + boundary + "\r\n"
-    "Content-Disposition: form-data; name=\"chat_id\"\r\n\r\n" +
-    String(TELEGRAM_CHANNEL) + "\r\n";
+// One sendMediaGroup with 2..TELEGRAM_ALBUM_MAX photos to `chat`, each
+// written from where it is; the caption goes on the first photo. Returns
+// like postPhoto().
+static int postAlbum(const char* chat, const uint8_t* const* bufs, const size_t* lens, int n,
+                     const char* caption, TelegramResponse& resp, size_t& bytes) {
+  char mediaMem[768];
+  FixedText media(mediaMem, sizeof(mediaMem));
+  media.add("[");
+  for (int i = 0; i < n; i++) {
+    if (i) media.add(",");
+    media.add("{\"type\":\"photo\",\"media\":\"attach://f").addNum(i).add("\"");
+    if (i == 0) media.add(",\"caption\":\"").addJson(caption).add("\"");
+    media.add("}");
+  }
+  media.add("]");
+
+  char path[96];
+  char framing[1536];
+  MultipartBuilder body(framing, sizeof(framing));
+  body.field("chat_id", chat);
+  body.fieldRef("media", (const uint8_t*)media.c_str(), media.length());
+  for (int i = 0; i < n; i++) {
+    char name[12], file[16];
+    snprintf(name, sizeof(name), "f%d", i);
+    snprintf(file, sizeof(file), "f%d.jpg", i);
+    body.file(name, file, "image/jpeg", bufs[i], lens[i]);
+  }
+  if (!media.ok() || !telegramPath(path, sizeof(path), "sendMediaGroup") || !body.finish()) return 0;
+  bytes = body.contentLength();
+  return telegramLink.request("POST", path, body.contentType(),
+                              body.parts(), body.partCount(), resp, 90000UL);
+}
 
-  String part2 =
-    "--" + boundary + "\r\n"
-    "Content-Disposition: form-data; name=\"caption\"\r\n\r\n"
-    "ESP32-CAM: " + caption + " | " + getTimeString() + "\r\n";
+// After a successful upload of n photos to TELEGRAM_CHANNEL: the same photo
+// or album to every TELEGRAM_FANOUT_CHATS chat by file_id, or uploaded again
+// when the response had none (telegram_fanout.h)
+static void fanoutUpload(const uint8_t* const* bufs, const size_t* lens, int n, const char* caption,
+                         size_t uploadBytes) {
+  unsigned long t0 = millis();
+  const char* ref = (n == 1) ? fanoutSink.fileId(0) : fanoutAlbumMedia(n, caption);
+  size_t total = uploadBytes;
+  int chats = 0;
+  char chat[FANOUT_CHAT_MAX];
+  for (; fanoutChat(chats, chat, sizeof(chat)); chats++) {
+    size_t bytes = 0;
+    bool ok;
+    if (ref && n == 1) {
+      ok = fanoutSend(chat, "sendPhoto", "photo", ref, caption, bytes);
+    } else if (ref) {
+      ok = fanoutSend(chat, "sendMediaGroup", "media", ref, nullptr, bytes);
+    } else {
+      TelegramResponse resp;
+      int httpCode = (n == 1) ? postPhoto(chat, bufs[0], lens[0], caption, resp, bytes)
+                              : postAlbum(chat, bufs, lens, n, caption, resp, bytes);
+      ok = httpCode > 0 && resp.ok();
+      fanoutStats.fallbackUploads++;
+    }
+    if (ok) fanoutStats.sent++;
+    else fanoutStats.failed++;
+    total += bytes;
+  }
+  fanoutReport(total, uploadBytes * (1 + chats), t0);
+}
 
-  String part3 =
-    "--" + boundary + "\r\n"
-    "Content-Disposition: form-data; name=\"photo\"; filename=\"image.jpg\"\r\n"
-    "Content-Type: image/jpeg\r\n\r\n";
+// Status of the last failed photo or album upload: < 0 no answer (WiFi,
+// TLS, socket), 0 request too large to frame, else the HTTP status
+static int uploadFailHttp = 0;
 
-  String tail = "\r\n--" + boundary + "--\r\n";
+int uploadFailStatus() {
+  return uploadFailHttp;
+}
 
-  size_t contentLength = part1.length() + part2.length() + part3.length() + fb->len + tail.length();
+// Worth parking and retrying: Telegram never answered, had a server error or
+// asked us to slow down (429). Any other refusal fails the same way again.
+bool uploadFailureRetryable() {
+  return uploadFailHttp < 0 || uploadFailHttp >= 500 || uploadFailHttp == 429;
+}
 
-  String req =
-    "POST /bot" + String(TELEGRAM_BOT_TOKEN) + "/sendPhoto HTTP/1.1\r\n"
-    "Host: " + String(host) + "\r\n"
-    "User-Agent: ESP32CAM\r\n"
-    "Connection: close\r\n"
-    "Content-Type: multipart/form-data; boundary=" + boundary + "\r\n"
-    "Content-Length: " + String((unsigned)contentLength) + "\r\n\r\n";
+// Caption is sent verbatim. Framing is built in a stack buffer and the JPEG
+// is written straight from `buf`: no heap allocation on this path.
+bool sendPhotoBuffer(const uint8_t* buf, size_t len, const char* caption) {
+  setTelegramDebug("🔄 Upload (streaming)...");
 
-  client.print(req);
-  client.print(part1);
-  client.print(part2);
-  client.print(part3);
+  if (WiFi.status() != WL_CONNECTED) {
+    uploadFailHttp = -1;
+    setTelegramDebug("❌ WiFi not connected");
+    return false;
+  }
 
-  const uint8_t* p = fb->buf;
-  size_t left = fb->len;
-  const size_t CHUNK = 1024;
+  FanoutSession fanout;
+  TelegramResponse resp;
+  resp.sink = fanout.sink();   // reads the whole response for the file_id
+  size_t bytes = 0;
+  unsigned long t0 = micros();
+  int httpCode = postPhoto(TELEGRAM_CHANNEL, buf, len, caption, resp, bytes);
+  if (httpCode != 200 || !fanout.ok(resp)) uploadFailHttp = httpCode;
+  if (httpCode == 0) {
+    setTelegramDebug("❌ Request too large");
+    return false;
+  }
+  unsigned long dtMs = (micros() - t0) / 1000UL;
+  metricObserve(MET_UPLOAD, micros() - t0);
 
-  while (left > 0) {
-    size_t n = (left > CHUNK) ? CHUNK : left;
-    size_t w = client.write(p, n);
-    if (w == 0) {
-      telegramDebug = "❌ write failed";
-      client.stop();
-      return false;
-    }
-    p += w;
-    left -= w;
-    delay(0);
+  if (httpCode < 0) {
+    logEvent(EV_UPLOAD_FAIL, httpCode, dtMs);
+    setTelegramDebug("❌ TLS connect/write failed");
+    return false;
   }
 
-  client.print(tail);
+  if (fanout.ok(resp)) {
+    logEvent(EV_UPLOAD_OK, (int32_t)len, dtMs);
+    setTelegramDebug("✅ Photo uploaded!");
+    if (fanout.enabled()) fanoutUpload(&buf, &len, 1, caption, bytes);
+    return true;
+  }
+  logEvent(EV_UPLOAD_FAIL, httpCode, dtMs);
 
-  String response;
-  readHttpResponse(client, response);
-  client.stop();
+  setTelegramDebugf("❌ Upload failed (http %d)", httpCode);
+  Serial.println("Telegram response:");
+  Serial.println(fanout.body(resp));
+  return false;
+}
 
-  bool ok200 = response.indexOf(" 200 ") >= 0;
-  bool okJson = response.indexOf("\"ok\":true") >= 0;
+bool sendAlbumBuffers(const uint8_t* const* bufs, const size_t* lens, int n, const char* caption) {
+  setTelegramDebug("🔄 Uploading album...");
+
+  FanoutSession fanout;
+  TelegramResponse resp;
+  resp.sink = fanout.sink();
+  size_t bytes = 0;
+  unsigned long t0 = micros();
+  int httpCode = postAlbum(TELEGRAM_CHANNEL, bufs, lens, n, caption, resp, bytes);
+  if (httpCode != 200 || !fanout.ok(resp)) uploadFailHttp = httpCode;
+  if (httpCode == 0) {
+    setTelegramDebug("❌ Album request too large");
+    return false;
+  }
+  unsigned long dtMs = (micros() - t0) / 1000UL;
+  metricObserve(MET_UPLOAD, micros() - t0);
 
-  if (ok200 && okJson) {
-    telegramDebug = "✅ Photo uploaded!";
+  if (fanout.ok(resp)) {
+    size_t total = 0;
+    for (int i = 0; i < n; i++) total += lens[i];
+    logEvent(EV_UPLOAD_OK, (int32_t)total, dtMs);
+    setTelegramDebug("✅ Album uploaded");
+    if (fanout.enabled()) fanoutUpload(bufs, lens, n, caption, bytes);
     return true;
   }
-
-  telegramDebug = "❌ Upload failed";
-  Serial.println("Telegram response (trimmed):");
-  Serial.println(response);
+  logEvent(EV_UPLOAD_FAIL, httpCode, dtMs);
+  if (httpCode < 0) setTelegramDebug("❌ TLS connect/write failed");
+  else setTelegramDebugf("❌ Album failed (http %d)", httpCode);
+  if (httpCode > 0) Serial.println(fanout.body(resp));
   return false;
 }
 
@@ -495,23 +868,23 @@ bool sendPhotoToTelegramAlternative(camera_fb_t *fb, String caption) {
 }
 
 // ------------ Telegram test ------------
-void testTelegramConnection() {
+bool testTelegramConnection() {
   Serial.println("Testing Telegram connection...");
 
   bool textOK = sendTelegramMessage("📡 ESP32-CAM Connection Test\n✅ Text messages work!\nIP: " + WiFi.localIP().toString());
   if (!textOK) {
     Serial.println("Text message failed!");
-    telegramDebug = "❌ Text messages fail - check token/channel";
-    return;
+    setTelegramDebug("❌ Text messages fail - check token/channel");
+    return false;
   }
 
   Serial.println("Text message sent successfully!");
-  telegramDebug = "✅ Text messages work!";
+  setTelegramDebug("✅ Text messages work!");
 
-  camera_fb_t *fb = esp_camera_fb_get();
+  camera_fb_t *fb = grabFrame(PROFILE_CAPTURE);
   if (!fb) {
-    telegramDebug = "✅ Text ok, ❌ camera fb null";
-    return;
+    setTelegramDebug("✅ Text ok, ❌ camera fb null");
+    return false;
   }
 
   Serial.printf("Test photo size: %u bytes\n", (unsigned)fb->len);
@@ -520,280 +893,64 @@ void testTelegramConnection() {
 
   if (photoOK) {
     Serial.println("Photo sent successfully!");
-    telegramDebug = "✅ Both text and photos work!";
+    setTelegramDebug("✅ Both text and photos work!");
   } else {
     Serial.println("Photo failed, but text works");
-    telegramDebug = "✅ Text works, ❌ Photos fail";
+    setTelegramDebug("✅ Text works, ❌ Photos fail");
   }
+  return photoOK;
 }
 
 // ------------ Time formatting ------------
-String getTimeString() {
+// Returned by value: the text lives on the caller's stack
+InlineText<12> timeText() {
   unsigned long seconds = millis() / 1000UL;
   unsigned long minutes = seconds / 60UL;
   unsigned long hours = minutes / 60UL;
 
-  char buffer[20];
-  snprintf(buffer, sizeof(buffer), "%02lu:%02lu:%02lu", hours % 24, minutes % 60, seconds % 60);
-  return String(buffer);
+  InlineText<12> t;
+  t.addf("%02lu:%02lu:%02lu", hours % 24, minutes % 60, seconds % 60);
+  return t;
 }
 
-String getUptimeString() {
+InlineText<24> uptimeText() {
   unsigned long seconds = millis() / 1000UL;
   unsigned long minutes = seconds / 60UL;
   unsigned long hours = minutes / 60UL;
 
+  InlineText<24> t;
   if (hours > 0) {
-    return String(hours) + "h " + String(minutes % 60) + "m";
+    t.addf("%luh %lum", hours, minutes % 60);
   } else if (minutes > 0) {
-    return String(minutes) + "m " + String(seconds % 60) + "s";
+    t.addf("%lum %lus", minutes, seconds % 60);
   } else {
-    return String(seconds) + "s";
+    t.addf("%lus", seconds);
   }
+  return t;
 }
 
 // ========== TELEGRAM COMMAND HANDLING ==========
 
-long getLastUpdateID() {
-  if (!SPIFFS.exists(TELEGRAM_OFFSET_FILE)) return 0;
-
-  File file = SPIFFS.open(TELEGRAM_OFFSET_FILE, "r");
-  if (!file) return 0;
-
-  String content = file.readString();
-  file.close();
-  content.trim();
-  return content.toInt();
+// getLastUpdateID() / saveLastUpdateID(): see offset_journal.h
+
+// Trims, drops a "@botname" suffix and lowercases a command in its own
+// buffer; returns the new length
+size_t parseTelegramCommand(char* text) {
+  const char* start = text;
+  while (isspace((unsigned char)*start)) start++;
+  size_t len = strlen(start);
+  memmove(text, start, len + 1);
+  char* at = strchr(text, '@');
+  if (at && at > text) {
+    *at = 0;
+    len = at - text;
+  }
+  while (len && isspace((unsigned char)text[len - 1])) text[--len] = 0;
+  for (char* p = text; *p; p++) *p = tolower((unsigned char)*p);
+  return len;
 }
 
-void saveLastUpdateID(long update_id) {
-  File file = SPIFFS.open(TELEGRAM_OFFSET_FILE, "w");
-  if (!file) {
-    Serial.println("Failed to open offset file for writing");
-    return;
-  }
-  file.print(update_id);
-  file.close();
-}
-
-String parseTelegramCommand(String message) {
-  message.trim();
-  if (message.indexOf('@') > 0) {
-    message = message.substring(0, message.indexOf('@'));
-  }
-  return message;
-}
-
-static void persistSettingsDirty() {
-  extern void markStatsDirty();
-  markStatsDirty();
-}
-
-void handleTelegramCommand(String command) {
-  Serial.println("Handling command: " + command);
-
-  command.trim();
-  command.toLowerCase();
-  telegramDebug = "Command: " + command;
-
-  if (command == "/start" || command == "/help") {
-    String help = "🤖 ESP32-CAM Bot Commands:\n\n";
-    help += "📸 /capture - Take photo\n";
-    help += "📊 /status - Camera status\n";
-    help += "🔍 /test - Test connection\n";
-    help += "⚙️ /settings - Current settings\n";
-    help += "🔄 /reboot - Restart camera\n";
-    help += "🔧 /debug - Memory info\n";
-    help += "\n--- Settings from Telegram ---\n";
-    help += "🎛️ /mode 0|1|2  (0=motion,1=time,2=mixed)\n";
-    help += "⏱️ /interval N  (minutes, 1..1000)\n";
-    help += "🎚️ /threshold N (1000..20000)\n";
-    help += "✅ /motion_on  |  ⭕ /motion_off\n";
-    help += "\nIP: " + WiFi.localIP().toString();
-    help += "\nUptime: " + getUptimeString();
-    sendTelegramMessage(help);
-  }
-  else if (command == "/capture" || command == "/photo" || command == "/pic") {
-    sendTelegramMessage("📸 Capturing photo...");
-    captureImage("Telegram Command");
-  }
-  else if (command == "/status" || command == "/info") {
-    String status = "📊 Camera Status:\n\n";
-    status += "IP: " + WiFi.localIP().toString() + "\n";
-    status += "WiFi: " + String((WiFi.status() == WL_CONNECTED) ? WiFi.RSSI() : 0) + " dBm\n";
-    status += "Uptime: " + getUptimeString() + "\n";
-    status += "Captured: " + String(capturedCount) + "\n";
-    status += "Sent: " + String(sentCount) + "\n";
-    status += "Mode: " + String((captureMode == 0) ? "Motion" : (captureMode == 1) ? "Time" : "Mixed");
-    status += "\nInterval: " + String(timeInterval) + " min";
-    status += "\nSensitivity: " + String(motionThreshold);
-    status += "\nMotion: " + String(motionEnabled ? "ON" : "OFF");
-    sendTelegramMessage(status);
-  }
-  else if (command == "/settings") {
-    String settings = "⚙️ Current Settings:\n\n";
-    settings += "Mode: " + String((captureMode == 0) ? "Motion" : (captureMode == 1) ? "Time" : "Mixed");
-    settings += "\nInterval: " + String(timeInterval) + " min";
-    settings += "\nSensitivity: " + String(motionThreshold);
-    settings += "\nMotion: " + String(motionEnabled ? "ON" : "OFF");
-    settings += "\nLast Capture: " + lastCaptureTime;
-    settings += "\nLast Telegram: " + lastTelegramResult;
-    sendTelegramMessage(settings);
-  }
-  else if (command == "/debug") {
-    String s = "🧠 Memory Debug:\n";
-    s += "freeHeap: " + String(ESP.getFreeHeap()) + "\n";
-    s += "minHeap: " + String(ESP.getMinFreeHeap()) + "\n";
-#if defined(BOARD_HAS_PSRAM) || defined(CONFIG_SPIRAM_SUPPORT)
-    s += "freePSRAM: " + String(ESP.getFreePsram()) + "\n";
-#else
-    s += "freePSRAM: 0\n";
-#endif
-    s += "reset: " + resetReasonString() + " (" + String(resetReasonCode()) + ")";
-    sendTelegramMessage(s);
-  }
-  else if (command == "/test") {
-    sendTelegramMessage("🔍 Testing connection...");
-    testTelegramConnection();
-  }
-  else if (command == "/reboot" || command == "/restart") {
-    sendTelegramMessage("🔄 Restarting ESP32-CAM...");
-    delay(800);
-    ESP.restart();
-  }
-  else if (command == "/motion_on") {
-    motionEnabled = true;
-    persistSettingsDirty();
-    sendTelegramMessage("✅ Motion detection enabled");
-  }
-  else if (command == "/motion_off") {
-    motionEnabled = false;
-    persistSettingsDirty();
-    sendTelegramMessage("⭕ Motion detection disabled");
-  }
-  // ✅ NEW: set mode from telegram
-  else if (command.startsWith("/mode ")) {
-    int m = command.substring(6).toInt();
-    if (m < 0 || m > 2) {
-      sendTelegramMessage("❌ mode must be 0,1,2\n0=motion 1=time 2=mixed");
-      return;
-    }
-    captureMode = m;
-    persistSettingsDirty();
-    sendTelegramMessage("✅ Mode set to " + String(m));
-  }
-  // ✅ NEW: set interval from telegram
-  else if (command.startsWith("/interval ")) {
-    int v = command.substring(10).toInt();
-    if (v < 1 || v > 1000) {
-      sendTelegramMessage("❌ interval must be 1..1000 (minutes)");
-      return;
-    }
-    timeInterval = v;
-    persistSettingsDirty();
-    sendTelegramMessage("✅ Interval set to " + String(v) + " min");
-  }
-  // ✅ NEW: set threshold from telegram
-  else if (command.startsWith("/threshold ")) {
-    int v = command.substring(11).toInt();
-    if (v < 1000 || v > 20000) {
-      sendTelegramMessage("❌ threshold must be 1000..20000");
-      return;
-    }
-    motionThreshold = v;
-    persistSettingsDirty();
-    sendTelegramMessage("✅ Threshold set to " + String(v));
-  }
-  else if (command == "/stream") {
-    String streamUrl = "🌐 Live Stream:\n";
-    streamUrl += "http://" + WiFi.localIP().toString() + "\n";
-    sendTelegramMessage(streamUrl);
-  }
-  else {
-    sendTelegramMessage("❓ Unknown command: " + command + "\nType /help");
-  }
-}
-
-void checkTelegramCommands() {
-  static unsigned long lastCheck = 0;
-  unsigned long currentMillis = millis();
-
-  if (currentMillis - lastCheck < TELEGRAM_POLL_INTERVAL) return;
-  lastCheck = currentMillis;
-
-  if (WiFi.status() != WL_CONNECTED) return;
-
-  long last_update_id = getLastUpdateID();
-
-  WiFiClientSecure client;
-  client.setInsecure();
-  client.setTimeout(5000);
-
-  HTTPClient http;
-  String url = "https://api.telegram.org/bot" + String(TELEGRAM_BOT_TOKEN) +
-               "/getUpdates?offset=" + String(last_update_id + 1) +
-               "&limit=1&timeout=1";
-
-  if (!http.begin(client, url)) return;
-
-  int httpCode = http.GET();
-  if (httpCode == 200) {
-    String response = http.getString();
-
-    StaticJsonDocument<1536> doc;
-    DeserializationError error = deserializeJson(doc, response);
-
-    if (!error && doc["ok"] == true && doc["result"].size() > 0) {
-      long update_id = doc["result"][0]["update_id"];
-
-      // Prepare command (optional)
-      bool hasCmd = false;
-      String cmd = "";
-      String sender = "Unknown";
-
-      // Sender info (optional)
-      if (doc["result"][0].containsKey("message") &&
-          doc["result"][0]["message"].containsKey("from")) {
-
-        JsonObject from = doc["result"][0]["message"]["from"];
-        if (from.containsKey("username")) {
-          sender = from["username"].as<String>();
-        } else if (from.containsKey("first_name")) {
-          sender = from["first_name"].as<String>();
-        }
-      }
-
-      // Extract text command (only if exists)
-      if (doc["result"][0].containsKey("message") &&
-          doc["result"][0]["message"].containsKey("text")) {
-
-        String messageText = doc["result"][0]["message"]["text"].as<String>();
-        cmd = parseTelegramCommand(messageText);
-        hasCmd = (cmd.length() > 0);
-      }
-
-      // ✅ CRITICAL FIX:
-      // Save update_id BEFORE executing any command (reboot/capture etc.)
-      saveLastUpdateID(update_id);
-
-      // Execute only if we actually have a text command
-      if (hasCmd) {
-        Serial.println("Telegram command from " + sender + ": " + cmd);
-        telegramDebug = "CMD from " + sender + ": " + cmd;
-
-        handleTelegramCommand(cmd);
-      }
-    }
-  } else if (httpCode > 0) {
-    Serial.printf("Telegram API error: %d\n", httpCode);
-    telegramDebug = "Telegram API error: " + String(httpCode);
-  } else {
-    Serial.println("Telegram connection failed");
-    telegramDebug = "Telegram connection failed";
-  }
-
-  http.end();
-}
+// handleTelegramCommand(): see telegram_commands.h
 
 
 #endif
@@ -0,0 +1,107 @@
+// Telegram command lookup: the perfect-hash table against the chains it replaced.
+//
+// Every row of telegramCommands[] must be found by its own name, and
+// prefixes, near misses and unknown words must not. The lookup is then
+// timed over a mix of real commands (with arguments, as they arrive) and
+// unknown text, next to the String ==/startsWith chain of the old
+// handleTelegramCommand() and a plain strcmp scan of the table.
+
+#include "sketch_harness.h"
+
+#include <vector>
+#include "host_check.h"
+
+uint16_t simBotPort;
+
+// The old dispatch: one branch per command, in the old order
+static int stringChain(const String& command) {
+  if (command == "/start" || command == "/help") return 1;
+  else if (command == "/capture" || command == "/photo" || command == "/pic") return 2;
+  else if (command == "/burst" || command.startsWith("/burst ")) return 3;
+  else if (command == "/status" || command == "/info") return 4;
+  else if (command == "/settings") return 5;
+  else if (command == "/debug") return 6;
+  else if (command == "/log" || command.startsWith("/log ")) return 7;
+  else if (command == "/metrics") return 8;
+  else if (command == "/test") return 9;
+  else if (command == "/reboot" || command == "/restart") return 10;
+  else if (command == "/motion_on") return 11;
+  else if (command == "/motion_off") return 12;
+  else if (command.startsWith("/mode ")) return 13;
+  else if (command.startsWith("/interval ")) return 14;
+  else if (command.startsWith("/threshold ")) return 15;
+  else if (command.startsWith("/prebuffer ")) return 16;
+  else if (command == "/dedup" || command.startsWith("/dedup ")) return 17;
+  else if (command == "/schedule" || command.startsWith("/schedule ")) return 18;
+  else if (command == "/stream") return 19;
+  return 0;
+}
+
+static uint8_t strcmpScan(const char* name) {
+  for (uint8_t i = 0; i < CMD_COUNT; i++) {
+    if (strcmp(telegramCommands[i].name, name) == 0) return i;
+  }
+  return CMD_NONE;
+}
+
+// As handleTelegramCommand(): the name is cut at the first space in the
+// lowercased copy and looked up without its slash
+static uint8_t hashLookup(const char* text) {
+  char buf[64];
+  strncpy(buf, text, sizeof(buf) - 1);
+  buf[sizeof(buf) - 1] = 0;
+  char* space = strchr(buf, ' ');
+  if (space) *space = 0;
+  return buf[0] == '/' ? findCommand(buf + 1) : CMD_NONE;
+}
+
+static const char* inputs[] = {
+  "/help", "/capture", "/photo", "/status", "/interval 15", "/mode 2", "/threshold 6000",
+  "/stream", "/schedule add 10 22:00 06:00", "/dedup 6 heartbeat", "/motion_off", "/log 20",
+  "/prebuffer 768 3 2", "/burst 5 200", "hello", "/unknown", "/statu", "/streams",
+};
+static const size_t inputCount = sizeof(inputs) / sizeof(inputs[0]);
+
+template <class F> static double nsPerLookup(F lookup) {
+  const int rounds = 20000;
+  volatile unsigned sink = 0;
+  double t0 = hostNowUs();
+  for (int r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < inputCount; i++) sink = sink + lookup(i);
+  }
+  return (hostNowUs() - t0) * 1000.0 / (rounds * inputCount);
+}
+
+int main() {
+  for (uint8_t i = 0; i < CMD_COUNT; i++) {
+    CHECK(findCommand(telegramCommands[i].name) == i);
+  }
+  const char* misses[] = { "", "stat", "statu", "statuss", "Help", "mode2", "motion", "motion_", "x" };
+  for (const char* m : misses) CHECK(findCommand(m) == CMD_NONE);
+  for (size_t i = 0; i < inputCount; i++) {
+    String s(inputs[i]);
+    bool known = strcmp(inputs[i], "hello") && strcmp(inputs[i], "/unknown") && strcmp(inputs[i], "/statu") &&
+                 strcmp(inputs[i], "/streams");
+    CHECK((hashLookup(inputs[i]) != CMD_NONE) == known);
+    CHECK((stringChain(s) != 0) == known);
+  }
+
+  std::vector<String> strings;
+  for (size_t i = 0; i < inputCount; i++) strings.push_back(String(inputs[i]));
+  double chain = nsPerLookup([&](size_t i) { return (unsigned)stringChain(strings[i]); });
+  double scan = nsPerLookup([&](size_t i) {
+    char buf[64];
+    strncpy(buf, inputs[i], sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = 0;
+    char* space = strchr(buf, ' ');
+    if (space) *space = 0;
+    return (unsigned)strcmpScan(buf + 1);
+  });
+  double hash = nsPerLookup([&](size_t i) { return (unsigned)hashLookup(inputs[i]); });
+
+  printf("%u commands, %d hash slots, %zu inputs (4 unknown)\n", (unsigned)CMD_COUNT, CMD_HASH_SLOTS, inputCount);
+  printf("String ==/startsWith chain: %7.1f ns/lookup\n", chain);
+  printf("strcmp table scan:         %7.1f ns/lookup\n", scan);
+  printf("perfect hash:              %7.1f ns/lookup (%.1fx the chain)\n", hash, chain / hash);
+  return hostFailures();
+}
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""Regenerates the JPEG fixtures for the host tests (needs Pillow).
+
+    python3 host/fixtures/make_fixtures.py
+
+Scenes are synthetic but camera-like: a textured background (the case the
+old JPEG-length heuristic got wrong), the same scene brighter (auto-exposure)
+and with an object added. Each scene also gets a .grid file with the true
+per-cell mean luma of the pixels, so the DC-only decoder's accuracy can be
+checked. The VGA/SVGA scenes and trace_office.txt drive host/sim.cpp: the
+sensor sees the empty room, a person walking in three times and the lights
+going up once, at both the motion (VGA) and the capture (SVGA) size.
+Output is deterministic.
+"""
+
+import os
+import random
+from PIL import Image, ImageDraw
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+GRID_W, GRID_H = 20, 15            # MOTION_GRID_W / MOTION_GRID_H
+
+
+def scene(w, h, seed=1, shift=0, box=None):
+    rnd = random.Random(seed)
+    im = Image.new("L", (w, h))
+    px = im.load()
+    for y in range(h):
+        for x in range(w):
+            v = 60 + (x * 100) // w + (y * 40) // h + rnd.randint(-12, 12)
+            if ((x // 16) + (y // 16)) % 2:
+                v += 25                       # checkerboard texture
+            px[x, y] = max(0, min(255, v + shift))
+    if box:
+        ImageDraw.Draw(im).rectangle(box, fill=20)
+    return im
+
+
+def write_grid(im, name):
+    w, h = im.size
+    px = im.load()
+    rows = []
+    for gy in range(GRID_H):
+        row = []
+        for gx in range(GRID_W):
+            x0, x1 = gx * w // GRID_W, (gx + 1) * w // GRID_W
+            y0, y1 = gy * h // GRID_H, (gy + 1) * h // GRID_H
+            s = sum(px[x, y] for y in range(y0, y1) for x in range(x0, x1))
+            row.append(str(round(s / ((x1 - x0) * (y1 - y0)))))
+        rows.append(" ".join(row))
+    with open(os.path.join(HERE, name), "w") as f:
+        f.write("\n".join(rows) + "\n")
+
+
+def save(im, name, **kw):
+    im.convert("RGB").save(os.path.join(HERE, name), "JPEG", quality=kw.pop("quality", 80), **kw)
+
+
+def main():
+    box = (160, 120, 223, 199)                # object: cells 10..13 x 7..12 at 320x240
+    base = scene(320, 240)
+    save(base, "qvga_base.jpg")
+    write_grid(base, "qvga_base.grid")
+    save(scene(320, 240, shift=30), "qvga_exposure.jpg")
+    save(scene(320, 240, box=box), "qvga_object.jpg")
+
+    # ESP32 cameras emit 4:2:2; restart intervals split the scan
+    save(base, "qvga_base_422_rst.jpg", subsampling=1, restart_marker_blocks=5)
+    save(scene(320, 240, box=box), "qvga_object_422_rst.jpg", subsampling=1, restart_marker_rows=1)
+
+    save(base, "qvga_progressive.jpg", progressive=True)   # must be rejected
+
+    big = scene(800, 600, seed=2)
+    save(big, "svga_base.jpg", quality=60)
+    write_grid(big, "svga_base.grid")
+
+    # Simulator trace: motion frames at VGA (pre-event ring on), captures at SVGA
+    for w, h in ((640, 480), (800, 600)):
+        name = "vga" if w == 640 else "svga"
+        person = (w // 2, h // 2, w // 2 + w // 5, h - 1)
+        save(scene(w, h, seed=3), "trace_%s_empty.jpg" % name, quality=40)
+        save(scene(w, h, seed=3, box=person), "trace_%s_person.jpg" % name, quality=40)
+        save(scene(w, h, seed=3, shift=30), "trace_%s_lights.jpg" % name, quality=40)
+    steps = [(0, "empty"), (60000, "person"), (75000, "empty"), (180000, "lights"),
+             (240000, "empty"), (300000, "person"), (330000, "empty"), (480000, "person"),
+             (490000, "empty"), (600000, "empty")]
+    with open(os.path.join(HERE, "trace_office.txt"), "w") as f:
+        f.write("# ms from camera init, then the scene at the motion and capture sizes\n")
+        for t, what in steps:
+            f.write("%-7d trace_vga_%s.jpg trace_svga_%s.jpg\n" % (t, what, what))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,49 @@
+#ifndef HOST_CHECK_H
+#define HOST_CHECK_H
+
+// ------------ Minimal checks for the host tests ------------
+// CHECK() reports and counts a failure and carries on, so one run lists
+// every broken case; main() returns hostFailures() as the exit status.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+static int hostFailed = 0;
+
+#define CHECK(cond)                                                      \
+  do {                                                                   \
+    if (!(cond)) {                                                       \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);             \
+      hostFailed++;                                                      \
+    }                                                                    \
+  } while (0)
+
+static inline int hostFailures() {
+  printf(hostFailed ? "%d check(s) failed\n" : "all checks passed\n", hostFailed);
+  return hostFailed ? 1 : 0;
+}
+
+// Whole file, empty when it cannot be read
+static inline std::vector<uint8_t> readFixture(const char* path) {
+  std::vector<uint8_t> data;
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    printf("cannot open %s\n", path);
+    return data;
+  }
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+  fclose(f);
+  return data;
+}
+
+static inline double hostNowUs() {
+  using namespace std::chrono;
+  return duration_cast<duration<double, std::micro>>(steady_clock::now().time_since_epoch()).count();
+}
+
+#endif
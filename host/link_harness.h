@@ -0,0 +1,30 @@
+#ifndef LINK_HARNESS_H
+#define LINK_HARNESS_H
+
+// ------------ TelegramLink against the mock Bot API ------------
+// Compiles telegram_request.h and telegram_transport.h on their own, aimed
+// at MockBotApi on loopback. Set mockPort from MockBotApi::port() before
+// the first request.
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <WiFiClientSecure.h>
+#include "fixed_text.h"
+
+static uint16_t mockPort;
+#define TELEGRAM_HOST "127.0.0.1"
+#define TELEGRAM_PORT mockPort
+static const char* TELEGRAM_BOT_TOKEN = "123456:HOST-TEST";
+static const char* TELEGRAM_CHANNEL = "@host_test";
+
+// Hooks telegram_transport.h reports to (event_log.h, metrics.h)
+enum EventId { EV_TLS_CONNECT, EV_TLS_FAIL };
+enum MetricStage { MET_TLS_CONNECT };
+static void logEvent(EventId, int32_t = 0, int32_t = 0) {}
+static void metricObserve(MetricStage, uint32_t) {}
+
+#include "telegram_request.h"
+#include "telegram_transport.h"
+#include "mock_bot_api.h"
+
+#endif
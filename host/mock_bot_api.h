@@ -0,0 +1,254 @@
+#ifndef MOCK_BOT_API_H
+#define MOCK_BOT_API_H
+
+// ------------ Local mock of the Telegram Bot API ------------
+// Plain HTTP/1.1 keep-alive server on 127.0.0.1 (an ephemeral port), one
+// thread per connection. Requests are answered the way api.telegram.org
+// answers them: "ok" first, then the result. A reply can hold back the
+// part after {"ok":true for a while (a slow tail, as a big getUpdates or
+// sendMediaGroup result has), use chunked encoding, close the connection
+// or hang up part-way through.
+// Every request is counted by Bot API method. The server's own allocations
+// are left out of the device heap model (host_heap.h).
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "host_heap.h"
+
+struct MockRequest {
+  std::string method;      // "POST"
+  std::string path;        // "/bot<token>/sendPhoto"
+  std::string apiMethod;   // "sendPhoto"
+  std::string contentType;
+  std::string body;
+};
+
+struct MockReply {
+  int status = 200;
+  std::string body;
+  unsigned tailDelayMs = 0;   // pause after {"ok":true (simulated ms)
+  bool chunked = false;
+  bool close = false;         // Connection: close, then hang up
+  int cutAt = -1;             // >= 0: hang up after this many bytes of the reply
+};
+
+class MockBotApi {
+ public:
+  // Default answers: a message for send*, an empty batch for getUpdates
+  std::function<MockReply(const MockRequest&)> handler = defaultReply;
+
+  ~MockBotApi() { stop(); }
+
+  bool start() {
+    HostHeapExempt exempt;
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in a = {};
+    a.sin_family = AF_INET;
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t n = sizeof(a);
+    if (bind(listenFd, (sockaddr*)&a, n) != 0 || listen(listenFd, 8) != 0 ||
+        getsockname(listenFd, (sockaddr*)&a, &n) != 0) {
+      return false;
+    }
+    boundPort = ntohs(a.sin_port);
+    running = true;
+    acceptThread = std::thread([this] { acceptLoop(); });
+    return true;
+  }
+
+  void stop() {
+    if (!running) return;
+    running = false;
+    acceptThread.join();
+    for (std::thread& t : connThreads) t.join();
+    connThreads.clear();
+    close(listenFd);
+  }
+
+  uint16_t port() const { return boundPort; }
+
+  unsigned count(const char* apiMethod) {
+    std::lock_guard<std::mutex> lock(m);
+    return perMethod[apiMethod];
+  }
+  unsigned requests() {
+    std::lock_guard<std::mutex> lock(m);
+    return total;
+  }
+  unsigned connections() const { return accepted; }
+  size_t bytesIn() const { return received; }
+
+  static MockReply defaultReply(const MockRequest& r) {
+    static std::atomic<unsigned> messageId(1000);
+    MockReply reply;
+    unsigned id = ++messageId;
+    if (r.apiMethod == "getUpdates") {
+      reply.body = "{\"ok\":true,\"result\":[]}";
+    } else if (r.apiMethod == "sendPhoto") {
+      reply.body = "{\"ok\":true,\"result\":{\"message_id\":" + std::to_string(id) +
+                   ",\"photo\":[{\"file_id\":\"AgACAgQAAxkDAAI" + std::to_string(id) +
+                   "s\",\"file_unique_id\":\"AQADs\",\"width\":320,\"height\":240}]}}";
+    } else if (r.apiMethod == "sendMediaGroup") {
+      reply.body = "{\"ok\":true,\"result\":[{\"message_id\":" + std::to_string(id) +
+                   ",\"photo\":[{\"file_id\":\"AgACAgQAAxkDAAJ" + std::to_string(id) + "m\"}]}]}";
+    } else {
+      reply.body = "{\"ok\":true,\"result\":{\"message_id\":" + std::to_string(id) + "}}";
+    }
+    return reply;
+  }
+
+ private:
+  int listenFd = -1;
+  uint16_t boundPort = 0;
+  std::atomic<bool> running{false};
+  std::thread acceptThread;
+  std::vector<std::thread> connThreads;
+  std::mutex m;
+  std::map<std::string, unsigned> perMethod;
+  unsigned total = 0;
+  std::atomic<unsigned> accepted{0};
+  std::atomic<size_t> received{0};
+
+  void acceptLoop() {
+    HostHeapExempt exempt;
+    while (running) {
+      pollfd p = { listenFd, POLLIN, 0 };
+      if (poll(&p, 1, 50) <= 0) continue;
+      int fd = accept(listenFd, nullptr, nullptr);
+      if (fd < 0) continue;
+      accepted++;
+      connThreads.emplace_back([this, fd] { serve(fd); });
+    }
+  }
+
+  // Waits for readable data; false once the server is stopping
+  bool waitReadable(int fd) {
+    while (running) {
+      pollfd p = { fd, POLLIN, 0 };
+      if (poll(&p, 1, 50) > 0) return true;
+    }
+    return false;
+  }
+
+  // Linux delays ACKs by up to 40 ms; with the client's Nagle that stalls
+  // every request sent as head + body. Acknowledge at once, as a busy
+  // server effectively does.
+  static ssize_t receive(int fd, char* buf, size_t n) {
+    ssize_t r = recv(fd, buf, n, 0);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one));
+    return r;
+  }
+
+  void serve(int fd) {
+    HostHeapExempt exempt;
+    std::string in;
+    char buf[8192];
+    for (;;) {
+      size_t headEnd;
+      while ((headEnd = in.find("\r\n\r\n")) == std::string::npos) {
+        if (!waitReadable(fd)) return finish(fd);
+        ssize_t r = receive(fd, buf, sizeof(buf));
+        if (r <= 0) return finish(fd);
+        in.append(buf, (size_t)r);
+      }
+
+      MockRequest req;
+      std::string head = in.substr(0, headEnd);
+      size_t sp1 = head.find(' '), sp2 = head.find(' ', sp1 + 1);
+      req.method = head.substr(0, sp1);
+      req.path = head.substr(sp1 + 1, sp2 - sp1 - 1);
+      req.apiMethod = req.path.substr(req.path.rfind('/') + 1);
+      size_t q = req.apiMethod.find('?');
+      if (q != std::string::npos) req.apiMethod.resize(q);
+      size_t contentLength = 0;
+      std::string lower = head;
+      for (char& c : lower) c = (char)tolower((unsigned char)c);
+      size_t cl = lower.find("\r\ncontent-length:");
+      if (cl != std::string::npos) contentLength = strtoul(lower.c_str() + cl + 17, nullptr, 10);
+      size_t ct = lower.find("\r\ncontent-type:");
+      if (ct != std::string::npos) {
+        size_t from = head.find_first_not_of(' ', ct + 15);
+        req.contentType = head.substr(from, head.find("\r\n", from) - from);
+      }
+
+      in.erase(0, headEnd + 4);
+      while (in.size() < contentLength) {
+        if (!waitReadable(fd)) return finish(fd);
+        ssize_t r = receive(fd, buf, sizeof(buf));
+        if (r <= 0) return finish(fd);
+        in.append(buf, (size_t)r);
+      }
+      req.body = in.substr(0, contentLength);
+      in.erase(0, contentLength);
+      received += headEnd + 4 + contentLength;
+      {
+        std::lock_guard<std::mutex> lock(m);
+        perMethod[req.apiMethod]++;
+        total++;
+      }
+
+      MockReply reply = handler(req);
+      if (!sendReply(fd, reply) || reply.close) return finish(fd);
+    }
+  }
+
+  void finish(int fd) { close(fd); }
+
+  static bool sendAll(int fd, const std::string& s) {
+    size_t done = 0;
+    while (done < s.size()) {
+      ssize_t w = send(fd, s.data() + done, s.size() - done, MSG_NOSIGNAL);
+      if (w <= 0) return false;
+      done += (size_t)w;
+    }
+    return true;
+  }
+
+  static std::string chunk(const std::string& data) {
+    char size[24];
+    snprintf(size, sizeof(size), "%zx\r\n", data.size());
+    return size + data + "\r\n";
+  }
+
+  bool sendReply(int fd, const MockReply& reply) {
+    std::string head = "HTTP/1.1 " + std::to_string(reply.status) +
+                       (reply.status == 200 ? " OK" : " Error") +
+                       "\r\nServer: nginx\r\nContent-Type: application/json\r\n";
+    head += reply.chunked ? "Transfer-Encoding: chunked\r\n"
+                          : "Content-Length: " + std::to_string(reply.body.size()) + "\r\n";
+    head += reply.close ? "Connection: close\r\n\r\n" : "Connection: keep-alive\r\n\r\n";
+
+    // Split after {"ok":true when the tail is held back
+    size_t split = reply.body.size();
+    if (reply.tailDelayMs && reply.body.compare(0, 10, "{\"ok\":true") == 0) split = 10;
+    std::string first = reply.body.substr(0, split), rest = reply.body.substr(split);
+    if (reply.chunked) {
+      first = chunk(first);
+      rest = rest.empty() ? "0\r\n\r\n" : chunk(rest) + "0\r\n\r\n";
+    }
+    if (reply.cutAt >= 0) {
+      sendAll(fd, (head + first + rest).substr(0, (size_t)reply.cutAt));
+      return false;
+    }
+    if (!sendAll(fd, head + first)) return false;
+    if (rest.empty()) return true;
+    if (reply.tailDelayMs) delay(reply.tailDelayMs);
+    return sendAll(fd, rest);
+  }
+};
+
+#endif
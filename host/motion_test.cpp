@@ -0,0 +1,141 @@
+// Motion engine against the JPEG fixtures (fixtures/make_fixtures.py).
+//
+//   motion_test                 run the checks (from host/fixtures)
+//   motion_test a.jpg b.jpg ... replay recorded frames, one result per line
+//
+// Checks: the DC-only luma grid against the true per-cell means, baseline
+// and restart-marker scans, rejection of progressive/truncated files, motion
+// vs exposure change on a textured scene, the bounding box, and the cost of
+// one analyze() per frame size.
+
+#include "host_check.h"
+#include "motion_engine.h"
+
+#define CELL_DELTA 20     // motionThreshold 5000 / 250, the sketch default
+
+static bool readGrid(const char* path, uint8_t* px, int n) {
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  int i = 0, v;
+  while (i < n && fscanf(f, "%d", &v) == 1) px[i++] = (uint8_t)v;
+  fclose(f);
+  return i == n;
+}
+
+// Largest |decoded - true| cell mean; -1 when the file does not decode
+static int gridError(const char* jpg, const char* grid) {
+  std::vector<uint8_t> data = readFixture(jpg);
+  static LumaGrid g;
+  JpegLumaDecoder dec;
+  if (!dec.decode(data.data(), data.size(), MOTION_GRID_W, MOTION_GRID_H, g)) return -1;
+  uint8_t want[MOTION_GRID_W * MOTION_GRID_H];
+  if (!readGrid(grid, want, MOTION_GRID_W * MOTION_GRID_H)) return -1;
+  int worst = 0;
+  long sum = 0;
+  for (int i = 0; i < MOTION_GRID_W * MOTION_GRID_H; i++) {
+    int d = abs((int)g.px[i] - (int)want[i]);
+    sum += d;
+    if (d > worst) worst = d;
+  }
+  printf("%-24s %ux%u  grid error max %d mean %.2f\n", jpg, g.imgW, g.imgH, worst,
+         sum / (double)(MOTION_GRID_W * MOTION_GRID_H));
+  return worst;
+}
+
+static bool decodes(const std::vector<uint8_t>& data) {
+  static LumaGrid g;
+  JpegLumaDecoder dec;
+  return dec.decode(data.data(), data.size(), MOTION_GRID_W, MOTION_GRID_H, g);
+}
+
+// Second frame compared against the first
+static MotionResult compare(const char* first, const char* second) {
+  static MotionEngine engine;
+  engine.configure(CELL_DELTA, MOTION_MIN_CHANGED_CELLS);
+  engine.reset();
+  std::vector<uint8_t> a = readFixture(first), b = readFixture(second);
+  MotionResult r;
+  CHECK(engine.analyze(a.data(), a.size(), r) && !r.motion);
+  CHECK(engine.analyze(b.data(), b.size(), r));
+  printf("%-24s -> %-24s cells %u/%u shift %d peak %u box %u,%u %ux%u\n", first, second, r.changedCells,
+         r.totalCells, r.globalShift, r.peakDelta, r.boxX, r.boxY, r.boxW, r.boxH);
+  return r;
+}
+
+static void timeAnalyze(const char* path) {
+  std::vector<uint8_t> data = readFixture(path);
+  static MotionEngine engine;
+  engine.configure(CELL_DELTA, MOTION_MIN_CHANGED_CELLS);
+  MotionResult r;
+  const int rounds = 200;
+  double t0 = hostNowUs();
+  for (int i = 0; i < rounds; i++) engine.analyze(data.data(), data.size(), r);
+  printf("%-24s %6zu B  analyze %.1f us/frame (host)\n", path, data.size(), (hostNowUs() - t0) / rounds);
+}
+
+static int replay(int argc, char** argv) {
+  static MotionEngine engine;
+  engine.configure(CELL_DELTA, MOTION_MIN_CHANGED_CELLS);
+  for (int i = 1; i < argc; i++) {
+    std::vector<uint8_t> data = readFixture(argv[i]);
+    MotionResult r;
+    double t0 = hostNowUs();
+    bool ok = engine.analyze(data.data(), data.size(), r);
+    double us = hostNowUs() - t0;
+    if (!ok) {
+      printf("%s: not decodable\n", argv[i]);
+      continue;
+    }
+    printf("%s: %s cells %u/%u shift %d peak %u box %u,%u %ux%u %.0f us\n", argv[i], r.motion ? "MOTION" : "still",
+           r.changedCells, r.totalCells, r.globalShift, r.peakDelta, r.boxX, r.boxY, r.boxW, r.boxH, us);
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1) return replay(argc, argv);
+
+  // DC-only grid vs the pixel means, 4:2:0 / 4:2:2 with restart intervals / SVGA
+  int e = gridError("qvga_base.jpg", "qvga_base.grid");
+  CHECK(e >= 0 && e <= 6);
+  e = gridError("qvga_base_422_rst.jpg", "qvga_base.grid");
+  CHECK(e >= 0 && e <= 6);
+  e = gridError("svga_base.jpg", "svga_base.grid");
+  CHECK(e >= 0 && e <= 6);
+
+  // Not baseline, cut short, not a JPEG
+  std::vector<uint8_t> prog = readFixture("qvga_progressive.jpg");
+  CHECK(!prog.empty() && !decodes(prog));
+  std::vector<uint8_t> cut = readFixture("qvga_base.jpg");
+  cut.resize(cut.size() / 2);
+  CHECK(!decodes(cut));
+  cut = readFixture("qvga_base_422_rst.jpg");
+  cut.resize(cut.size() * 3 / 4);
+  CHECK(!decodes(cut));
+  std::vector<uint8_t> junk(cut.size(), 0x55);
+  CHECK(!decodes(junk));
+
+  // Same scene, 30 levels brighter: exposure, not motion
+  MotionResult r = compare("qvga_base.jpg", "qvga_exposure.jpg");
+  CHECK(!r.motion);
+  CHECK(r.globalShift >= 25 && r.globalShift <= 35);
+
+  // Dark object over cells 10..13 x 7..12 (pixels 160..223 x 120..199)
+  r = compare("qvga_base.jpg", "qvga_object.jpg");
+  CHECK(r.motion);
+  CHECK(r.boxW > 0 && r.boxX <= 160 && r.boxY <= 120 && r.boxX + r.boxW >= 224 && r.boxY + r.boxH >= 200);
+  CHECK(r.boxW <= 96 && r.boxH <= 112);
+
+  // Restart markers on both frames give the same decision
+  MotionResult rst = compare("qvga_base_422_rst.jpg", "qvga_object_422_rst.jpg");
+  CHECK(rst.motion);
+  CHECK(rst.boxX == r.boxX && rst.boxY == r.boxY && rst.boxW == r.boxW && rst.boxH == r.boxH);
+
+  // The same frame twice
+  r = compare("qvga_base.jpg", "qvga_base.jpg");
+  CHECK(!r.motion && r.changedCells == 0 && r.globalShift == 0);
+
+  timeAnalyze("qvga_base.jpg");
+  timeAnalyze("svga_base.jpg");
+  return hostFailures();
+}
@@ -0,0 +1,105 @@
+// Outbox (outbox.h): which failed uploads are parked, when they are given up.
+//
+// The sketch's upload task sends photos to the mock Bot API, which answers
+// sendPhoto with the status the test sets. A refused photo (400) is not
+// parked; a 502 is, and drains once Telegram is back. A parked photo that
+// gets a 400 on retry is dropped, and one that keeps failing is dropped
+// after OUTBOX_MAX_ATTEMPTS tries, so neither blocks the photos behind it.
+// An album parked photo by photo counts as one sent capture when drained.
+
+#include "sketch_harness.h"
+
+#include <atomic>
+#include <unistd.h>
+#include "host_check.h"
+#include "mock_bot_api.h"
+
+uint16_t simBotPort;
+
+#define WAIT_MS 20000   // simulated ms at x20: one real second, room for a loaded host
+
+static std::atomic<int> photoStatus(200);
+
+static MockReply reply(const MockRequest& r) {
+  MockReply out = MockBotApi::defaultReply(r);
+  if (r.apiMethod == "sendPhoto" && photoStatus != 200) {
+    out.status = photoStatus;
+    out.body = "{\"ok\":false,\"error_code\":" + std::to_string(photoStatus) + ",\"description\":\"test\"}";
+  }
+  return out;
+}
+
+// Until `done` or `simMs` simulated ms have passed
+template <class F> static bool waitFor(F done, unsigned long simMs) {
+  unsigned long start = millis();
+  while (!done()) {
+    if (millis() - start > simMs) return false;
+    delay(50);
+  }
+  return true;
+}
+
+static bool idle() {
+  return uploadQueueDepth() == 0;
+}
+
+int main() {
+  char dir[] = "/tmp/esp32cam-outbox-XXXXXX";
+  if (!mkdtemp(dir)) return 2;
+  setenv("HOST_SPIFFS_DIR", dir, 1);
+  CHECK(SPIFFS.begin(true));
+  std::vector<uint8_t> jpeg = readFixture("qvga_object.jpg");
+  CHECK(!jpeg.empty());
+
+  MockBotApi mock;
+  mock.handler = reply;
+  CHECK(mock.start());
+  simBotPort = mock.port();
+  hostSpeed = 20;
+  loadOutbox();
+  startTelegramTransport();
+  startUploadPipeline();
+
+  // Refused live upload: not parked
+  photoStatus = 400;
+  CHECK(enqueueUpload(jpeg.data(), jpeg.size(), "refused"));
+  CHECK(waitFor([] { return idle() && outboxStats.unsendable == 1; }, WAIT_MS));
+  CHECK(outboxDepth() == 0 && outboxStats.stored == 0);
+
+  // Server error: parked, then refused on the retry and dropped
+  photoStatus = 502;
+  CHECK(enqueueUpload(jpeg.data(), jpeg.size(), "server error"));
+  CHECK(waitFor([] { return idle() && outboxDepth() == 1; }, WAIT_MS));
+  photoStatus = 400;
+  CHECK(waitFor([] { return outboxDepth() == 0; }, OUTBOX_BACKOFF_MIN_MS * 2 + WAIT_MS));
+  CHECK(outboxStats.dropped == 1 && outboxStats.drained == 0);
+
+  // Fails on every retry: dropped after OUTBOX_MAX_ATTEMPTS. Parked at x20,
+  // then the backoffs run at x2000.
+  photoStatus = 503;
+  CHECK(enqueueUpload(jpeg.data(), jpeg.size(), "always 503"));
+  CHECK(waitFor([] { return outboxStats.stored == 2; }, WAIT_MS));
+  hostSpeed = 2000;
+  CHECK(waitFor([] { return outboxDepth() == 0; }, OUTBOX_BACKOFF_MAX_MS * (OUTBOX_MAX_ATTEMPTS + 2) * 4));
+  CHECK(outboxStats.dropped == 2 && outboxStats.attempts == 1 + OUTBOX_MAX_ATTEMPTS);
+  hostSpeed = 20;
+
+  // An album parked photo by photo, then a photo of its own: two captures sent
+  int sentBefore = sentCount;
+  unsigned photosBefore = mock.count("sendPhoto");
+  for (uint8_t i = 0; i < 3; i++) CHECK(outboxStore(jpeg.data(), jpeg.size(), "album", i, 3));
+  CHECK(outboxStore(jpeg.data(), jpeg.size(), "single"));
+  photoStatus = 200;
+  outboxKick();
+  xSemaphoreGive(uploadSignal);
+  CHECK(waitFor([] { return outboxDepth() == 0; }, WAIT_MS));
+  CHECK(mock.count("sendPhoto") == photosBefore + 4);
+  CHECK(sentCount == sentBefore + 2);
+  printf("outbox: %lu stored, %lu drained, %lu dropped, %lu refused live, %lu attempts\n",
+         (unsigned long)outboxStats.stored, (unsigned long)outboxStats.drained, (unsigned long)outboxStats.dropped,
+         (unsigned long)outboxStats.unsendable, (unsigned long)outboxStats.attempts);
+
+  fflush(stdout);
+  int rc = hostFailures();
+  _exit(rc);   // the upload task never returns
+}
@@ -0,0 +1,132 @@
+// getUpdates streaming parser: correctness on a recorded batch and throughput
+// on large generated ones.
+//
+//   parser_bench [payload.json ...]   also time the given recorded bodies
+//
+// fixtures/getupdates_mixed.json is a Bot API response with a command
+// addressed to the bot, a photo whose caption looks like a "text" key, an
+// edited message, a text longer than TG_TEXT_CAP, a my_chat_member update and
+// an inline keyboard with its own "text" fields. The batches are then fed in
+// the chunk sizes the socket produces, from 1 byte up, and must give the same
+// updates every time.
+
+#include <string.h>
+#include <string>
+#include "host_check.h"
+#include "telegram_update_parser.h"
+
+struct Collected {
+  std::vector<TelegramUpdate> updates;
+  static void add(const TelegramUpdate& u, void* ctx) { ((Collected*)ctx)->updates.push_back(u); }
+};
+
+static bool parse(const std::vector<uint8_t>& body, size_t chunk, Collected& out) {
+  static TelegramUpdateParser parser;
+  out.updates.clear();
+  parser.begin(&Collected::add, &out);
+  for (size_t i = 0; i < body.size(); i += chunk) {
+    size_t n = body.size() - i < chunk ? body.size() - i : chunk;
+    parser.feed(body.data() + i, n);
+  }
+  return parser.ok() && parser.updates() == out.updates.size();
+}
+
+static bool validUtf8(const char* s) {
+  const uint8_t* p = (const uint8_t*)s;
+  while (*p) {
+    int n = *p < 0x80 ? 0 : (*p & 0xE0) == 0xC0 ? 1 : (*p & 0xF0) == 0xE0 ? 2 : (*p & 0xF8) == 0xF0 ? 3 : -1;
+    if (n < 0) return false;
+    p++;
+    for (int i = 0; i < n; i++, p++) {
+      if ((*p & 0xC0) != 0x80) return false;
+    }
+  }
+  return true;
+}
+
+static void checkRecordedBatch() {
+  std::vector<uint8_t> body = readFixture("getupdates_mixed.json");
+  Collected c;
+  CHECK(parse(body, body.size(), c));
+  CHECK(c.updates.size() == 6);
+  if (c.updates.size() != 6) return;
+
+  const TelegramUpdate* u = c.updates.data();
+  CHECK(u[0].updateId == 734120001 && u[0].hasText && !strcmp(u[0].text, "/photo@esp32cam_bot"));
+  CHECK(!strcmp(u[0].username, "sara_k") && !strcmp(u[0].firstName, "Sara"));
+  CHECK(u[1].updateId == 734120002 && !u[1].hasText);          // photo: caption is not text
+  CHECK(!u[2].hasText);                                         // edited_message is ignored
+  CHECK(u[3].hasText && u[3].textTruncated && validUtf8(u[3].text));
+  CHECK(strlen(u[3].text) < TG_TEXT_CAP && !strcmp(u[3].firstName, "Reza") && !u[3].username[0]);
+  CHECK(!u[4].hasText);
+  CHECK(u[5].updateId == 734120006 && !strcmp(u[5].text, "/interval 15"));   // not the keyboard's "ok"
+
+  // Every chunking gives the same result
+  for (size_t chunk = 1; chunk <= 64; chunk++) {
+    Collected d;
+    bool ok = parse(body, chunk, d) && d.updates.size() == c.updates.size();
+    for (size_t i = 0; ok && i < d.updates.size(); i++) {
+      ok = d.updates[i].updateId == c.updates[i].updateId && !strcmp(d.updates[i].text, c.updates[i].text) &&
+           !strcmp(d.updates[i].username, c.updates[i].username);
+    }
+    if (!ok) printf("chunk %zu differs\n", chunk);
+    CHECK(ok);
+  }
+
+  // Cut short: never ok
+  std::vector<uint8_t> cut(body.begin(), body.begin() + body.size() - 3);
+  Collected e;
+  CHECK(!parse(cut, 512, e));
+}
+
+// "result" with `n` copies of the recorded photo update (renumbered)
+static std::vector<uint8_t> bigBatch(int n) {
+  std::vector<uint8_t> rec = readFixture("getupdates_mixed.json");
+  std::string all(rec.begin(), rec.end());
+  size_t a = all.find("{\"update_id\":734120002");
+  size_t b = all.find(",{\"update_id\":734120003");
+  std::string photo = all.substr(a, b - a);
+  std::string out = "{\"ok\":true,\"result\":[";
+  for (int i = 0; i < n; i++) {
+    std::string u = photo;
+    u.replace(u.find("734120002"), 9, std::to_string(800000000 + i));
+    if (i) out += ",";
+    out += u;
+  }
+  out += "]}";
+  return std::vector<uint8_t>(out.begin(), out.end());
+}
+
+static void timeParse(const char* name, const std::vector<uint8_t>& body) {
+  static const size_t chunks[] = { 64, 512, 4096 };   // 512: telegram_transport.h's read block
+  for (size_t chunk : chunks) {
+    Collected c;
+    int rounds = 0;
+    double t0 = hostNowUs(), dt;
+    bool ok = true;
+    do {
+      ok &= parse(body, chunk, c);
+      rounds++;
+      dt = hostNowUs() - t0;
+    } while (dt < 200000);
+    CHECK(ok);
+    double us = dt / rounds;
+    printf("%-22s %7zu B %4zu updates chunk %4zu: %8.1f us/body %6.1f MB/s %5.2f us/update\n", name, body.size(),
+           c.updates.size(), chunk, us, body.size() / us, c.updates.empty() ? 0.0 : us / c.updates.size());
+  }
+}
+
+int main(int argc, char** argv) {
+  printf("parser state: %zu bytes, independent of the body size\n", sizeof(TelegramUpdateParser));
+  checkRecordedBatch();
+
+  std::vector<uint8_t> big = bigBatch(100);        // TELEGRAM_POLL_BATCH is 20; a backlog after downtime
+  Collected c;
+  CHECK(parse(big, 512, c) && c.updates.size() == 100 && c.updates[99].updateId == 800000099);
+
+  timeParse("getupdates_mixed.json", readFixture("getupdates_mixed.json"));
+  timeParse("100 photo updates", big);
+  timeParse("500 photo updates", bigBatch(500));
+  for (int i = 1; i < argc; i++) timeParse(argv[i], readFixture(argv[i]));
+  return hostFailures();
+}
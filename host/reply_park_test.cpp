@@ -0,0 +1,85 @@
+// Telegram text replies while an upload holds the link.
+//
+// A request that holds telegramLink (a slow reply, as a 90 s album upload
+// would) must not stall sendTelegramMessage(): the reply is parked after
+// TELEGRAM_REPLY_WAIT_MS, later ones queue behind it without waiting, and
+// sendParkedReplies() sends them in order once the link is free.
+
+#include "sketch_harness.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+#include "host_check.h"
+#include "mock_bot_api.h"
+
+uint16_t simBotPort;
+
+#define HOLD_MS 800
+
+static std::mutex textsMutex;
+static std::vector<std::string> texts;   // sendMessage texts in arrival order
+
+static MockReply reply(const MockRequest& r) {
+  MockReply out = MockBotApi::defaultReply(r);
+  if (r.apiMethod == "getMe") {
+    out.tailDelayMs = HOLD_MS;
+  } else if (r.apiMethod == "sendMessage") {
+    const char* key = "name=\"text\"\r\n\r\n";
+    size_t from = r.body.find(key) + strlen(key);
+    std::lock_guard<std::mutex> lock(textsMutex);
+    texts.push_back(r.body.substr(from, r.body.find("\r\n--", from) - from));
+  }
+  return out;
+}
+
+static double msSince(double t0) {
+  return (hostNowUs() - t0) / 1000.0;
+}
+
+int main() {
+  MockBotApi mock;
+  mock.handler = reply;
+  CHECK(mock.start());
+  simBotPort = mock.port();
+  startTelegramTransport();
+
+  // Free link: sent at once
+  CHECK(sendTelegramMessage("direct") && replyStats.parked == 0);
+
+  // The link held as by an upload, read to the end of its slow reply
+  std::thread holder([] {
+    char path[96];
+    telegramPath(path, sizeof(path), "getMe");
+    TelegramResponse resp;
+    resp.stopAtResult = false;
+    telegramLink.request("GET", path, nullptr, nullptr, 0, resp);
+  });
+  while (!telegramLink.busy()) delay(1);
+
+  double t0 = hostNowUs();
+  CHECK(sendTelegramMessage("first"));
+  double first = msSince(t0);
+  t0 = hostNowUs();
+  CHECK(sendTelegramMessage("second"));
+  double second = msSince(t0);
+  t0 = hostNowUs();
+  sendParkedReplies();
+  double flushBusy = msSince(t0);
+  printf("link held %d ms: reply parked after %.1f ms, the next in %.2f ms, flush while busy %.2f ms\n",
+         HOLD_MS, first, second, flushBusy);
+  CHECK(first < TELEGRAM_REPLY_WAIT_MS * 4 && second < 5 && flushBusy < 5);
+  CHECK(replyStats.parked == 2 && mock.count("sendMessage") == 1);
+
+  holder.join();
+  sendParkedReplies();
+  CHECK(mock.count("sendMessage") == 3 && parkedBytes == 0);
+  {
+    std::lock_guard<std::mutex> lock(textsMutex);
+    CHECK(texts.size() == 3 && texts[1] == "first" && texts[2] == "second");
+  }
+  CHECK(sendTelegramMessage("after") && replyStats.parked == 2);
+
+  mock.stop();
+  return hostFailures();
+}
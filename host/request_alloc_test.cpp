@@ -0,0 +1,91 @@
+// Telegram request path: heap allocations per request, counted.
+//
+// The sketch's own sendPhotoBuffer() (with its FanoutSession and the
+// file_id fan-out to two more chats), postPhoto() and sendTelegramMessage()
+// are called against the mock Bot API over TelegramLink. Once the
+// keep-alive connection is up, none of them may allocate at all. The
+// String-concatenated framing the builder replaced is counted too, which
+// also proves the counter is live.
+
+#define TELEGRAM_FANOUT_CHATS "-100200, @archive"
+#include "sketch_harness.h"
+
+#include "host_check.h"
+#include "host_heap.h"
+#include "mock_bot_api.h"
+
+uint16_t simBotPort;
+
+static std::vector<uint8_t> jpeg;
+
+// The framing as it was built before: one String per part
+static size_t stringFraming(const char* caption) {
+  String boundary = "----ESP32CAM" + String(millis());
+  String part1 = "--" + boundary + "\r\n" "Content-Disposition: form-data; name=\"chat_id\"\r\n\r\n" +
+                 String(TELEGRAM_CHANNEL) + "\r\n";
+  String part2 = "--" + boundary + "\r\n" "Content-Disposition: form-data; name=\"caption\"\r\n\r\n"
+                 "ESP32-CAM: " + String(caption) + " | " + String("12:00:00") + "\r\n";
+  String part3 = "--" + boundary + "\r\n"
+                 "Content-Disposition: form-data; name=\"photo\"; filename=\"image.jpg\"\r\n"
+                 "Content-Type: image/jpeg\r\n\r\n";
+  String tail = "\r\n--" + boundary + "--\r\n";
+  size_t contentLength = part1.length() + part2.length() + part3.length() + jpeg.size() + tail.length();
+  String req = "POST /bot" + String(TELEGRAM_BOT_TOKEN) + "/sendPhoto HTTP/1.1\r\n"
+               "Host: " + String(TELEGRAM_HOST) + "\r\n"
+               "User-Agent: ESP32CAM\r\n"
+               "Connection: close\r\n"
+               "Content-Type: multipart/form-data; boundary=" + boundary + "\r\n"
+               "Content-Length: " + String((unsigned)contentLength) + "\r\n\r\n";
+  return req.length() + contentLength;
+}
+
+int main() {
+  jpeg = readFixture("qvga_object.jpg");
+  CHECK(!jpeg.empty());
+  MockBotApi mock;
+  CHECK(mock.start());
+  simBotPort = mock.port();
+  startTelegramTransport();
+  startTelegramFanout();
+  CHECK(fanoutChatCount() == 2);
+
+  // The first requests open the connection (the host socket object; on the
+  // device mbedTLS's buffers) and are not counted
+  CHECK(sendTelegramMessage("warm-up"));
+  CHECK(sendPhotoBuffer(jpeg.data(), jpeg.size(), "warm-up"));
+
+  static char longText[3000];
+  memset(longText, 'x', sizeof(longText) - 1);
+  const int rounds = 50;
+  uint32_t fannedBefore = fanoutStats.sent;
+  uint64_t before = hostThreadAllocs();
+  int ok = 0;
+  for (int i = 0; i < rounds; i++) {
+    ok += sendPhotoBuffer(jpeg.data(), jpeg.size(), "ESP32-CAM: Motion Detection | 12:00:00");
+    TelegramResponse resp;
+    size_t bytes = 0;
+    ok += postPhoto(TELEGRAM_CHANNEL, jpeg.data(), jpeg.size(), "ESP32-CAM: Manual | 12:00:00", resp, bytes) ==
+          200 && resp.ok();
+    ok += sendTelegramMessage(i & 1 ? longText : "📸 Photo sent");
+  }
+  uint64_t allocs = hostThreadAllocs() - before;
+  printf("%d requests on a kept-alive link (%d of them fan-out sends): %llu heap allocations\n", 5 * rounds,
+         2 * rounds, (unsigned long long)allocs);
+  CHECK(ok == 3 * rounds);
+  CHECK(fanoutStats.sent - fannedBefore == 2u * rounds && fanoutStats.fallbackUploads == 0);
+  CHECK(allocs == 0);
+  CHECK(mock.count("sendPhoto") == 3u + 4u * rounds);   // warm-up: upload + 2 fan-outs
+  CHECK(mock.count("sendMessage") == (unsigned)rounds + 1);
+  CHECK(mock.connections() == 1);
+
+  before = hostThreadAllocs();
+  size_t total = 0;
+  for (int i = 0; i < rounds; i++) total += stringFraming("Motion Detection");
+  allocs = hostThreadAllocs() - before;
+  printf("String framing (before): %.1f heap allocations per upload (%zu B)\n", (double)allocs / rounds,
+         total / rounds);
+  CHECK(allocs > 0);
+
+  mock.stop();
+  return hostFailures();
+}
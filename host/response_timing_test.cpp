@@ -0,0 +1,128 @@
+// Telegram response parsing: early return once the result is known.
+//
+// The mock Bot API sends {"ok":true at once and holds the rest of the body
+// back (TAIL_MS), as api.telegram.org does with a large result. A request
+// must come back without waiting for the tail, and the next request must
+// still go out on the same connection after the tail has been skipped. The
+// same reply read to the end (stopAtResult off) shows the dead wait that is
+// saved; chunked bodies, Connection: close and error replies are covered
+// too, and a dropped keep-alive socket is only re-sent to when nothing of
+// the reply had come back.
+
+#include "host_check.h"
+#include "link_harness.h"
+
+#define TAIL_MS 300
+
+static MockReply reply(int status, const char* body, bool chunked = false, bool close = false) {
+  MockReply r;
+  r.status = status;
+  r.body = body;
+  r.tailDelayMs = TAIL_MS;
+  r.chunked = chunked;
+  r.close = close;
+  return r;
+}
+
+static MockReply nextReply;
+static int cutNext = -1;   // MockReply::cutAt for the next request only
+
+// One sendMessage; returns the round trip in ms, -1 on a transport failure
+static double roundTrip(bool stopAtResult, TelegramResponse& resp) {
+  char path[96];
+  char framing[320];
+  MultipartBuilder body(framing, sizeof(framing));
+  body.field("chat_id", TELEGRAM_CHANNEL);
+  body.field("text", "📸 Photo sent");
+  telegramPath(path, sizeof(path), "sendMessage");
+  body.finish();
+  resp.stopAtResult = stopAtResult;
+  double t0 = hostNowUs();
+  int code = telegramLink.request("POST", path, body.contentType(), body.parts(), body.partCount(), resp);
+  return code > 0 ? (hostNowUs() - t0) / 1000.0 : -1;
+}
+
+static const char* okBody = "{\"ok\":true,\"result\":{\"message_id\":42,\"chat\":{\"id\":-1001234567890,"
+                            "\"title\":\"cam\",\"type\":\"channel\"},\"date\":1760000000,\"text\":\"Photo sent\"}}";
+
+int main() {
+  MockBotApi mock;
+  mock.handler = [](const MockRequest&) {
+    MockReply r = nextReply;
+    r.cutAt = cutNext;
+    cutNext = -1;
+    return r;
+  };
+  CHECK(mock.start());
+  mockPort = mock.port();
+  startTelegramTransport();
+  const TelegramLinkStats& st = telegramLink.linkStats();
+
+  // Content-Length body: result known after 10 bytes
+  nextReply = reply(200, okBody);
+  TelegramResponse a;
+  double early = roundTrip(true, a);
+  printf("early return:  %6.1f ms (tail held back %d ms)\n", early, TAIL_MS);
+  CHECK(a.ok() && early >= 0 && early < TAIL_MS / 2);
+  CHECK(st.earlyReturns == 1);
+
+  // Idle gap as between two uploads: the tail arrives, the next request
+  // skips it and reuses the socket
+  delay(TAIL_MS + 100);
+  TelegramResponse b;
+  double full = roundTrip(false, b);
+  printf("read to end:   %6.1f ms\n", full);
+  CHECK(b.ok() && full >= TAIL_MS * 0.9);
+  CHECK(b.bodyTotal == strlen(okBody));
+  CHECK(st.skippedBytes == strlen(okBody) - 10);
+  CHECK(mock.connections() == 1 && st.reused == 1);
+  printf("saved per request: %.1f ms\n", full - early);
+
+  // Chunked: same early return, tail skipped through the chunk framing
+  nextReply = reply(200, okBody, true);
+  TelegramResponse c;
+  double chunked = roundTrip(true, c);
+  printf("chunked early: %6.1f ms\n", chunked);
+  CHECK(c.ok() && chunked >= 0 && chunked < TAIL_MS / 2);
+  nextReply = reply(200, "{\"ok\":true,\"result\":true}");
+  TelegramResponse d;
+  CHECK(roundTrip(true, d) >= 0 && d.ok());
+  CHECK(mock.connections() == 1);
+
+  // Error: read to the end so the description is kept
+  nextReply = reply(400, "{\"ok\":false,\"error_code\":400,\"description\":\"Bad Request: chat not found\"}");
+  TelegramResponse e;
+  double err = roundTrip(true, e);
+  CHECK(e.status == 400 && !e.ok() && strstr(e.body, "chat not found") && err >= TAIL_MS * 0.9);
+
+  // Connection: close: early return, then a fresh connection
+  nextReply = reply(200, okBody, false, true);
+  TelegramResponse f;
+  CHECK(roundTrip(true, f) >= 0 && f.ok());
+  nextReply = reply(200, okBody);
+  TelegramResponse g;
+  CHECK(roundTrip(true, g) >= 0 && g.ok());
+  CHECK(mock.connections() == 2);
+  CHECK(st.retries == 0 && st.connectFailures == 0);
+
+  // A kept-alive socket hung up before a byte of the reply (the server
+  // timed it out while idle): re-sent once, on a fresh connection
+  nextReply = reply(200, okBody);
+  nextReply.tailDelayMs = 0;
+  unsigned sent = mock.count("sendMessage");
+  cutNext = 0;
+  TelegramResponse h;
+  CHECK(roundTrip(true, h) >= 0 && h.ok());
+  CHECK(st.retries == 1 && mock.count("sendMessage") == sent + 2);
+
+  // Hung up once the reply had started: the server has the message, so it
+  // is not sent a second time
+  sent = mock.count("sendMessage");
+  cutNext = 20;
+  TelegramResponse i;
+  CHECK(roundTrip(true, i) < 0);
+  CHECK(st.retries == 1 && mock.count("sendMessage") == sent + 1);
+
+  mock.stop();
+  return hostFailures();
+}
@@ -0,0 +1,124 @@
+// Settings store (settings_store.h): flash cost per save, recovery.
+//
+// Drives the sketch's own loadSettings() / saveSettings() on the host SPIFFS
+// and EEPROM stand-ins. A device with the legacy EEPROM struct is migrated,
+// then a day of throttled saves is replayed and the bytes written and the
+// estimated sector erases per save are compared with the EEPROM rewrite
+// (one commit, one sector erase, per save). A torn tail, an append cut
+// short by a full flash and a compaction that fails must all come back
+// with nothing lost.
+
+#include "sketch_harness.h"
+
+#include <unistd.h>
+#include "host_check.h"
+
+uint16_t simBotPort;
+
+static size_t logSize() {
+  File f = SPIFFS.open(STORE_FILE, "r");
+  return f ? f.size() : 0;
+}
+
+// A reboot: RAM state gone, settings read back from flash
+static void reboot() {
+  capturedCount = sentCount = 0;
+  timeInterval = 0;
+  loadSettings();
+}
+
+int main() {
+  char dir[] = "/tmp/esp32cam-store-XXXXXX";
+  if (!mkdtemp(dir)) return 2;
+  setenv("HOST_SPIFFS_DIR", dir, 1);
+  CHECK(SPIFFS.begin(true));
+  EEPROM.begin(EEPROM_SIZE);
+
+  // Legacy device: everything in the EEPROM struct, migrated on first boot
+  Persisted p;
+  memset(&p, 0, sizeof(p));
+  p.magic = PERSIST_MAGIC;
+  p.mode = 1;
+  p.motionEn = 1;
+  p.intervalMin = 7;
+  p.threshold = 6000;
+  p.captured = 120;
+  p.sent = 118;
+  EEPROM.put(0, p);
+  EEPROM.commit();
+  loadSettings();
+  CHECK(storeStats.migrated && captureMode == 1 && timeInterval == 7 && capturedCount == 120 && sentCount == 118);
+
+  // A day of throttled saves: the counters move every time, a setting now and then
+  const int saves = 1000;
+  uint64_t fsBefore = hostFs.bytesWritten;
+  uint32_t commitsBefore = EEPROM.commits;
+  for (int i = 0; i < saves; i++) {
+    capturedCount++;
+    if (i % 2 == 0) sentCount++;
+    if (i % 250 == 0) timeInterval = 5 + i / 250;
+    saveSettings();
+    settingsStoreTick();
+  }
+  double bytesPerSave = (double)(hostFs.bytesWritten - fsBefore) / saves;
+  double erasesPerSave = bytesPerSave / STORE_FLASH_SECTOR;
+  printf("%d saves: %.1f B written per save (compactions included), %u compactions, "
+         "log %u B\n", saves, bytesPerSave, (unsigned)storeStats.compactions, (unsigned)storeBytes);
+  printf("estimated sector erases per save: %.4f (EEPROM struct: 1, %d B rewritten)\n", erasesPerSave,
+         STORE_FLASH_SECTOR);
+  CHECK(EEPROM.commits == commitsBefore);
+  CHECK(storeStats.compactions > 1 && storeBytes < STORE_COMPACT_BYTES + 64);
+  CHECK(erasesPerSave < 0.02);
+  CHECK(storeBytes == logSize());
+
+  int captured = capturedCount, sent = sentCount, interval = timeInterval;
+  reboot();
+  CHECK(capturedCount == captured && sentCount == sent && timeInterval == interval && captureMode == 1);
+
+  // Torn tail: reset in the middle of a record
+  File f = SPIFFS.open(STORE_FILE, "a");
+  const uint8_t half[5] = { STORE_MAGIC, STORE_SCHEMA_VERSION, STORE_KEY_COUNTER_DELTA, 8, 0 };
+  f.write(half, sizeof(half));
+  f.close();
+  reboot();
+  CHECK(storeStats.tornTails == 1 && capturedCount == captured && sentCount == sent);
+  CHECK(storeBytes == logSize());
+
+  // Flash full in the middle of an append: the torn record is compacted
+  // away, so the appends after it are read back
+  hostFs.writeBudget = 6;
+  capturedCount++;
+  saveSettings();
+  hostFs.writeBudget = -1;
+  CHECK(storeStats.failedWrites == 1 && storeCompactPending);
+  CHECK(storeBytes == logSize());
+  capturedCount++;
+  saveSettings();
+  settingsStoreTick();
+  CHECK(!storeCompactPending);
+  reboot();
+  CHECK(capturedCount == captured + 2 && storeStats.tornTails == 1);
+
+  // Compaction fails too: the old log stays, the retry waits
+  hostFs.writeBudget = 0;
+  capturedCount++;
+  saveSettings();
+  uint32_t compactions = storeStats.compactions;
+  settingsStoreTick();
+  hostFs.writeBudget = -1;
+  CHECK(storeCompactPending && storeStats.compactions == compactions && storeBytes == logSize());
+  CHECK(!SPIFFS.exists(STORE_TMP));
+  settingsStoreTick();
+  CHECK(storeCompactPending);
+  hostSpeed = 1000;
+  delay(STORE_COMPACT_RETRY_MS + 1000);
+  settingsStoreTick();
+  CHECK(!storeCompactPending && storeStats.compactions == compactions + 1);
+  saveSettings();   // the next throttled save brings the counters up to date
+  reboot();
+  CHECK(capturedCount == captured + 3 && sentCount == sent);
+
+  SPIFFS.remove(STORE_FILE);
+  rmdir(dir);
+  return hostFailures();
+}
@@ -0,0 +1,281 @@
+// Host simulation: the whole sketch, replaying a camera trace against the
+// mock Bot API, and a report of what it cost.
+//
+//   sim TRACE [--mode motion|time|mixed] [--minutes N] [--speed X]
+//             [--interval MIN] [--dedup N] [--soak MIN]
+//
+// setup() and loop() run unchanged (ESP32CAM-Telegram.ino is compiled into
+// this file) on the stand-ins in host/stubs: FreeRTOS tasks are threads,
+// SPIFFS is a fresh temporary directory, the camera returns the trace's
+// frames (esp_camera.h), and api.telegram.org is MockBotApi on loopback. The
+// mode and interval are set the way a user sets them: commands arrive
+// through the getUpdates long poll. Simulated time runs `speed` times faster
+// than the wall clock; the stage costs are real host microseconds.
+//
+// Reported: per-stage latency from metrics.h (count, avg, p50, p95, max),
+// the heap high-water mark from the allocation counter, and photos uploaded
+// per simulated minute. The sketch's tasks are real threads, so how many
+// photos a run yields moves with host load; what is checked is that every
+// capture is accounted for once the run has wound down: nothing failed,
+// nothing left in the outbox, each capture sent (or dropped by the queue)
+// exactly once, and one Bot API upload request per photo counted as sent.
+//
+// A run longer than the trace starts the trace over. --soak samples the
+// device heap model (host_heap.h) every MIN simulated minutes: free
+// internal heap, largest free block and heapFragmentationPct() as /metrics
+// reports them. After a warm-up tenth of the run, the last quarter must
+// not have a smaller largest block or more fragmentation than the first
+// quarter, beyond SIM_SOAK_BLOCK_SLACK / SIM_SOAK_FRAG_SLACK. Three days:
+//   sim TRACE --mode mixed --minutes 4320 --speed 1000 --soak 60
+
+#include "sketch_harness.h"
+
+#include <dirent.h>
+#include <deque>
+#include <string>
+#include <vector>
+#include "host_check.h"
+#include "host_heap.h"
+#include "mock_bot_api.h"
+
+uint16_t simBotPort;
+
+#define SIM_SOAK_BLOCK_SLACK 2048   // bytes the largest free block may lose over the run
+#define SIM_SOAK_FRAG_SLACK 5       // fragmentation points it may gain
+
+struct SoakSample {
+  double minutes;
+  uint32_t freeHeap;
+  uint32_t largest;
+  uint8_t fragPct;
+};
+
+static MockBotApi simBot;
+static std::mutex simMutex;
+static std::deque<std::string> simCommands;   // next getUpdates results
+static long simUpdateId = 900000000;
+static unsigned simPhotos = 0;
+static std::atomic<bool> simStopping(false);
+
+static void simSendCommand(const std::string& text) {
+  HostHeapExempt exempt;
+  std::lock_guard<std::mutex> lock(simMutex);
+  simCommands.push_back(text);
+}
+
+static std::string simUpdate(long id, const std::string& text) {
+  return "{\"update_id\":" + std::to_string(id) + ",\"message\":{\"message_id\":" + std::to_string(id % 100000) +
+         ",\"from\":{\"id\":1001,\"is_bot\":false,\"first_name\":\"Sim\",\"username\":\"sim\"},"
+         "\"chat\":{\"id\":1001,\"type\":\"private\"},\"date\":" + std::to_string(time(nullptr)) +
+         ",\"text\":\"" + text + "\"}}";
+}
+
+static size_t countOf(const std::string& s, const char* what) {
+  size_t n = 0;
+  for (size_t i = s.find(what); i != std::string::npos; i = s.find(what, i + 1)) n++;
+  return n;
+}
+
+static MockReply simReply(const MockRequest& r) {
+  if (r.apiMethod == "getUpdates") {
+    // Long poll: hold until a command is queued or the timeout passes
+    size_t t = r.path.find("timeout=");
+    unsigned long holdMs = t == std::string::npos ? 0 : strtoul(r.path.c_str() + t + 8, nullptr, 10) * 1000;
+    unsigned long start = millis();
+    for (;;) {
+      {
+        std::lock_guard<std::mutex> lock(simMutex);
+        if (!simCommands.empty()) {
+          std::string body = "{\"ok\":true,\"result\":[";
+          for (size_t i = 0; !simCommands.empty(); i++) {
+            if (i) body += ",";
+            body += simUpdate(++simUpdateId, simCommands.front());
+            simCommands.pop_front();
+          }
+          MockReply reply;
+          reply.body = body + "]}";
+          return reply;
+        }
+      }
+      if (simStopping || millis() - start >= holdMs) break;
+      delay(50);
+    }
+  } else if (r.apiMethod == "sendPhoto" || r.apiMethod == "sendMediaGroup") {
+    std::lock_guard<std::mutex> lock(simMutex);
+    simPhotos += countOf(r.body, "filename=\"");
+  }
+  return MockBotApi::defaultReply(r);
+}
+
+static void printStages() {
+  printf("%-15s %7s %10s %10s %10s %10s\n", "stage", "count", "avg us", "p50 us", "p95 us", "max us");
+  for (uint8_t s = 0; s < MET_STAGE_COUNT; s++) {
+    MetricHistogram h;
+    metricSnapshot((MetricStage)s, h);
+    if (!h.count) continue;
+    // Percentiles are histogram bucket bounds; never report one above the max
+    unsigned long p50 = min((unsigned long)metricPercentileUs(h, 50), (unsigned long)h.maxUs);
+    unsigned long p95 = min((unsigned long)metricPercentileUs(h, 95), (unsigned long)h.maxUs);
+    printf("%-15s %7lu %10lu %10lu %10lu %10lu\n", metricStageNames[s], (unsigned long)h.count,
+           (unsigned long)(h.sumUs / h.count), p50, p95, (unsigned long)h.maxUs);
+  }
+}
+
+// Worst largest block and fragmentation over samples [from, to)
+static void soakWorst(const std::vector<SoakSample>& v, size_t from, size_t to, uint32_t& largest, uint8_t& frag) {
+  largest = UINT32_MAX;
+  frag = 0;
+  for (size_t i = from; i < to; i++) {
+    largest = min(largest, v[i].largest);
+    frag = max(frag, v[i].fragPct);
+  }
+}
+
+static void checkSoak(const std::vector<SoakSample>& v) {
+  printf("%9s %12s %14s %7s\n", "minute", "free heap", "largest block", "frag %");
+  size_t step = v.size() > 48 ? (v.size() + 47) / 48 : 1;
+  for (size_t i = 0; i < v.size(); i++) {
+    if (i % step && i + 1 != v.size()) continue;
+    printf("%9.0f %12lu %14lu %7u\n", v[i].minutes, (unsigned long)v[i].freeHeap, (unsigned long)v[i].largest,
+           (unsigned)v[i].fragPct);
+  }
+  size_t warm = v.size() / 10;
+  size_t quarter = (v.size() - warm) / 4;
+  if (quarter == 0) {
+    printf("soak: too few samples to compare\n");
+    CHECK(false);
+    return;
+  }
+  uint32_t earlyLargest, lateLargest;
+  uint8_t earlyFrag, lateFrag;
+  soakWorst(v, warm, warm + quarter, earlyLargest, earlyFrag);
+  soakWorst(v, v.size() - quarter, v.size(), lateLargest, lateFrag);
+  printf("soak: largest block %lu -> %lu B, fragmentation %u -> %u %% (first vs last quarter after warm-up)\n",
+         (unsigned long)earlyLargest, (unsigned long)lateLargest, (unsigned)earlyFrag, (unsigned)lateFrag);
+  CHECK(lateLargest + SIM_SOAK_BLOCK_SLACK >= earlyLargest);
+  CHECK(lateFrag <= earlyFrag + SIM_SOAK_FRAG_SLACK);
+}
+
+static void removeDir(const std::string& dir) {
+  DIR* d = opendir(dir.c_str());
+  if (!d) return;
+  while (dirent* e = readdir(d)) {
+    if (e->d_name[0] != '.') ::remove((dir + "/" + e->d_name).c_str());
+  }
+  closedir(d);
+  rmdir(dir.c_str());
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    printf("usage: sim TRACE [--mode motion|time|mixed] [--minutes N] [--speed X] [--interval MIN]\n"
+           "           [--dedup N] [--soak MIN]\n");
+    return 2;
+  }
+  const char* tracePath = argv[1];
+  int mode = 0;
+  double minutes = 0;
+  int interval = 1;
+  int dedup = -1;
+  double soakMin = 0;
+  hostSpeed = 20;
+  for (int i = 2; i + 1 < argc; i += 2) {
+    std::string opt = argv[i];
+    const char* v = argv[i + 1];
+    if (opt == "--mode") mode = !strcmp(v, "time") ? 1 : !strcmp(v, "mixed") ? 2 : 0;
+    else if (opt == "--minutes") minutes = atof(v);
+    else if (opt == "--speed") hostSpeed = atof(v);
+    else if (opt == "--interval") interval = atoi(v);
+    else if (opt == "--dedup") dedup = atoi(v);
+    else if (opt == "--soak") soakMin = atof(v);
+  }
+  if (!hostCameraLoadTrace(tracePath)) {
+    printf("cannot load trace %s\n", tracePath);
+    return 2;
+  }
+  if (minutes <= 0) minutes = hostCameraTraceEndMs() / 60000.0;
+  hostCameraLoopTrace(minutes * 60000 > hostCameraTraceEndMs());
+
+  char dir[] = "/tmp/esp32cam-sim-XXXXXX";
+  if (!mkdtemp(dir)) return 2;
+  setenv("HOST_SPIFFS_DIR", dir, 1);
+  simBot.handler = simReply;
+  if (!simBot.start()) return 2;
+  simBotPort = simBot.port();
+
+  setup();
+  simSendCommand("/mode " + std::to_string(mode));
+  if (mode != 0) simSendCommand("/interval " + std::to_string(interval));
+  if (dedup >= 0) simSendCommand("/dedup " + std::to_string(dedup));
+
+  unsigned long start = millis();
+  double wall0 = hostNowUs();
+  unsigned long runMs = (unsigned long)(minutes * 60000);
+  unsigned long soakMs = (unsigned long)(soakMin * 60000);
+  std::vector<SoakSample> soak;
+  if (soakMs) {
+    HostHeapExempt exempt;
+    soak.reserve(runMs / soakMs + 1);
+  }
+  unsigned long nextSample = start + soakMs;
+  while (millis() - start < runMs) {
+    loop();
+    if (soakMs && (long)(millis() - nextSample) >= 0) {
+      nextSample += soakMs;
+      soak.push_back({ (millis() - start) / 60000.0, ESP.getFreeHeap(), ESP.getMaxAllocHeap(),
+                       heapFragmentationPct() });
+    }
+  }
+  double wallS = (hostNowUs() - wall0) / 1e6;
+
+  // Wind down without loop(): no new captures, an open motion event closes
+  // on its post-event timeout, and the upload task empties the queue
+  unsigned long stop = millis();
+  for (;;) {
+    bool open = false;
+    for (int e = 0; e < PREBUFFER_EVENTS; e++) open = open || (preEvents[e].used && preEvents[e].open);
+    if (!open && uploadQueueDepth() == 0 && outboxDepth() == 0) break;
+    if (millis() - stop > PREBUFFER_POST_TIMEOUT_MS + 120000UL) break;
+    prebufferTick();
+    delay(50);
+  }
+  simStopping = true;
+
+  HostHeapStats heap = hostHeapStats();
+  unsigned photos;
+  {
+    std::lock_guard<std::mutex> lock(simMutex);
+    photos = simPhotos;
+  }
+  const char* modeName[] = { "motion", "time", "mixed" };
+  printf("\n==== %s mode, %.1f simulated min in %.1f s (x%.0f), trace %s ====\n", modeName[mode], minutes, wallS,
+         hostSpeed, tracePath);
+  printf("photos uploaded %u (%.2f/min) in %u sendPhoto + %u sendMediaGroup; %u messages; %u getUpdates\n",
+         photos, photos / minutes, simBot.count("sendPhoto"), simBot.count("sendMediaGroup"),
+         simBot.count("sendMessage"), simBot.count("getUpdates"));
+  printf("captured %d, sent %d, motion events %lu, scheduled %lu (suppressed %lu), dedup skipped %lu\n",
+         capturedCount, sentCount, (unsigned long)preStats.events, (unsigned long)schedStats.fired,
+         (unsigned long)schedStats.suppressed, (unsigned long)dedupStats.suppressed);
+  printf("camera: %lu grabs, %lu at the wrong size, %lu with both buffers held\n", (unsigned long)hostCamera.grabs,
+         (unsigned long)hostCamera.wrongSize, (unsigned long)hostCamera.busy);
+  printf("heap: peak %.1f KB, %.1f KB in use at the end, %llu allocations\n", heap.peak / 1024.0,
+         heap.inUse / 1024.0, (unsigned long long)heap.allocs);
+  printf("device heap model: internal %.1f KB free (lowest %.1f KB), largest block %.1f KB; PSRAM %.1f KB free, "
+         "largest block %.1f KB; %llu allocation(s) not placed\n", heap.internalFree / 1024.0,
+         heap.internalMinFree / 1024.0, heap.internalLargest / 1024.0, heap.psramFree / 1024.0,
+         heap.psramLargest / 1024.0, (unsigned long long)heap.unplaced);
+  printStages();
+  if (soakMs) checkSoak(soak);
+
+  CHECK(uploadFailed == 0 && uploadQueueDepth() == 0 && outboxDepth() == 0);
+  CHECK(capturedCount > 0 && capturedCount == sentCount + (int)uploadDropped);
+  CHECK(simBot.count("sendPhoto") + simBot.count("sendMediaGroup") == (unsigned)sentCount);
+  CHECK(hostCamera.wrongSize == 0);
+  if (mode != 1) CHECK(preStats.events > 0);
+  if (mode != 0) CHECK(schedStats.fired > 0);
+  int rc = hostFailures();
+  removeDir(dir);
+  fflush(stdout);
+  // Sketch tasks never return; leave without running static destructors under them
+  _exit(rc);
+}
@@ -0,0 +1,42 @@
+// config.h for the host simulation (host/sim.cpp)
+#ifndef CONFIG_H
+#define CONFIG_H
+
+const char* SSID = "host";
+const char* PASSWORD = "host";
+
+const char* TELEGRAM_BOT_TOKEN = "123456:HOST-SIM";
+const char* TELEGRAM_CHANNEL = "@host_sim";
+// The mock Bot API (host/mock_bot_api.h) listens on an ephemeral loopback port
+extern uint16_t simBotPort;
+#define TELEGRAM_HOST "127.0.0.1"
+#define TELEGRAM_PORT simBotPort
+#define TELEGRAM_OFFSET_FILE "/tg_offset.txt"
+#define TELEGRAM_POLL_INTERVAL 3000
+
+#define PWDN_GPIO_NUM     32
+#define RESET_GPIO_NUM    -1
+#define XCLK_GPIO_NUM      0
+#define SIOD_GPIO_NUM     26
+#define SIOC_GPIO_NUM     27
+#define Y9_GPIO_NUM       35
+#define Y8_GPIO_NUM       34
+#define Y7_GPIO_NUM       39
+#define Y6_GPIO_NUM       36
+#define Y5_GPIO_NUM       21
+#define Y4_GPIO_NUM       19
+#define Y3_GPIO_NUM       18
+#define Y2_GPIO_NUM        5
+#define VSYNC_GPIO_NUM    25
+#define HREF_GPIO_NUM     23
+#define PCLK_GPIO_NUM     22
+
+#define EEPROM_SIZE 128
+#define EEPROM_MODE 0
+#define EEPROM_INTERVAL 1
+#define EEPROM_MOTION_ENABLED 2
+#define EEPROM_THRESHOLD 3
+#define EEPROM_CAPTURED_COUNT 4
+#define EEPROM_SENT_COUNT 8
+
+#endif
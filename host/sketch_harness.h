@@ -0,0 +1,15 @@
+#ifndef SKETCH_HARNESS_H
+#define SKETCH_HARNESS_H
+
+// ------------ The whole sketch on the host stubs ------------
+// ESP32CAM-Telegram.ino compiled into the including file with the host
+// config (host/sim/config.h: Telegram aimed at simBotPort on loopback).
+// The includer defines simBotPort. Nothing runs until it calls setup() or
+// the sketch's own functions.
+
+#include <Arduino.h>
+#include "sim/config.h"
+static void setupTimeTehran();   // the Arduino IDE generates this prototype
+#include "ESP32CAM-Telegram.ino"
+
+#endif
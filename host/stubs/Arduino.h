@@ -0,0 +1,234 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// ------------ Arduino core stand-in for the host build ------------
+// Enough of the ESP32 Arduino core for the sketch's headers to compile and
+// run on Linux. millis() is simulated time (hostSpeed times faster than the
+// wall clock, so a traced hour replays in minutes); micros() stays real, so
+// every cost the sketch measures with a micros() pair is a real host cost.
+// delay() and vTaskDelay() sleep the scaled time. Heap figures come from the
+// allocation counter in host_runtime.cpp.
+
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <functional>
+#include <string>
+
+#define PROGMEM
+#define IRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
+#define F(x) x
+typedef bool boolean;
+typedef uint8_t byte;
+
+extern double hostSpeed;          // simulated ms per wall-clock ms
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+long random(long max);
+long random(long min, long max);
+bool psramFound();
+void* ps_malloc(size_t n);
+void* ps_calloc(size_t n, size_t size);
+void* ps_realloc(void* p, size_t n);
+
+// As in the ESP32 core: the std templates, not the classic macros
+using std::min;
+using std::max;
+
+class String {
+ public:
+  std::string s;
+  String() {}
+  String(const char* c) : s(c ? c : "") {}
+  String(const String& o) = default;
+  String& operator=(const String&) = default;
+  explicit String(char c) : s(1, c) {}
+  explicit String(int v) : s(std::to_string(v)) {}
+  explicit String(unsigned v) : s(std::to_string(v)) {}
+  explicit String(long v) : s(std::to_string(v)) {}
+  explicit String(unsigned long v) : s(std::to_string(v)) {}
+  explicit String(long long v) : s(std::to_string(v)) {}
+  explicit String(unsigned long long v) : s(std::to_string(v)) {}
+  explicit String(double v, unsigned d = 2) {
+    char b[32];
+    snprintf(b, sizeof(b), "%.*f", (int)d, v);
+    s = b;
+  }
+  explicit String(int v, unsigned char base) {
+    char b[40];
+    snprintf(b, sizeof(b), base == 16 ? "%x" : "%d", v);
+    s = b;
+  }
+  unsigned length() const { return s.size(); }
+  const char* c_str() const { return s.c_str(); }
+  bool isEmpty() const { return s.empty(); }
+  int indexOf(char c, unsigned from = 0) const { return find(s.find(c, from)); }
+  int indexOf(const char* c, unsigned from = 0) const { return find(s.find(c, from)); }
+  int indexOf(const String& c, unsigned from = 0) const { return find(s.find(c.s, from)); }
+  int lastIndexOf(char c) const { return find(s.rfind(c)); }
+  String substring(unsigned a) const { return a < s.size() ? String(s.substr(a).c_str()) : String(); }
+  String substring(unsigned a, unsigned b) const {
+    if (b > s.size()) b = s.size();
+    return a < b ? String(s.substr(a, b - a).c_str()) : String();
+  }
+  long toInt() const { return atol(s.c_str()); }
+  float toFloat() const { return (float)atof(s.c_str()); }
+  void trim() {
+    size_t a = 0, b = s.size();
+    while (a < b && isspace((unsigned char)s[a])) a++;
+    while (b > a && isspace((unsigned char)s[b - 1])) b--;
+    s = s.substr(a, b - a);
+  }
+  void toLowerCase() { for (auto& c : s) c = (char)tolower((unsigned char)c); }
+  void toUpperCase() { for (auto& c : s) c = (char)toupper((unsigned char)c); }
+  bool startsWith(const String& p) const { return s.compare(0, p.s.size(), p.s) == 0; }
+  bool endsWith(const String& p) const {
+    return s.size() >= p.s.size() && s.compare(s.size() - p.s.size(), p.s.size(), p.s) == 0;
+  }
+  void remove(unsigned i) { if (i < s.size()) s.erase(i); }
+  void remove(unsigned i, unsigned n) { if (i < s.size()) s.erase(i, n); }
+  bool reserve(unsigned n) { s.reserve(n); return true; }
+  bool concat(const String& o) { s += o.s; return true; }
+  bool concat(char c) { s += c; return true; }
+  bool concat(const char* c, unsigned n) { s.append(c, n); return true; }
+  String& operator+=(const String& o) { s += o.s; return *this; }
+  String& operator+=(const char* o) { s += o; return *this; }
+  String& operator+=(char c) { s += c; return *this; }
+  String& operator+=(int v) { s += std::to_string(v); return *this; }
+  String& operator+=(unsigned v) { s += std::to_string(v); return *this; }
+  String& operator+=(long v) { s += std::to_string(v); return *this; }
+  String& operator+=(unsigned long v) { s += std::to_string(v); return *this; }
+  bool operator==(const String& o) const { return s == o.s; }
+  bool operator==(const char* o) const { return s == o; }
+  bool operator!=(const String& o) const { return s != o.s; }
+  bool operator!=(const char* o) const { return s != o; }
+  char operator[](unsigned i) const { return i < s.size() ? s[i] : 0; }
+  char charAt(unsigned i) const { return i < s.size() ? s[i] : 0; }
+  void toCharArray(char* b, unsigned n) const {
+    if (!n) return;
+    strncpy(b, s.c_str(), n - 1);
+    b[n - 1] = 0;
+  }
+  void replace(const String& from, const String& to) {
+    if (from.s.empty()) return;
+    for (size_t i = s.find(from.s); i != std::string::npos; i = s.find(from.s, i + to.s.size())) {
+      s.replace(i, from.s.size(), to.s);
+    }
+  }
+
+ private:
+  static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+};
+inline String operator+(const String& a, const String& b) { String r(a); r.s += b.s; return r; }
+inline String operator+(const String& a, const char* b) { String r(a); r.s += b; return r; }
+inline String operator+(const char* a, const String& b) { String r(a); r.s += b.s; return r; }
+inline String operator+(const String& a, char b) { String r(a); r.s += b; return r; }
+inline String operator+(const String& a, int b) { String r(a); r.s += std::to_string(b); return r; }
+inline String operator+(const String& a, unsigned b) { String r(a); r.s += std::to_string(b); return r; }
+inline String operator+(const String& a, long b) { String r(a); r.s += std::to_string(b); return r; }
+inline String operator+(const String& a, unsigned long b) { String r(a); r.s += std::to_string(b); return r; }
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* b, size_t n) {
+    size_t k = 0;
+    while (k < n && write(b[k])) k++;
+    return k;
+  }
+  size_t write(const char* b, size_t n) { return write((const uint8_t*)b, n); }
+  size_t write(const char* b) { return write((const uint8_t*)b, strlen(b)); }
+  size_t print(const String& v) { return write(v.c_str()); }
+  size_t print(const char* v) { return write(v); }
+  size_t print(char v) { return write((uint8_t)v); }
+  size_t print(int v) { return printf("%d", v); }
+  size_t print(unsigned v) { return printf("%u", v); }
+  size_t print(long v) { return printf("%ld", v); }
+  size_t print(unsigned long v) { return printf("%lu", v); }
+  size_t print(double v) { return printf("%.2f", v); }
+  size_t println() { return write("\r\n"); }
+  template <class T> size_t println(const T& v) { return print(v) + println(); }
+  size_t printf(const char* f, ...) __attribute__((format(printf, 2, 3))) {
+    char b[512];
+    va_list ap;
+    va_start(ap, f);
+    int n = vsnprintf(b, sizeof(b), f, ap);
+    va_end(ap);
+    if (n < 0) return 0;
+    return write((const uint8_t*)b, (size_t)n < sizeof(b) ? (size_t)n : sizeof(b) - 1);
+  }
+};
+
+class Stream : public Print {
+ public:
+  virtual int available() { return 0; }
+  virtual int read() { return -1; }
+  virtual int peek() { return -1; }
+  virtual void flush() {}
+  size_t readBytes(uint8_t* b, size_t n) {
+    size_t k = 0;
+    int c;
+    while (k < n && (c = read()) >= 0) b[k++] = (uint8_t)c;
+    return k;
+  }
+  size_t readBytes(char* b, size_t n) { return readBytes((uint8_t*)b, n); }
+  String readString() {
+    String r;
+    int c;
+    while ((c = read()) >= 0) r += (char)c;
+    return r;
+  }
+  String readStringUntil(char end) {
+    String r;
+    int c;
+    while ((c = read()) >= 0 && c != end) r += (char)c;
+    return r;
+  }
+  void setTimeout(unsigned long ms) { timeoutMs = ms; }
+
+ protected:
+  unsigned long timeoutMs = 1000;
+};
+
+// stdout; HOST_QUIET=1 in the environment drops the sketch's chatter
+class HardwareSerial : public Stream {
+ public:
+  void begin(unsigned long) {}
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* b, size_t n) override;
+};
+extern HardwareSerial Serial;
+
+class EspClass {
+ public:
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+  uint32_t getFreePsram();
+  uint32_t getPsramSize();
+  uint32_t getMinFreePsram();
+  uint32_t getMaxAllocPsram();
+  void restart();
+  uint32_t getCycleCount();     // 240 MHz cycles derived from the real clock
+};
+extern EspClass ESP;
+
+#include "freertos_stub.h"
+#include "esp_system.h"
+
+void configTzTime(const char* tz, const char* s1, const char* s2 = nullptr, const char* s3 = nullptr);
+bool getLocalTime(struct tm* info, uint32_t ms = 5000);
+
+#endif
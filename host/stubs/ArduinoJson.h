@@ -0,0 +1,101 @@
+#ifndef HOST_ARDUINOJSON_H
+#define HOST_ARDUINOJSON_H
+
+// ------------ ArduinoJson stand-in ------------
+// Inert: the host build never serves /status or /debug, so documents accept
+// every assignment, read back as empty and serialize to nothing. The real
+// library is not vendored; this only has to compile the stats code paths.
+
+#include <Arduino.h>
+
+// As ArduinoJson 6 on a 32-bit target: 16 bytes per slot
+#define JSON_ARRAY_SIZE(n) ((n) * 16)
+#define JSON_OBJECT_SIZE(n) ((n) * 16)
+
+class JsonArray;
+class JsonObject;
+
+class JsonVariant {
+ public:
+  JsonVariant operator[](const char*) const { return JsonVariant(); }
+  JsonVariant operator[](const String&) const { return JsonVariant(); }
+  JsonVariant operator[](int) const { return JsonVariant(); }
+  template <class T> JsonVariant& operator=(const T&) { return *this; }
+  template <class T> operator T() const { return T(); }
+  template <class T> T as() const { return T(); }
+  template <class T> bool is() const { return false; }
+  bool isNull() const { return true; }
+  bool containsKey(const char*) const { return false; }
+  size_t size() const { return 0; }
+  template <class T> bool set(const T&) { return true; }
+  template <class T> bool add(const T&) { return true; }
+  JsonObject createNestedObject(const char* key = nullptr);
+  JsonArray createNestedArray(const char* key = nullptr);
+  template <class T> bool operator==(const T&) const { return false; }
+  template <class T> bool operator!=(const T&) const { return false; }
+};
+
+class JsonString {
+ public:
+  const char* c_str() const { return ""; }
+};
+
+class JsonPair {
+ public:
+  JsonString key() const { return JsonString(); }
+  JsonVariant value() const { return JsonVariant(); }
+};
+
+class JsonObject : public JsonVariant {
+ public:
+  JsonPair* begin() const { return nullptr; }
+  JsonPair* end() const { return nullptr; }
+};
+
+class JsonArray : public JsonVariant {
+ public:
+  JsonObject* begin() const { return nullptr; }
+  JsonObject* end() const { return nullptr; }
+  JsonObject createNestedObject();
+  template <class T> bool add(const T&) { return true; }
+};
+
+inline JsonObject JsonVariant::createNestedObject(const char*) { return JsonObject(); }
+inline JsonArray JsonVariant::createNestedArray(const char*) { return JsonArray(); }
+inline JsonObject JsonArray::createNestedObject() { return JsonObject(); }
+
+class JsonDocument : public JsonVariant {
+ public:
+  void clear() {}
+  bool overflowed() const { return false; }
+  size_t memoryUsage() const { return 0; }
+  size_t capacity() const { return 0; }
+  template <class T> T to() { return T(); }
+};
+template <size_t N> class StaticJsonDocument : public JsonDocument {};
+class DynamicJsonDocument : public JsonDocument {
+ public:
+  explicit DynamicJsonDocument(size_t) {}
+};
+
+class DeserializationError {
+ public:
+  enum Code { Ok };
+  explicit operator bool() const { return false; }
+  const char* c_str() const { return "Ok"; }
+  bool operator==(Code) const { return true; }
+};
+
+template <class D, class S> DeserializationError deserializeJson(D&, const S&) { return DeserializationError(); }
+template <class D> DeserializationError deserializeJson(D&, const char*, size_t) { return DeserializationError(); }
+template <class D> size_t serializeJson(const D&, String&) { return 0; }
+template <class D> size_t serializeJson(const D&, char* out, size_t n) {
+  if (n) out[0] = 0;
+  return 0;
+}
+template <class D> size_t serializeJson(const D&, Print&) { return 0; }
+template <class D> size_t serializeJsonPretty(const D&, Print&) { return 0; }
+template <class D> size_t measureJson(const D&) { return 0; }
+template <class D> size_t measureJsonPretty(const D&) { return 0; }
+
+#endif
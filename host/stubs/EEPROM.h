@@ -0,0 +1,43 @@
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+// ------------ EEPROM stand-in: RAM only, commits counted ------------
+// Starts erased (0xFF) each run, i.e. a device that never had the legacy
+// settings. Each commit() is counted: on the device it rewrites the whole
+// emulated EEPROM in flash.
+
+#include <Arduino.h>
+#include <vector>
+
+class EEPROMClass {
+ public:
+  uint32_t commits = 0;
+
+  bool begin(size_t size) {
+    data.assign(size, 0xFF);
+    return true;
+  }
+  uint8_t read(int addr) { return addr >= 0 && (size_t)addr < data.size() ? data[addr] : 0; }
+  void write(int addr, uint8_t v) {
+    if (addr >= 0 && (size_t)addr < data.size()) data[addr] = v;
+  }
+  template <class T> T& get(int addr, T& t) {
+    if (addr >= 0 && addr + sizeof(T) <= data.size()) memcpy(&t, &data[addr], sizeof(T));
+    return t;
+  }
+  template <class T> const T& put(int addr, const T& t) {
+    if (addr >= 0 && addr + sizeof(T) <= data.size()) memcpy(&data[addr], &t, sizeof(T));
+    return t;
+  }
+  bool commit() {
+    commits++;
+    return true;
+  }
+  void end() {}
+
+ private:
+  std::vector<uint8_t> data;
+};
+extern EEPROMClass EEPROM;
+
+#endif
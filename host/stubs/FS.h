@@ -0,0 +1,78 @@
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+// ------------ FS stand-in: SPIFFS files in a host directory ------------
+// Flat like SPIFFS ("/name" -> <dir>/name); opening "/" lists it. Reads and
+// writes go to real files, so a run leaves the log, journal and outbox on
+// disk to inspect. hostFs counts what was written and can cut writes short
+// to simulate a full or failing flash. Implemented in host_devices.cpp.
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+
+struct HostFsStats {
+  uint64_t bytesWritten = 0;
+  uint32_t writes = 0;           // File::write() calls
+  uint32_t failedWrites = 0;     // cut short by writeBudget
+  long writeBudget = -1;         // bytes left before writes fail; -1 = unlimited
+};
+extern HostFsStats hostFs;
+
+namespace fs {
+
+enum SeekMode { SeekSet, SeekCur, SeekEnd };
+
+class File : public Stream {
+ public:
+  File() {}
+  operator bool() const { return (bool)impl; }
+
+  using Print::write;
+  size_t write(const uint8_t* b, size_t n) override;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t read(uint8_t* b, size_t n);
+  int read() override {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+  }
+  int peek() override;
+  int available() override;
+  void flush() override;
+  bool seek(uint32_t pos, SeekMode mode = SeekSet);
+  size_t position() const;
+  size_t size() const;
+  void close();
+  const char* name() const;
+  const char* path() const;
+  bool isDirectory() const;
+  File openNextFile();
+
+  struct Impl;
+  std::shared_ptr<Impl> impl;
+};
+
+class FS {
+ public:
+  File open(const char* path, const char* mode = "r", bool create = false);
+  File open(const String& path, const char* mode = "r", bool create = false) {
+    return open(path.c_str(), mode, create);
+  }
+  bool exists(const char* path);
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path);
+  bool remove(const String& path) { return remove(path.c_str()); }
+  bool rename(const char* from, const char* to);
+  bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+
+ protected:
+  std::string root;     // host directory, no trailing '/'
+  std::string hostPath(const char* path) const;
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
+
+#endif
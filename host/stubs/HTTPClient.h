@@ -0,0 +1,9 @@
+#ifndef HOST_HTTP_CLIENT_H
+#define HOST_HTTP_CLIENT_H
+
+// Included by the sketch but not used: every Bot API call goes through
+// TelegramLink
+
+#include <WiFiClientSecure.h>
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef HOST_SPIFFS_H
+#define HOST_SPIFFS_H
+
+#include <FS.h>
+
+// The directory is $HOST_SPIFFS_DIR, else ./spiffs (created by begin())
+#ifndef HOST_SPIFFS_TOTAL
+#define HOST_SPIFFS_TOTAL 1374476u     // default partition table, as SPIFFS reports it
+#endif
+
+class SPIFFSFS : public fs::FS {
+ public:
+  bool begin(bool formatOnFail = false);
+  size_t totalBytes() { return HOST_SPIFFS_TOTAL; }
+  size_t usedBytes();
+};
+extern SPIFFSFS SPIFFS;
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef HOST_WEB_SERVER_H
+#define HOST_WEB_SERVER_H
+
+// ------------ WebServer stand-in ------------
+// No sockets: a host test queues a request with hostRequest() from its own
+// thread, and the next handleClient() (the sketch's web task, or loop()
+// with WEB_SERVER_TASK 0) runs the matching route, one request per call as
+// the real server does. Only the status code comes back; bodies are
+// dropped. The simulator never sends any, so for it routes are registered
+// and never called.
+
+#include <WiFi.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+typedef enum { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS } HTTPMethod;
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+
+class WebServer {
+ public:
+  typedef std::function<void(void)> THandlerFunction;
+
+  explicit WebServer(int) {}
+  void on(const String& uri, HTTPMethod method, THandlerFunction fn) { routes.push_back({ uri.c_str(), method, fn }); }
+  void on(const String& uri, THandlerFunction fn) { on(uri, HTTP_ANY, fn); }
+  void onNotFound(THandlerFunction fn) { notFound = fn; }
+  void begin() {}
+
+  void handleClient() {
+    Pending* p;
+    {
+      std::lock_guard<std::mutex> lock(m);
+      if (queue.empty()) return;
+      p = queue.front();
+      queue.pop_front();
+    }
+    cur = p;
+    std::string path = p->uri.substr(0, p->uri.find('?'));
+    const Route* route = nullptr;
+    for (const Route& r : routes) {
+      if (r.path == path && (r.method == HTTP_ANY || r.method == p->method)) {
+        route = &r;
+        break;
+      }
+    }
+    if (route) route->fn();
+    else if (notFound) notFound();
+    else send(404);
+    cur = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(m);
+      p->done = true;
+    }
+    cv.notify_all();
+  }
+
+  // Host only: queue a request and wait until it is served. Returns the
+  // status sent (0: not served within timeoutMs of simulated time).
+  int hostRequest(HTTPMethod method, const char* uri, const char* body = "", unsigned long timeoutMs = 30000) {
+    Pending p;
+    p.method = method;
+    p.uri = uri;
+    p.body = body;
+    std::unique_lock<std::mutex> lock(m);
+    queue.push_back(&p);
+    unsigned long start = millis();
+    while (!p.done) {
+      if (millis() - start >= timeoutMs) {
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+          if (*it == &p) {
+            queue.erase(it);
+            return 0;
+          }
+        }
+      }
+      cv.wait_for(lock, std::chrono::milliseconds(5));
+    }
+    return p.status;
+  }
+
+  void send(int code, const char*, const String&) { reply(code); }
+  void send(int code, const char*, const char*) { reply(code); }
+  void send(int code, const String&, const String&) { reply(code); }
+  void send(int code) { reply(code); }
+  void send_P(int code, const char*, const char*, size_t) { reply(code); }
+  void send_P(int code, const char*, const char*) { reply(code); }
+  void sendHeader(const String&, const String&, bool = false) {}
+  void setContentLength(size_t) {}
+  void sendContent(const String&) {}
+  void sendContent(const char*, size_t) {}
+  void sendContent_P(const char*, size_t) {}
+  String arg(const String& name) {
+    if (!cur) return String();
+    if (name == "plain") return String(cur->body.c_str());
+    std::string value;
+    return queryArg(name.c_str(), value) ? String(value.c_str()) : String();
+  }
+  bool hasArg(const String& name) {
+    std::string value;
+    return cur && (name == "plain" ? !cur->body.empty() : queryArg(name.c_str(), value));
+  }
+  String header(const String&) { return String(); }
+  bool hasHeader(const String&) { return false; }
+  void collectHeaders(const char**, size_t) {}
+  WiFiClient& client() { return none; }
+  String uri() { return cur ? String(cur->uri.substr(0, cur->uri.find('?')).c_str()) : String(); }
+  HTTPMethod method() { return cur ? cur->method : HTTP_GET; }
+
+ private:
+  struct Route {
+    std::string path;
+    HTTPMethod method;
+    THandlerFunction fn;
+  };
+  struct Pending {
+    HTTPMethod method;
+    std::string uri;
+    std::string body;
+    int status = 0;
+    bool done = false;
+  };
+
+  std::vector<Route> routes;
+  THandlerFunction notFound;
+  std::mutex m;
+  std::condition_variable cv;
+  std::deque<Pending*> queue;
+  Pending* cur = nullptr;   // being served (handleClient()'s thread only)
+  WiFiClient none;
+
+  void reply(int code) {
+    if (cur && !cur->status) cur->status = code;
+  }
+
+  bool queryArg(const char* name, std::string& value) const {
+    size_t q = cur->uri.find('?');
+    if (q == std::string::npos) return false;
+    std::string query = "&" + cur->uri.substr(q + 1);
+    std::string key = std::string("&") + name + "=";
+    size_t at = query.find(key);
+    if (at == std::string::npos) return false;
+    at += key.size();
+    value = query.substr(at, query.find('&', at) - at);
+    return true;
+  }
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+// ------------ WiFi stand-in ------------
+// The station is always connected. WiFiClient is a plain TCP socket (copies
+// share it, as on the device); connect() resolves numeric IPv4 and
+// "localhost", which is all the host tests and the mock Bot API need.
+
+#include <Arduino.h>
+#include <memory>
+
+class IPAddress {
+ public:
+  IPAddress(uint32_t a = 0) : addr(a) {}
+  String toString() const {
+    char b[16];
+    snprintf(b, sizeof(b), "%u.%u.%u.%u", addr & 255, (addr >> 8) & 255, (addr >> 16) & 255, addr >> 24);
+    return String(b);
+  }
+  uint8_t operator[](int i) const { return (uint8_t)(addr >> (8 * i)); }
+
+ private:
+  uint32_t addr;   // network order, first octet in the low byte
+};
+
+typedef enum { WL_IDLE_STATUS, WL_CONNECTED = 3, WL_DISCONNECTED = 6 } wl_status_t;
+#define WIFI_STA 1
+
+class WiFiClass {
+ public:
+  void mode(int) {}
+  void begin(const char*, const char*) {}
+  wl_status_t status() { return WL_CONNECTED; }
+  IPAddress localIP() { return IPAddress(0x0100007F); }
+  int RSSI() { return -55; }
+  void setSleep(bool) {}
+  bool reconnect() { return true; }
+};
+extern WiFiClass WiFi;
+
+class WiFiClient : public Stream {
+ public:
+  WiFiClient() {}
+  explicit WiFiClient(int fd);      // takes over an accepted socket
+
+  int connect(const char* host, uint16_t port);
+  int connect(const char* host, uint16_t port, int32_t) { return connect(host, port); }
+  uint8_t connected();
+  void stop();
+  int fd() const { return sock ? sock->fd : -1; }
+  int setNoDelay(bool on);
+  operator bool() { return connected(); }
+  IPAddress remoteIP() const;
+  uint16_t remotePort() const { return 0; }
+
+  using Print::write;
+  size_t write(const uint8_t* b, size_t n) override;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  int available() override;
+  int read() override {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+  }
+  int read(uint8_t* b, size_t n);
+  void setTimeout(uint32_t ms) { timeoutMs = ms; }
+
+ private:
+  struct Socket {
+    int fd = -1;
+    bool peerClosed = false;
+    ~Socket();
+  };
+  std::shared_ptr<Socket> sock;
+};
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef HOST_WIFI_CLIENT_SECURE_H
+#define HOST_WIFI_CLIENT_SECURE_H
+
+// No TLS on the host: the mock Bot API speaks plain HTTP on loopback, so
+// "handshakes" cost a TCP connect only.
+
+#include <WiFi.h>
+
+class WiFiClientSecure : public WiFiClient {
+ public:
+  void setInsecure() {}
+  void setHandshakeTimeout(unsigned long) {}
+  int lastError(char* buf, size_t n) {
+    if (n) buf[0] = 0;
+    return 0;
+  }
+};
+
+#endif
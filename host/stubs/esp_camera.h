@@ -0,0 +1,94 @@
+#ifndef HOST_ESP_CAMERA_H
+#define HOST_ESP_CAMERA_H
+
+// ------------ Camera stand-in: frames from a recorded trace ------------
+// A trace is a text file; each line is a time in ms and one or more JPEG
+// files (paths relative to the trace), e.g.
+//   0      vga_base.jpg   svga_base.jpg
+//   60000  vga_object.jpg svga_object.jpg
+// From that time on the camera sees that scene, in whichever of the files
+// has the width of the sensor's current frame size (the first one if none
+// does). Time 0 is esp_camera_init(). Implemented in host_devices.cpp.
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+typedef enum { LEDC_CHANNEL_0 } ledc_channel_t;
+typedef enum { LEDC_TIMER_0 } ledc_timer_t;
+typedef enum { PIXFORMAT_RGB565, PIXFORMAT_YUV422, PIXFORMAT_GRAYSCALE, PIXFORMAT_JPEG } pixformat_t;
+typedef enum {
+  FRAMESIZE_96X96, FRAMESIZE_QQVGA, FRAMESIZE_QCIF, FRAMESIZE_HQVGA, FRAMESIZE_240X240, FRAMESIZE_QVGA,
+  FRAMESIZE_CIF, FRAMESIZE_HVGA, FRAMESIZE_VGA, FRAMESIZE_SVGA, FRAMESIZE_XGA, FRAMESIZE_HD, FRAMESIZE_SXGA,
+  FRAMESIZE_UXGA, FRAMESIZE_INVALID
+} framesize_t;
+typedef enum { CAMERA_GRAB_WHEN_EMPTY, CAMERA_GRAB_LATEST } camera_grab_mode_t;
+typedef enum { CAMERA_FB_IN_PSRAM, CAMERA_FB_IN_DRAM } camera_fb_location_t;
+
+typedef struct {
+  int pin_pwdn, pin_reset, pin_xclk, pin_sccb_sda, pin_sccb_scl;
+  int pin_d7, pin_d6, pin_d5, pin_d4, pin_d3, pin_d2, pin_d1, pin_d0, pin_vsync, pin_href, pin_pclk;
+  int xclk_freq_hz;
+  ledc_timer_t ledc_timer;
+  ledc_channel_t ledc_channel;
+  pixformat_t pixel_format;
+  framesize_t frame_size;
+  int jpeg_quality;
+  size_t fb_count;
+  camera_fb_location_t fb_location;
+  camera_grab_mode_t grab_mode;
+} camera_config_t;
+
+typedef struct {
+  uint8_t* buf;
+  size_t len;
+  size_t width;
+  size_t height;
+  pixformat_t format;
+  struct {
+    long tv_sec;
+    long tv_usec;
+  } timestamp;
+} camera_fb_t;
+
+typedef struct {
+  framesize_t framesize;
+  int quality;
+} camera_status_t;
+
+typedef struct _sensor sensor_t;
+struct _sensor {
+  camera_status_t status;
+  pixformat_t pixformat;
+  int (*set_framesize)(sensor_t*, framesize_t);
+  int (*set_quality)(sensor_t*, int);
+  int (*set_pixformat)(sensor_t*, pixformat_t);
+};
+
+typedef struct {
+  uint16_t width;
+  uint16_t height;
+  int aspect_ratio;
+} resolution_info_t;
+extern const resolution_info_t resolution[];
+
+esp_err_t esp_camera_init(const camera_config_t* config);
+camera_fb_t* esp_camera_fb_get();
+void esp_camera_fb_return(camera_fb_t* fb);
+sensor_t* esp_camera_sensor_get();
+
+// Host only
+bool hostCameraLoadTrace(const char* path);
+unsigned long hostCameraTraceEndMs();   // time of the last line
+void hostCameraLoopTrace(bool on);       // start over at the last line (runs longer than the trace)
+struct HostCameraStats {
+  uint32_t grabs = 0;
+  uint32_t busy = 0;          // both frame buffers held by the sketch
+  uint32_t wrongSize = 0;     // no file with the sensor's width
+};
+extern HostCameraStats hostCamera;
+
+#endif
@@ -0,0 +1,357 @@
+// ------------ Host devices: SPIFFS directory, EEPROM, trace camera ------------
+// Definitions behind FS.h, SPIFFS.h, EEPROM.h and esp_camera.h.
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <SPIFFS.h>
+#include "esp_camera.h"
+#include "host_heap.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+// ---- FS ----
+
+HostFsStats hostFs;
+SPIFFSFS SPIFFS;
+EEPROMClass EEPROM;
+
+struct fs::File::Impl {
+  FILE* fp = nullptr;
+  std::string hostPath;
+  std::string path;                  // "/name"
+  bool dir = false;
+  std::vector<std::string> entries;  // directory listing
+  size_t next = 0;
+  const FS* owner = nullptr;
+  ~Impl() {
+    if (fp) fclose(fp);
+  }
+};
+
+std::string fs::FS::hostPath(const char* path) const {
+  return root + (path[0] == '/' ? "" : "/") + path;
+}
+
+fs::File fs::FS::open(const char* path, const char* mode, bool) {
+  File f;
+  std::string hp = hostPath(path);
+  struct stat st;
+  if (!strcmp(path, "/") || (stat(hp.c_str(), &st) == 0 && S_ISDIR(st.st_mode))) {
+    DIR* d = opendir(hp.c_str());
+    if (!d) return f;
+    f.impl = std::make_shared<File::Impl>();
+    f.impl->dir = true;
+    f.impl->hostPath = hp;
+    f.impl->path = path;
+    f.impl->owner = this;
+    while (dirent* e = readdir(d)) {
+      if (e->d_name[0] != '.') f.impl->entries.push_back(e->d_name);
+    }
+    closedir(d);
+    return f;
+  }
+  const char* m = mode[0] == 'w' ? "wb" : mode[0] == 'a' ? "ab" : "rb";
+  FILE* fp = fopen(hp.c_str(), m);
+  if (!fp) return f;
+  f.impl = std::make_shared<File::Impl>();
+  f.impl->fp = fp;
+  f.impl->hostPath = hp;
+  f.impl->path = path[0] == '/' ? path : std::string("/") + path;
+  return f;
+}
+
+bool fs::FS::exists(const char* path) {
+  return access(hostPath(path).c_str(), F_OK) == 0;
+}
+
+bool fs::FS::remove(const char* path) {
+  return ::remove(hostPath(path).c_str()) == 0;
+}
+
+bool fs::FS::rename(const char* from, const char* to) {
+  return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+size_t fs::File::write(const uint8_t* b, size_t n) {
+  if (!impl || !impl->fp) return 0;
+  hostFs.writes++;
+  size_t allowed = n;
+  if (hostFs.writeBudget >= 0 && (long)n > hostFs.writeBudget) {
+    allowed = (size_t)hostFs.writeBudget;
+    hostFs.failedWrites++;
+  }
+  size_t w = fwrite(b, 1, allowed, impl->fp);
+  hostFs.bytesWritten += w;
+  if (hostFs.writeBudget >= 0) hostFs.writeBudget -= (long)w;
+  return w;
+}
+
+size_t fs::File::read(uint8_t* b, size_t n) {
+  return impl && impl->fp ? fread(b, 1, n, impl->fp) : 0;
+}
+
+int fs::File::peek() {
+  if (!impl || !impl->fp) return -1;
+  int c = fgetc(impl->fp);
+  if (c != EOF) ungetc(c, impl->fp);
+  return c == EOF ? -1 : c;
+}
+
+int fs::File::available() {
+  return impl && impl->fp ? (int)(size() - position()) : 0;
+}
+
+void fs::File::flush() {
+  if (impl && impl->fp) fflush(impl->fp);
+}
+
+bool fs::File::seek(uint32_t pos, SeekMode mode) {
+  if (!impl || !impl->fp) return false;
+  int whence = mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END;
+  return fseek(impl->fp, (long)pos, whence) == 0;
+}
+
+size_t fs::File::position() const {
+  return impl && impl->fp ? (size_t)ftell(impl->fp) : 0;
+}
+
+size_t fs::File::size() const {
+  if (!impl || !impl->fp) return 0;
+  fflush(impl->fp);
+  struct stat st;
+  return fstat(fileno(impl->fp), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void fs::File::close() {
+  impl.reset();
+}
+
+// As arduino-esp32 2.x: name() without the leading '/'
+const char* fs::File::name() const {
+  return impl ? impl->path.c_str() + (impl->path[0] == '/' ? 1 : 0) : "";
+}
+
+const char* fs::File::path() const {
+  return impl ? impl->path.c_str() : "";
+}
+
+bool fs::File::isDirectory() const {
+  return impl && impl->dir;
+}
+
+fs::File fs::File::openNextFile() {
+  File f;
+  if (!impl || !impl->dir) return f;
+  while (impl->next < impl->entries.size()) {
+    std::string p = "/" + impl->entries[impl->next++];
+    f = const_cast<FS*>(impl->owner)->open(p.c_str(), "r");
+    if (f) return f;
+  }
+  return f;
+}
+
+bool SPIFFSFS::begin(bool) {
+  const char* dir = getenv("HOST_SPIFFS_DIR");
+  root = dir && dir[0] ? dir : "spiffs";
+  if (root.size() > 1 && root.back() == '/') root.pop_back();
+  mkdir(root.c_str(), 0755);
+  return access(root.c_str(), W_OK) == 0;
+}
+
+size_t SPIFFSFS::usedBytes() {
+  size_t used = 0;
+  DIR* d = opendir(root.c_str());
+  if (!d) return 0;
+  while (dirent* e = readdir(d)) {
+    struct stat st;
+    if (e->d_name[0] != '.' && stat((root + "/" + e->d_name).c_str(), &st) == 0) used += (size_t)st.st_size;
+  }
+  closedir(d);
+  return used;
+}
+
+// ---- camera ----
+
+const resolution_info_t resolution[] = {
+  { 96, 96, 0 },    { 160, 120, 0 },  { 176, 144, 0 },  { 240, 176, 0 },   { 240, 240, 0 },
+  { 320, 240, 0 },  { 400, 296, 0 },  { 480, 320, 0 },  { 640, 480, 0 },   { 800, 600, 0 },
+  { 1024, 768, 0 }, { 1280, 720, 0 }, { 1280, 1024, 0 }, { 1600, 1200, 0 }, { 0, 0, 0 },
+};
+
+HostCameraStats hostCamera;
+
+struct TraceFrame {
+  std::vector<uint8_t> jpeg;
+  uint16_t width = 0;
+  uint16_t height = 0;
+};
+
+struct TraceStep {
+  unsigned long atMs;
+  std::vector<const TraceFrame*> frames;
+};
+
+static std::map<std::string, TraceFrame> traceFiles;
+static std::vector<TraceStep> trace;
+static unsigned long traceStartMs = 0;
+static bool traceLoop = false;
+static std::mutex cameraMutexHost;
+static camera_fb_t fbPool[2];
+static bool fbHeld[2];
+static size_t fbCap = 0;
+static sensor_t sensor;
+
+// Width and height from the SOF marker
+static bool jpegSize(const std::vector<uint8_t>& j, uint16_t& w, uint16_t& h) {
+  size_t i = 2;
+  while (i + 9 < j.size()) {
+    if (j[i] != 0xFF) return false;
+    uint8_t m = j[i + 1];
+    size_t len = (j[i + 2] << 8) | j[i + 3];
+    if (m >= 0xC0 && m <= 0xC2) {
+      h = (uint16_t)((j[i + 5] << 8) | j[i + 6]);
+      w = (uint16_t)((j[i + 7] << 8) | j[i + 8]);
+      return true;
+    }
+    i += 2 + len;
+  }
+  return false;
+}
+
+bool hostCameraLoadTrace(const char* path) {
+  HostHeapExempt exempt;   // the sensor's scenes, not the sketch's heap
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  std::string dir = path;
+  size_t slash = dir.rfind('/');
+  dir = slash == std::string::npos ? "" : dir.substr(0, slash + 1);
+
+  char line[1024];
+  while (fgets(line, sizeof(line), f)) {
+    char* save = nullptr;
+    char* tok = strtok_r(line, " \t\r\n", &save);
+    if (!tok || tok[0] == '#') continue;
+    TraceStep step;
+    step.atMs = strtoul(tok, nullptr, 10);
+    while ((tok = strtok_r(nullptr, " \t\r\n", &save))) {
+      std::string file = dir + tok;
+      auto it = traceFiles.find(file);
+      if (it == traceFiles.end()) {
+        TraceFrame fr;
+        FILE* jf = fopen(file.c_str(), "rb");
+        if (!jf) {
+          printf("trace: cannot open %s\n", file.c_str());
+          fclose(f);
+          return false;
+        }
+        uint8_t buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), jf)) > 0) fr.jpeg.insert(fr.jpeg.end(), buf, buf + n);
+        fclose(jf);
+        jpegSize(fr.jpeg, fr.width, fr.height);
+        if (fr.jpeg.size() > fbCap) fbCap = fr.jpeg.size();
+        it = traceFiles.insert(std::make_pair(file, fr)).first;
+      }
+      step.frames.push_back(&it->second);
+    }
+    if (!step.frames.empty()) trace.push_back(step);
+  }
+  fclose(f);
+  return !trace.empty();
+}
+
+unsigned long hostCameraTraceEndMs() {
+  return trace.empty() ? 0 : trace.back().atMs;
+}
+
+void hostCameraLoopTrace(bool on) {
+  traceLoop = on;
+}
+
+static int setFramesize(sensor_t* s, framesize_t size) {
+  s->status.framesize = size;
+  return 0;
+}
+
+static int setQuality(sensor_t* s, int q) {
+  s->status.quality = q;
+  return 0;
+}
+
+static int setPixformat(sensor_t* s, pixformat_t f) {
+  s->pixformat = f;
+  return 0;
+}
+
+// Frame buffers are allocated here, once, like the driver's DMA buffers
+esp_err_t esp_camera_init(const camera_config_t* config) {
+  if (trace.empty()) return ESP_FAIL;
+  sensor.status.framesize = config->frame_size;
+  sensor.status.quality = config->jpeg_quality;
+  sensor.pixformat = config->pixel_format;
+  sensor.set_framesize = setFramesize;
+  sensor.set_quality = setQuality;
+  sensor.set_pixformat = setPixformat;
+  for (camera_fb_t& fb : fbPool) fb.buf = (uint8_t*)ps_malloc(fbCap);
+  traceStartMs = millis();
+  return ESP_OK;
+}
+
+camera_fb_t* esp_camera_fb_get() {
+  std::lock_guard<std::mutex> lock(cameraMutexHost);
+  if (trace.empty() || !fbPool[0].buf) return nullptr;
+  int slot = !fbHeld[0] ? 0 : !fbHeld[1] ? 1 : -1;
+  if (slot < 0) {
+    hostCamera.busy++;
+    return nullptr;
+  }
+
+  unsigned long t = millis() - traceStartMs;
+  if (traceLoop && trace.back().atMs) t %= trace.back().atMs;
+  size_t i = 0;
+  while (i + 1 < trace.size() && trace[i + 1].atMs <= t) i++;
+  const TraceStep& step = trace[i];
+  const TraceFrame* fr = step.frames[0];
+  uint16_t want = resolution[sensor.status.framesize].width;
+  bool found = false;
+  for (const TraceFrame* c : step.frames) {
+    if (c->width == want) {
+      fr = c;
+      found = true;
+      break;
+    }
+  }
+  if (!found) hostCamera.wrongSize++;
+
+  camera_fb_t* fb = &fbPool[slot];
+  memcpy(fb->buf, fr->jpeg.data(), fr->jpeg.size());
+  fb->len = fr->jpeg.size();
+  fb->width = fr->width;
+  fb->height = fr->height;
+  fb->format = PIXFORMAT_JPEG;
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  fb->timestamp.tv_sec = tv.tv_sec;
+  fb->timestamp.tv_usec = tv.tv_usec;
+  fbHeld[slot] = true;
+  hostCamera.grabs++;
+  return fb;
+}
+
+void esp_camera_fb_return(camera_fb_t* fb) {
+  std::lock_guard<std::mutex> lock(cameraMutexHost);
+  for (int i = 0; i < 2; i++) {
+    if (fb == &fbPool[i]) fbHeld[i] = false;
+  }
+}
+
+sensor_t* esp_camera_sensor_get() {
+  return fbPool[0].buf ? &sensor : nullptr;
+}
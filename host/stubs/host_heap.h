@@ -0,0 +1,61 @@
+#ifndef HOST_HEAP_H
+#define HOST_HEAP_H
+
+// ------------ Heap accounting for the host build ------------
+// Every malloc/calloc/realloc/free and new/delete made by code linked with
+// host_runtime.cpp is counted (the link wraps the libc entry points), so a
+// test can assert that a path allocates nothing and the simulator can
+// report the heap high-water mark.
+//
+// Each allocation is also placed in a model of the device heap: internal
+// RAM and PSRAM as two address ranges with a best-fit allocator that only
+// keeps the books (the memory itself still comes from libc). Small
+// allocations go to internal RAM, larger ones (and ps_malloc) to PSRAM,
+// as with CONFIG_SPIRAM_USE_MALLOC; task stacks are taken from internal
+// RAM for the life of the task. ESP.getFreeHeap(), getMaxAllocHeap() (the
+// largest free block) and the PSRAM getters read the model, so
+// fragmentation shows up on the host as it would on the device.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef HOST_HEAP_INTERNAL
+#define HOST_HEAP_INTERNAL (200u * 1024u)   // internal heap left to the sketch once WiFi is up
+#endif
+#ifndef HOST_HEAP_PSRAM
+#define HOST_HEAP_PSRAM (4u * 1024u * 1024u)
+#endif
+#ifndef HOST_HEAP_PSRAM_ABOVE
+#define HOST_HEAP_PSRAM_ABOVE 4096          // CONFIG_SPIRAM_MALLOC_ALWAYSINTERNAL
+#endif
+
+struct HostHeapStats {
+  uint64_t allocs;       // malloc/calloc/realloc/new calls since start
+  uint64_t frees;
+  int64_t inUse;         // bytes currently allocated
+  int64_t peak;          // high-water mark of inUse since the last reset
+  uint32_t internalFree;       // device model
+  uint32_t internalLargest;
+  uint32_t internalMinFree;
+  uint32_t psramFree;
+  uint32_t psramLargest;
+  uint64_t unplaced;     // allocations the model had no block for (still served by libc)
+};
+
+HostHeapStats hostHeapStats();
+void hostHeapResetPeak();
+uint64_t hostThreadAllocs();   // allocations made by the calling thread only
+
+// While one is alive, the calling thread's allocations are counted but kept
+// out of the device model: test scaffolding such as the mock Bot API and
+// trace loading, which the device does not run
+class HostHeapExempt {
+ public:
+  HostHeapExempt();
+  ~HostHeapExempt();
+
+ private:
+  bool was;
+};
+
+#endif
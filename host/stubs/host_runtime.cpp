@@ -0,0 +1,734 @@
+// ------------ Host runtime: clock, Serial, heap accounting, sockets, FreeRTOS ------------
+// Definitions behind the stand-in headers in this directory. Linked into
+// every host target that compiles sketch code beyond the pure-C++ headers.
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "host_heap.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <random>
+#include <thread>
+#include <vector>
+
+// ---- heap accounting (the link wraps malloc, calloc, realloc and free) ----
+
+extern "C" {
+void* __real_malloc(size_t n);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* p, size_t n);
+void __real_free(void* p);
+}
+
+static std::atomic<uint64_t> heapAllocs(0);
+static std::atomic<uint64_t> heapFrees(0);
+static std::atomic<int64_t> heapInUse(0);
+static std::atomic<int64_t> heapPeak(0);
+static thread_local uint64_t threadAllocs = 0;
+
+// ---- device heap model (see host_heap.h) ----
+// Runs inside malloc, so it never allocates: free ranges per region in a
+// sorted array, live blocks in an open-addressing table keyed by pointer.
+
+enum ModelRegion : uint8_t { MODEL_INTERNAL, MODEL_PSRAM, MODEL_REGIONS };
+enum ModelWant : uint8_t { WANT_ANY, WANT_INTERNAL, WANT_PSRAM };
+
+#define MODEL_HEADER 8            // per-block overhead; blocks are multiples of 8
+#define MODEL_HOLES 4096          // free ranges per region
+#define MODEL_SLOTS (1u << 17)    // live blocks, kept under 3/4 full
+
+struct ModelHole {
+  uint32_t at;
+  uint32_t len;
+};
+
+struct ModelHeap {
+  uint32_t size;
+  uint32_t used;
+  uint32_t maxUsed;
+  int holes;
+  ModelHole hole[MODEL_HOLES];
+};
+
+struct ModelSlot {
+  uintptr_t key;   // 0: empty
+  uint32_t at;
+  uint32_t len;
+  uint8_t region;
+};
+
+static std::mutex modelMutex;
+static ModelHeap modelHeaps[MODEL_REGIONS];
+static ModelSlot modelSlots[MODEL_SLOTS];
+static uint32_t modelLive = 0;
+static uint64_t modelUnplaced = 0;
+static thread_local bool modelExempt = false;
+static thread_local uint8_t modelWant = WANT_ANY;
+
+static void modelInit() {
+  const uint32_t sizes[MODEL_REGIONS] = { HOST_HEAP_INTERNAL, HOST_HEAP_PSRAM };
+  for (int r = 0; r < MODEL_REGIONS; r++) {
+    ModelHeap& h = modelHeaps[r];
+    if (h.size) continue;
+    h.size = sizes[r];
+    h.hole[0] = { 0, sizes[r] };
+    h.holes = 1;
+  }
+}
+
+// Best fit, as the IDF heap allocator
+static bool modelTake(ModelHeap& h, uint32_t len, uint32_t& at) {
+  int best = -1;
+  for (int i = 0; i < h.holes; i++) {
+    if (h.hole[i].len >= len && (best < 0 || h.hole[i].len < h.hole[best].len)) best = i;
+  }
+  if (best < 0) return false;
+  ModelHole& b = h.hole[best];
+  at = b.at;
+  b.at += len;
+  b.len -= len;
+  if (b.len == 0) {
+    memmove(&h.hole[best], &h.hole[best + 1], (h.holes - best - 1) * sizeof(ModelHole));
+    h.holes--;
+  }
+  h.used += len;
+  if (h.used > h.maxUsed) h.maxUsed = h.used;
+  return true;
+}
+
+// Merged with its neighbours; with no room for another range the block
+// stays counted as used
+static void modelGive(ModelHeap& h, uint32_t at, uint32_t len) {
+  int lo = 0, hi = h.holes;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (h.hole[mid].at < at) lo = mid + 1;
+    else hi = mid;
+  }
+  bool joinPrev = lo > 0 && h.hole[lo - 1].at + h.hole[lo - 1].len == at;
+  bool joinNext = lo < h.holes && at + len == h.hole[lo].at;
+  if (joinPrev && joinNext) {
+    h.hole[lo - 1].len += len + h.hole[lo].len;
+    memmove(&h.hole[lo], &h.hole[lo + 1], (h.holes - lo - 1) * sizeof(ModelHole));
+    h.holes--;
+  } else if (joinPrev) {
+    h.hole[lo - 1].len += len;
+  } else if (joinNext) {
+    h.hole[lo].at = at;
+    h.hole[lo].len += len;
+  } else {
+    if (h.holes == MODEL_HOLES) return;
+    memmove(&h.hole[lo + 1], &h.hole[lo], (h.holes - lo) * sizeof(ModelHole));
+    h.hole[lo] = { at, len };
+    h.holes++;
+  }
+  h.used -= len;
+}
+
+static uint32_t modelLargest(const ModelHeap& h) {
+  uint32_t largest = 0;
+  for (int i = 0; i < h.holes; i++) largest = std::max(largest, h.hole[i].len);
+  return largest > MODEL_HEADER ? largest - MODEL_HEADER : 0;
+}
+
+static uint32_t modelHash(uintptr_t key) {
+  return (uint32_t)(((uint64_t)key >> 3) * 0x9E3779B97F4A7C15ull >> 32) & (MODEL_SLOTS - 1);
+}
+
+static void modelPlace(uintptr_t key, size_t n, uint8_t want) {
+  if (!key || modelExempt) return;
+  std::lock_guard<std::mutex> lock(modelMutex);
+  modelInit();
+  if (n > HOST_HEAP_PSRAM || modelLive >= MODEL_SLOTS / 4 * 3) {
+    modelUnplaced++;
+    return;
+  }
+  uint32_t len = (uint32_t)((n + MODEL_HEADER + 7) & ~(size_t)7);
+  uint8_t order[2] = { MODEL_INTERNAL, MODEL_PSRAM };
+  int tries = 2;
+  if (want == WANT_INTERNAL) tries = 1;
+  else if (want == WANT_PSRAM) order[0] = MODEL_PSRAM, tries = 1;
+  else if (n > HOST_HEAP_PSRAM_ABOVE) order[0] = MODEL_PSRAM, order[1] = MODEL_INTERNAL;
+  for (int t = 0; t < tries; t++) {
+    uint32_t at;
+    if (!modelTake(modelHeaps[order[t]], len, at)) continue;
+    uint32_t i = modelHash(key);
+    while (modelSlots[i].key) i = (i + 1) & (MODEL_SLOTS - 1);
+    modelSlots[i] = { key, at, len, order[t] };
+    modelLive++;
+    return;
+  }
+  modelUnplaced++;
+}
+
+static void modelRelease(uintptr_t key) {
+  if (!key) return;
+  std::lock_guard<std::mutex> lock(modelMutex);
+  uint32_t i = modelHash(key);
+  for (;; i = (i + 1) & (MODEL_SLOTS - 1)) {
+    if (!modelSlots[i].key) return;   // exempt, unplaced or not ours
+    if (modelSlots[i].key == key) break;
+  }
+  ModelSlot s = modelSlots[i];
+  // Backward-shift deletion keeps every probe chain unbroken
+  for (uint32_t j = i;;) {
+    j = (j + 1) & (MODEL_SLOTS - 1);
+    if (!modelSlots[j].key) break;
+    uint32_t k = modelHash(modelSlots[j].key);
+    bool stays = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+    if (stays) continue;
+    modelSlots[i] = modelSlots[j];
+    i = j;
+  }
+  modelSlots[i].key = 0;
+  modelLive--;
+  modelGive(modelHeaps[s.region], s.at, s.len);
+}
+
+HostHeapExempt::HostHeapExempt() : was(modelExempt) {
+  modelExempt = true;
+}
+
+HostHeapExempt::~HostHeapExempt() {
+  modelExempt = was;
+}
+
+static void heapAdd(void* p, size_t n) {
+  if (!p) return;
+  heapAllocs++;
+  threadAllocs++;
+  int64_t now = heapInUse += (int64_t)malloc_usable_size(p);
+  int64_t peak = heapPeak.load();
+  while (now > peak && !heapPeak.compare_exchange_weak(peak, now)) {}
+  modelPlace((uintptr_t)p, n, modelWant);
+}
+
+static void heapRemove(void* p) {
+  if (!p) return;
+  heapFrees++;
+  heapInUse -= (int64_t)malloc_usable_size(p);
+  modelRelease((uintptr_t)p);
+}
+
+extern "C" {
+void* __wrap_malloc(size_t n) {
+  void* p = __real_malloc(n);
+  heapAdd(p, n);
+  return p;
+}
+void* __wrap_calloc(size_t n, size_t size) {
+  void* p = __real_calloc(n, size);
+  heapAdd(p, n * size);
+  return p;
+}
+void* __wrap_realloc(void* p, size_t n) {
+  int64_t before = p ? (int64_t)malloc_usable_size(p) : 0;
+  void* q = __real_realloc(p, n);
+  if (!q) return q;
+  heapAllocs++;
+  threadAllocs++;
+  int64_t now = heapInUse += (int64_t)malloc_usable_size(q) - before;
+  int64_t peak = heapPeak.load();
+  while (now > peak && !heapPeak.compare_exchange_weak(peak, now)) {}
+  modelRelease((uintptr_t)p);
+  modelPlace((uintptr_t)q, n, modelWant);
+  return q;
+}
+void __wrap_free(void* p) {
+  heapRemove(p);
+  __real_free(p);
+}
+}
+
+void* operator new(size_t n) {
+  void* p = __wrap_malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void* operator new[](size_t n) { return operator new(n); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept { return __wrap_malloc(n ? n : 1); }
+void* operator new[](size_t n, const std::nothrow_t&) noexcept { return __wrap_malloc(n ? n : 1); }
+void operator delete(void* p) noexcept { __wrap_free(p); }
+void operator delete[](void* p) noexcept { __wrap_free(p); }
+void operator delete(void* p, size_t) noexcept { __wrap_free(p); }
+void operator delete[](void* p, size_t) noexcept { __wrap_free(p); }
+
+HostHeapStats hostHeapStats() {
+  HostHeapStats s;
+  s.allocs = heapAllocs;
+  s.frees = heapFrees;
+  s.inUse = heapInUse;
+  s.peak = heapPeak;
+  std::lock_guard<std::mutex> lock(modelMutex);
+  modelInit();
+  const ModelHeap& in = modelHeaps[MODEL_INTERNAL];
+  const ModelHeap& ps = modelHeaps[MODEL_PSRAM];
+  s.internalFree = in.size - in.used;
+  s.internalLargest = modelLargest(in);
+  s.internalMinFree = in.size - in.maxUsed;
+  s.psramFree = ps.size - ps.used;
+  s.psramLargest = modelLargest(ps);
+  s.unplaced = modelUnplaced;
+  return s;
+}
+
+uint64_t hostThreadAllocs() {
+  return threadAllocs;
+}
+
+void hostHeapResetPeak() {
+  heapPeak = heapInUse.load();
+}
+
+// ---- clock ----
+
+double hostSpeed = 1.0;
+static const std::chrono::steady_clock::time_point hostStart = std::chrono::steady_clock::now();
+
+static int64_t realMicros() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now() - hostStart).count();
+}
+
+unsigned long millis() {
+  return (unsigned long)(realMicros() * hostSpeed / 1000.0);
+}
+
+unsigned long micros() {
+  return (unsigned long)realMicros();
+}
+
+void delay(unsigned long ms) {
+  if (ms == 0) {
+    std::this_thread::yield();
+    return;
+  }
+  std::this_thread::sleep_for(std::chrono::microseconds((int64_t)(ms * 1000.0 / hostSpeed)));
+}
+
+// The wall clock runs at hostSpeed too, from the real time at start-up, so
+// the scheduler's epoch deadlines fire in simulated time
+extern "C" {
+int __real_gettimeofday(struct timeval* tv, void* tz);
+int __wrap_gettimeofday(struct timeval* tv, void* tz) {
+  static const int64_t startUs = [] {
+    struct timeval t;
+    __real_gettimeofday(&t, nullptr);
+    return (int64_t)t.tv_sec * 1000000 + t.tv_usec;
+  }();
+  int64_t us = startUs + (int64_t)(realMicros() * hostSpeed);
+  if (tv) {
+    tv->tv_sec = (time_t)(us / 1000000);
+    tv->tv_usec = (suseconds_t)(us % 1000000);
+  }
+  (void)tz;
+  return 0;
+}
+time_t __wrap_time(time_t* out) {
+  struct timeval tv;
+  __wrap_gettimeofday(&tv, nullptr);
+  if (out) *out = tv.tv_sec;
+  return tv.tv_sec;
+}
+}
+
+void yield() {
+  std::this_thread::yield();
+}
+
+static std::mt19937 hostRng(12345);
+static std::mutex hostRngMutex;
+
+long random(long max) {
+  return max > 0 ? random(0, max) : 0;
+}
+
+long random(long min, long max) {
+  if (max <= min) return min;
+  std::lock_guard<std::mutex> lock(hostRngMutex);
+  return min + (long)(hostRng() % (unsigned long)(max - min));
+}
+
+uint32_t esp_random() {
+  std::lock_guard<std::mutex> lock(hostRngMutex);
+  return hostRng();
+}
+
+esp_reset_reason_t esp_reset_reason() {
+  return ESP_RST_POWERON;
+}
+
+bool psramFound() { return true; }
+// Placed in the model's PSRAM (malloc itself picks by size)
+void* ps_malloc(size_t n) {
+  modelWant = WANT_PSRAM;
+  void* p = malloc(n);
+  modelWant = WANT_ANY;
+  return p;
+}
+void* ps_calloc(size_t n, size_t size) {
+  modelWant = WANT_PSRAM;
+  void* p = calloc(n, size);
+  modelWant = WANT_ANY;
+  return p;
+}
+void* ps_realloc(void* p, size_t n) {
+  modelWant = WANT_PSRAM;
+  void* q = realloc(p, n);
+  modelWant = WANT_ANY;
+  return q;
+}
+
+void configTzTime(const char* tz, const char*, const char*, const char*) {
+  setenv("TZ", tz, 1);
+  tzset();
+}
+
+bool getLocalTime(struct tm* info, uint32_t) {
+  time_t now = time(nullptr);
+  localtime_r(&now, info);
+  return true;
+}
+
+// ---- Serial, ESP ----
+
+HardwareSerial Serial;
+static std::mutex serialMutex;
+static const bool serialQuiet = getenv("HOST_QUIET") && getenv("HOST_QUIET")[0] == '1';
+
+size_t HardwareSerial::write(const uint8_t* b, size_t n) {
+  if (serialQuiet) return n;
+  std::lock_guard<std::mutex> lock(serialMutex);
+  return fwrite(b, 1, n, stdout);
+}
+
+EspClass ESP;
+
+// Internal RAM and PSRAM from the heap model
+uint32_t EspClass::getFreeHeap() { return hostHeapStats().internalFree; }
+uint32_t EspClass::getMinFreeHeap() { return hostHeapStats().internalMinFree; }
+uint32_t EspClass::getMaxAllocHeap() { return hostHeapStats().internalLargest; }
+uint32_t EspClass::getFreePsram() { return hostHeapStats().psramFree; }
+uint32_t EspClass::getPsramSize() { return HOST_HEAP_PSRAM; }
+uint32_t EspClass::getMinFreePsram() {
+  std::lock_guard<std::mutex> lock(modelMutex);
+  modelInit();
+  return HOST_HEAP_PSRAM - modelHeaps[MODEL_PSRAM].maxUsed;
+}
+uint32_t EspClass::getMaxAllocPsram() { return hostHeapStats().psramLargest; }
+
+void EspClass::restart() {
+  fflush(stdout);
+  _exit(0);
+}
+
+uint32_t EspClass::getCycleCount() {
+  using namespace std::chrono;
+  return (uint32_t)(duration_cast<nanoseconds>(steady_clock::now() - hostStart).count() * 240 / 1000);
+}
+
+// ---- WiFi ----
+
+WiFiClass WiFi;
+
+WiFiClient::Socket::~Socket() {
+  if (fd >= 0) close(fd);
+}
+
+WiFiClient::WiFiClient(int fd) : sock(std::make_shared<Socket>()) {
+  sock->fd = fd;
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+  stop();
+  sockaddr_in a;
+  memset(&a, 0, sizeof(a));
+  a.sin_family = AF_INET;
+  a.sin_port = htons(port);
+  if (!strcmp(host, "localhost")) host = "127.0.0.1";
+  if (inet_pton(AF_INET, host, &a.sin_addr) != 1) return 0;
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return 0;
+  if (::connect(fd, (sockaddr*)&a, sizeof(a)) != 0) {
+    close(fd);
+    return 0;
+  }
+  sock = std::make_shared<Socket>();
+  sock->fd = fd;
+  return 1;
+}
+
+// Like the device: still "connected" while received data is left to read
+uint8_t WiFiClient::connected() {
+  if (!sock || sock->fd < 0) return 0;
+  if (available() > 0) return 1;
+  return sock->peerClosed ? 0 : 1;
+}
+
+void WiFiClient::stop() {
+  if (sock && sock->fd >= 0) {
+    close(sock->fd);
+    sock->fd = -1;
+  }
+  sock.reset();
+}
+
+int WiFiClient::setNoDelay(bool on) {
+  int v = on ? 1 : 0;
+  return sock ? setsockopt(sock->fd, IPPROTO_TCP, TCP_NODELAY, &v, sizeof(v)) : -1;
+}
+
+IPAddress WiFiClient::remoteIP() const {
+  sockaddr_in a;
+  socklen_t n = sizeof(a);
+  if (!sock || getpeername(sock->fd, (sockaddr*)&a, &n) != 0) return IPAddress();
+  return IPAddress(a.sin_addr.s_addr);
+}
+
+size_t WiFiClient::write(const uint8_t* b, size_t n) {
+  if (!sock || sock->fd < 0) return 0;
+  size_t done = 0;
+  while (done < n) {
+    ssize_t w = send(sock->fd, b + done, n - done, MSG_NOSIGNAL);
+    if (w <= 0) return done;
+    done += (size_t)w;
+  }
+  return done;
+}
+
+int WiFiClient::available() {
+  if (!sock || sock->fd < 0) return 0;
+  int n = 0;
+  if (ioctl(sock->fd, FIONREAD, &n) != 0) return 0;
+  if (n == 0 && !sock->peerClosed) {
+    pollfd p = { sock->fd, POLLIN, 0 };
+    uint8_t c;
+    if (poll(&p, 1, 0) > 0 && recv(sock->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT) == 0) sock->peerClosed = true;
+  }
+  return n;
+}
+
+int WiFiClient::read(uint8_t* b, size_t n) {
+  if (!sock || sock->fd < 0) return -1;
+  ssize_t r = recv(sock->fd, b, n, MSG_DONTWAIT);
+  if (r == 0) sock->peerClosed = true;
+  return r > 0 ? (int)r : -1;
+}
+
+// ---- FreeRTOS ----
+
+static std::chrono::microseconds ticksToReal(TickType_t ticks) {
+  return std::chrono::microseconds((int64_t)(ticks * 1000.0 / hostSpeed));
+}
+
+// Waits on `cv` until `ready` or `ticks` simulated ms have passed
+template <class Pred>
+static bool waitTicks(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, TickType_t ticks,
+                      Pred ready) {
+  if (ticks == portMAX_DELAY) {
+    cv.wait(lock, ready);
+    return true;
+  }
+  return cv.wait_for(lock, ticksToReal(ticks), ready);
+}
+
+static std::recursive_mutex criticalMutex;
+
+void portENTER_CRITICAL(portMUX_TYPE*) { criticalMutex.lock(); }
+void portEXIT_CRITICAL(portMUX_TYPE*) { criticalMutex.unlock(); }
+
+struct HostSemaphore {
+  std::mutex m;
+  std::condition_variable cv;
+  int count;
+  bool recursive;
+  std::thread::id owner;
+  int depth = 0;
+  HostSemaphore(int initial, bool rec) : count(initial), recursive(rec) {}
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new HostSemaphore(1, false); }
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return new HostSemaphore(1, true); }
+SemaphoreHandle_t xSemaphoreCreateBinary() { return new HostSemaphore(0, false); }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t h, TickType_t wait) {
+  HostSemaphore* s = (HostSemaphore*)h;
+  std::unique_lock<std::mutex> lock(s->m);
+  if (s->recursive && s->depth > 0 && s->owner == std::this_thread::get_id()) {
+    s->depth++;
+    return pdTRUE;
+  }
+  if (!waitTicks(s->cv, lock, wait, [s] { return s->count > 0; })) return pdFALSE;
+  s->count--;
+  s->owner = std::this_thread::get_id();
+  s->depth = 1;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t h) {
+  HostSemaphore* s = (HostSemaphore*)h;
+  std::lock_guard<std::mutex> lock(s->m);
+  if (s->recursive && --s->depth > 0) return pdTRUE;
+  if (s->count > 0) return pdFALSE;
+  s->count = 1;
+  s->depth = 0;
+  s->cv.notify_one();
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t h, TickType_t wait) { return xSemaphoreTake(h, wait); }
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t h) { return xSemaphoreGive(h); }
+
+struct HostQueue {
+  std::mutex m;
+  std::condition_variable cv;
+  std::deque<std::vector<uint8_t>> items;
+  unsigned length;
+  unsigned itemSize;
+};
+
+QueueHandle_t xQueueCreate(unsigned length, unsigned itemSize) {
+  HostQueue* q = new HostQueue;
+  q->length = length;
+  q->itemSize = itemSize;
+  return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t h, const void* item, TickType_t wait) {
+  HostQueue* q = (HostQueue*)h;
+  std::unique_lock<std::mutex> lock(q->m);
+  if (!waitTicks(q->cv, lock, wait, [q] { return q->items.size() < q->length; })) return pdFALSE;
+  const uint8_t* p = (const uint8_t*)item;
+  q->items.emplace_back(p, p + q->itemSize);
+  q->cv.notify_all();
+  return pdTRUE;
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t h, const void* item, TickType_t wait) {
+  return xQueueSend(h, item, wait);
+}
+
+static BaseType_t queueTake(QueueHandle_t h, void* item, TickType_t wait, bool remove) {
+  HostQueue* q = (HostQueue*)h;
+  std::unique_lock<std::mutex> lock(q->m);
+  if (!waitTicks(q->cv, lock, wait, [q] { return !q->items.empty(); })) return pdFALSE;
+  memcpy(item, q->items.front().data(), q->itemSize);
+  if (remove) {
+    q->items.pop_front();
+    q->cv.notify_all();
+  }
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t h, void* item, TickType_t wait) { return queueTake(h, item, wait, true); }
+BaseType_t xQueuePeek(QueueHandle_t h, void* item, TickType_t wait) { return queueTake(h, item, wait, false); }
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t h) {
+  HostQueue* q = (HostQueue*)h;
+  std::lock_guard<std::mutex> lock(q->m);
+  return (UBaseType_t)q->items.size();
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t h) {
+  HostQueue* q = (HostQueue*)h;
+  std::lock_guard<std::mutex> lock(q->m);
+  return (UBaseType_t)(q->length - q->items.size());
+}
+
+struct HostTask {
+  std::mutex m;
+  std::condition_variable cv;
+  uint32_t notified = 0;
+};
+
+struct HostTaskExit {};
+
+static thread_local HostTask* currentTask = nullptr;
+
+static HostTask* selfTask() {
+  if (!currentTask) currentTask = new HostTask;   // main thread, loop()
+  return currentTask;
+}
+
+// The thread's own stack is the host's; `stack` bytes are taken from the
+// model's internal RAM until the task ends, as FreeRTOS allocates them
+BaseType_t xTaskCreatePinnedToCore(void (*fn)(void*), const char*, uint32_t stack, void* arg, UBaseType_t,
+                                   TaskHandle_t* out, BaseType_t) {
+  HostTask* t = new HostTask;
+  if (out) *out = t;
+  uintptr_t stackKey = (uintptr_t)t | 1;   // never a malloc() result
+  modelPlace(stackKey, stack, WANT_INTERNAL);
+  std::thread([fn, arg, t, stackKey] {
+    currentTask = t;
+    try {
+      fn(arg);
+    } catch (const HostTaskExit&) {
+    }
+    modelRelease(stackKey);
+  }).detach();
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(void (*fn)(void*), const char* name, uint32_t stack, void* arg, UBaseType_t prio,
+                       TaskHandle_t* out) {
+  return xTaskCreatePinnedToCore(fn, name, stack, arg, prio, out, tskNO_AFFINITY);
+}
+
+void vTaskDelay(TickType_t ticks) {
+  delay(ticks);
+}
+
+// Only a task ending itself is supported (all the sketch does)
+void vTaskDelete(TaskHandle_t task) {
+  if (!task || task == currentTask) throw HostTaskExit();
+}
+
+void vTaskDelayUntil(TickType_t* last, TickType_t period) {
+  TickType_t next = *last + period;
+  TickType_t now = xTaskGetTickCount();
+  if ((int32_t)(next - now) > 0) delay(next - now);
+  *last = next;
+}
+
+TickType_t xTaskGetTickCount() {
+  return (TickType_t)millis();
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait) {
+  HostTask* t = selfTask();
+  std::unique_lock<std::mutex> lock(t->m);
+  if (!waitTicks(t->cv, lock, wait, [t] { return t->notified > 0; })) return 0;
+  uint32_t n = t->notified;
+  t->notified = clear ? 0 : n - 1;
+  return n;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  HostTask* t = (HostTask*)task;
+  if (!t) return pdFALSE;
+  std::lock_guard<std::mutex> lock(t->m);
+  t->notified++;
+  t->cv.notify_one();
+  return pdPASS;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) {
+  return 1024;
+}
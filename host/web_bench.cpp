@@ -0,0 +1,127 @@
+// Web UI while loop() is busy: requests per second and latency, served
+// from the web task (WEB_SERVER_TASK 1, web_bench_task) or from loop()
+// (WEB_SERVER_TASK 0, web_bench_loop).
+//
+// The whole sketch runs at real speed against the mock Bot API, which
+// answers sendMessage after SLOW_REPLY_MS, as a congested uplink does. A
+// Telegram /status arrives every second, so loop() spends part of its time
+// replying. Meanwhile WEB_CLIENTS threads send requests back to back
+// through the WebServer stand-in: GET /status, and from the first client
+// every tenth request a POST /save-settings. Latency is measured by the
+// client, from queueing the request to its status code.
+//
+// Checked: every request is answered 200, and a /save-settings is in
+// place once its reply is back. The ArduinoJson stand-in reads every field
+// as 0, so a save clamps the interval to 1 and the threshold to 1000 (the
+// defaults are 5 and 5000).
+
+#include "sketch_harness.h"
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include "host_check.h"
+#include "mock_bot_api.h"
+
+uint16_t simBotPort;
+
+#define SLOW_REPLY_MS 250
+#define WEB_CLIENTS 4
+#define BENCH_MS 6000
+
+static long benchUpdateId = 700000000;
+static std::atomic<bool> benchStopping(false);
+static std::atomic<int> clientsDone(0);
+
+static MockReply benchReply(const MockRequest& r) {
+  if (r.apiMethod == "getUpdates") {
+    // One /status per second
+    for (int i = 0; i < 20 && !benchStopping; i++) delay(50);
+    if (benchStopping) return MockBotApi::defaultReply(r);
+    long id = ++benchUpdateId;
+    MockReply reply;
+    reply.body = "{\"ok\":true,\"result\":[{\"update_id\":" + std::to_string(id) +
+                 ",\"message\":{\"message_id\":" + std::to_string(id % 100000) +
+                 ",\"from\":{\"id\":1001,\"is_bot\":false,\"first_name\":\"Bench\"},"
+                 "\"chat\":{\"id\":1001,\"type\":\"private\"},\"date\":" + std::to_string(time(nullptr)) +
+                 ",\"text\":\"/status\"}}]}";
+    return reply;
+  }
+  if (r.apiMethod == "sendMessage") delay(SLOW_REPLY_MS);
+  return MockBotApi::defaultReply(r);
+}
+
+struct ClientResult {
+  std::vector<double> statusMs;
+  std::vector<double> saveMs;
+  unsigned failed = 0;
+  unsigned notApplied = 0;
+};
+
+static void client(int n, ClientResult& out) {
+  HostHeapExempt exempt;
+  unsigned long start = millis();
+  for (int i = 0; millis() - start < BENCH_MS; i++) {
+    bool save = n == 0 && i % 10 == 9;
+    double t0 = hostNowUs();
+    int code = save ? server.hostRequest(HTTP_POST, "/save-settings", "{\"mode\":0,\"interval\":1,\"threshold\":1000}")
+                    : server.hostRequest(HTTP_GET, "/status");
+    double ms = (hostNowUs() - t0) / 1000.0;
+    if (code != 200) out.failed++;
+    if (save && (timeInterval != 1 || motionThreshold != 1000)) out.notApplied++;
+    (save ? out.saveMs : out.statusMs).push_back(ms);
+  }
+  clientsDone++;
+}
+
+static double percentile(std::vector<double>& v, double p) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  size_t i = (size_t)(p / 100.0 * (v.size() - 1) + 0.5);
+  return v[i];
+}
+
+int main() {
+  char dir[] = "/tmp/esp32cam-web-XXXXXX";
+  if (!mkdtemp(dir)) return 2;
+  setenv("HOST_SPIFFS_DIR", dir, 1);
+  MockBotApi mock;
+  mock.handler = benchReply;
+  CHECK(mock.start());
+  simBotPort = mock.port();
+  setup();
+  CHECK(timeInterval == 5 && motionThreshold == 5000);
+
+  ClientResult results[WEB_CLIENTS];
+  std::vector<std::thread> clients;
+  double wall0 = hostNowUs();
+  for (int i = 0; i < WEB_CLIENTS; i++) clients.emplace_back(client, i, std::ref(results[i]));
+  while (clientsDone < WEB_CLIENTS) loop();
+  double seconds = (hostNowUs() - wall0) / 1e6;
+  benchStopping = true;
+  for (std::thread& t : clients) t.join();
+
+  std::vector<double> status, save;
+  unsigned failed = 0, notApplied = 0;
+  for (const ClientResult& r : results) {
+    status.insert(status.end(), r.statusMs.begin(), r.statusMs.end());
+    save.insert(save.end(), r.saveMs.begin(), r.saveMs.end());
+    failed += r.failed;
+    notApplied += r.notApplied;
+  }
+  size_t total = status.size() + save.size();
+  printf("WEB_SERVER_TASK %d: %d clients, %zu requests in %.1f s = %.0f req/s; %u Telegram replies of %d ms\n",
+         WEB_SERVER_TASK, WEB_CLIENTS, total, seconds, total / seconds, mock.count("sendMessage"), SLOW_REPLY_MS);
+  printf("  GET /status          p50 %7.2f ms  p99 %7.2f ms  max %7.2f ms\n", percentile(status, 50),
+         percentile(status, 99), percentile(status, 100));
+  printf("  POST /save-settings  p50 %7.2f ms  p99 %7.2f ms  max %7.2f ms (%zu)\n", percentile(save, 50),
+         percentile(save, 99), percentile(save, 100), save.size());
+  CHECK(failed == 0);
+  CHECK(notApplied == 0);
+  CHECK(!save.empty() && mock.count("sendMessage") > 1);
+
+  fflush(stdout);
+  // Sketch tasks never return; leave without running static destructors under them
+  _exit(hostFailures());
+}
@@ -1,6 +1,8 @@
 #ifndef HTML_PAGE_H
 #define HTML_PAGE_H
 
+// Served gzip-compressed from html_page_gz.h: run tools/gzip_html.py after
+// editing (the build stops with a static_assert until you do).
 const char INDEX_HTML[] PROGMEM = R"rawliteral(
 <!DOCTYPE html>
 <html>
@@ -38,7 +40,7 @@ const char INDEX_HTML[] PROGMEM = R"rawliteral(
   <h1>ESP32-CAM Security Monitor</h1>
 
   <div class="video-container">
-    <img id="stream" src="/stream">
+    <img id="stream" src="/mjpeg" onerror="streamFallback()">
   </div>
 
   <div class="stats-grid">
@@ -51,6 +53,7 @@ const char INDEX_HTML[] PROGMEM = R"rawliteral(
       <h3>Manual Control</h3>
       <button class="btn btn-capture" onclick="captureNow()">Capture Image Now</button>
       <button class="btn btn-test" onclick="testTelegram()">Test Telegram</button>
+      <button class="btn btn-capture" onclick="burstNow()">Burst x5</button>
       <button class="btn" onclick="refreshStream()">Refresh Stream</button>
       <button class="btn" onclick="openDebug()">Open /debug</button>
       <div class="hint">Tip: while editing settings, auto-refresh won’t override your inputs.</div>
@@ -78,6 +81,15 @@ const char INDEX_HTML[] PROGMEM = R"rawliteral(
         <div>Sensitivity: <span id="sensitivityValue">Medium</span></div>
       </div>
 
+      <div class="form-group">
+        <label>Pre-event ring (KB, 0 = off):</label>
+        <input type="number" id="ringKB" min="0" max="4096" step="64" value="768">
+        <label>Frames before / after motion:</label>
+        <input type="number" id="preFrames" min="0" max="9" value="3">
+        <input type="number" id="postFrames" min="0" max="9" value="2">
+        <div class="hint">Ring: <span id="ringUsage">-</span></div>
+      </div>
+
       <button class="btn" onclick="saveSettings()">Save Settings</button>
       <div class="hint">Settings are applied immediately and will be persisted shortly (throttled EEPROM write).</div>
     </div>
@@ -124,20 +136,46 @@ const char INDEX_HTML[] PROGMEM = R"rawliteral(
       value < 5000 ? 'High' : value < 10000 ? 'Medium' : 'Low';
   }
 
+  // Long operations answer with a job ID right away; poll until it is done
+  function runJob(url, label) {
+    fetch(url)
+      .then(r => r.json())
+      .then(j => {
+        if (!j.job) { alert(label + ': ' + (j.error || 'failed')); return; }
+        const poll = () => fetch('/job?id=' + j.job)
+          .then(r => r.json())
+          .then(s => {
+            if (s.state === 'queued' || s.state === 'running') { setTimeout(poll, 700); return; }
+            alert(label + ': ' + s.result);
+            updateStatus();
+          });
+        poll();
+      })
+      .catch(() => alert(label + ': request failed'));
+  }
+
   function captureNow() {
-    fetch('/capture-now')
-      .then(r => r.text())
-      .then(result => { alert('Capture: ' + result); updateStatus(); });
+    runJob('/capture-now', 'Capture');
   }
 
   function testTelegram() {
-    fetch('/test-telegram')
-      .then(r => r.text())
-      .then(result => { alert('Test: ' + result); updateStatus(); });
+    runJob('/test-telegram', 'Test');
   }
 
+  function burstNow() {
+    runJob('/burst?n=5', 'Burst');
+  }
+
+  // /mjpeg keeps pushing frames; /stream (one JPEG per request) is the
+  // fallback when the viewer limit is reached
+  let mjpegOk = true;
   function refreshStream() {
-    document.getElementById('stream').src = '/stream?t=' + Date.now();
+    document.getElementById('stream').src = (mjpegOk ? '/mjpeg?t=' : '/stream?t=') + Date.now();
+  }
+
+  function streamFallback() {
+    mjpegOk = false;
+    setTimeout(refreshStream, 2500);
   }
 
   function openDebug() {
@@ -150,7 +188,10 @@ const char INDEX_HTML[] PROGMEM = R"rawliteral(
     const settings = {
       mode: parseInt(document.getElementById('captureMode').value, 10),
       interval: parseInt(document.getElementById('timeInterval').value, 10),
-      threshold: parseInt(document.getElementById('motionThreshold').value, 10)
+      threshold: parseInt(document.getElementById('motionThreshold').value, 10),
+      ringKB: parseInt(document.getElementById('ringKB').value, 10),
+      preFrames: parseInt(document.getElementById('preFrames').value, 10),
+      postFrames: parseInt(document.getElementById('postFrames').value, 10)
     };
 
     fetch('/save-settings', {
@@ -163,37 +204,63 @@ const char INDEX_HTML[] PROGMEM = R"rawliteral(
     });
   }
 
+  // /events pushes the full status once, then only the fields that changed;
+  // /status polling takes over while the event stream is down
+  let status = {};
+  let live = false;
+
+  function applyStatus(delta) {
+    Object.assign(status, delta);
+    const data = status;
+    document.getElementById('capturedCount').textContent = data.capturedCount;
+    document.getElementById('sentCount').textContent = data.sentCount;
+    document.getElementById('lastCaptureTime').textContent = data.lastCaptureTime;
+    document.getElementById('lastCaptureType').textContent = data.lastCaptureType;
+    document.getElementById('lastTelegramResult').textContent = data.lastTelegramResult;
+    document.getElementById('currentMode').textContent = data.currentMode;
+    document.getElementById('telegramDebug').textContent = data.telegramDebug;
+    document.getElementById('uptime').textContent = data.uptime;
+    const pb = data.prebuffer || {};
+    document.getElementById('ringUsage').textContent =
+      pb.usedKB + '/' + pb.allocatedKB + ' KB, ' + pb.frames + ' frames (' +
+      Math.round((pb.historyMs || 0) / 1000) + ' s), ' +
+      (pb.framesPerEvent || 0).toFixed(1) + ' frames/event';
+
+    // ✅ don't overwrite the form while user is editing
+    if (!isEditing) {
+      document.getElementById('captureMode').value = data.captureMode;
+      document.getElementById('timeInterval').value = data.timeInterval;
+      document.getElementById('motionThreshold').value = data.motionThreshold;
+      document.getElementById('ringKB').value = pb.ringKB;
+      document.getElementById('preFrames').value = pb.preFrames;
+      document.getElementById('postFrames').value = pb.postFrames;
+      updateSensitivity();
+      updateMode();
+    }
+  }
+
   function updateStatus() {
     fetch('/status')
       .then(r => r.json())
-      .then(data => {
-        document.getElementById('capturedCount').textContent = data.capturedCount;
-        document.getElementById('sentCount').textContent = data.sentCount;
-        document.getElementById('lastCaptureTime').textContent = data.lastCaptureTime;
-        document.getElementById('lastCaptureType').textContent = data.lastCaptureType;
-        document.getElementById('lastTelegramResult').textContent = data.lastTelegramResult;
-        document.getElementById('currentMode').textContent = data.currentMode;
-        document.getElementById('telegramDebug').textContent = data.telegramDebug;
-        document.getElementById('uptime').textContent = data.uptime;
-
-        // ✅ don't overwrite the form while user is editing
-        if (!isEditing) {
-          document.getElementById('captureMode').value = data.captureMode;
-          document.getElementById('timeInterval').value = data.timeInterval;
-          document.getElementById('motionThreshold').value = data.motionThreshold;
-          updateSensitivity();
-          updateMode();
-        }
-      })
+      .then(applyStatus)
       .catch(() => {});
   }
 
+  function startEvents() {
+    if (!window.EventSource) return;
+    const es = new EventSource('/events');
+    es.addEventListener('status', e => { live = true; status = {}; applyStatus(JSON.parse(e.data)); });
+    es.addEventListener('delta', e => applyStatus(JSON.parse(e.data)));
+    es.onerror = () => { live = false; };   // the browser reconnects by itself unless refused
+  }
+
   // Mark editing on interaction
   const modeEl = document.getElementById('captureMode');
   const intervalEl = document.getElementById('timeInterval');
   const thrEl = document.getElementById('motionThreshold');
+  const ringEls = ['ringKB', 'preFrames', 'postFrames'].map(id => document.getElementById(id));
 
-  [modeEl, intervalEl, thrEl].forEach(el => {
+  [modeEl, intervalEl, thrEl, ...ringEls].forEach(el => {
     el.addEventListener('focus', () => setEditing(true));
     el.addEventListener('input', () => setEditing(true));
     el.addEventListener('change', () => setEditing(true));
@@ -203,12 +270,12 @@ const char INDEX_HTML[] PROGMEM = R"rawliteral(
   document.getElementById('motionThreshold').addEventListener('input', updateSensitivity);
 
   // ✅ less load, and no stream refresh while editing
-  setInterval(updateStatus, 4000);
+  setInterval(() => { if (!live) updateStatus(); }, 4000);
   setInterval(() => {
-    if (!isEditing) refreshStream();
+    if (!isEditing && !mjpegOk) refreshStream();
   }, 2500);
 
-  updateStatus(); updateSensitivity(); updateMode();
+  updateStatus(); startEvents(); updateSensitivity(); updateMode();
 </script>
 </body>
 </html>
@@ -0,0 +1,241 @@
+#ifndef HTML_PAGE_GZ_H
+#define HTML_PAGE_GZ_H
+
+// Generated by tools/gzip_html.py from html_page.h - do not edit.
+// INDEX_HTML, gzip -9: 11456 -> 3556 bytes.
+
+#define INDEX_HTML_SOURCE_LEN 11456
+#define INDEX_HTML_ETAG "\"a3b4917a\""
+#define INDEX_HTML_GZ_ETAG "\"a3b4917a-gz\""
+
+const size_t INDEX_HTML_GZ_LEN = 3556;
+const uint8_t INDEX_HTML_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xbd, 0x5a, 0x6d, 0x6f, 0x1b, 0xc7,
+  0x11, 0xfe, 0xee, 0x5f, 0xb1, 0x61, 0xd0, 0x92, 0x44, 0xc9, 0x23, 0x45, 0xbd, 0xd9, 0x22, 0x29,
+  0x37, 0xb6, 0x95, 0xd6, 0x89, 0x15, 0x1b, 0x96, 0x53, 0xa0, 0x30, 0x8c, 0x62, 0xc9, 0xdb, 0x23,
+  0x4f, 0x3a, 0xde, 0x5e, 0x77, 0xf7, 0x44, 0x29, 0x8e, 0x80, 0x7e, 0xe9, 0x8f, 0x28, 0xd0, 0x5f,
+  0x97, 0x5f, 0xd2, 0x99, 0x7d, 0xb9, 0xdb, 0x3b, 0x1e, 0x45, 0xda, 0x01, 0x6a, 0x23, 0x91, 0xb8,
+  0x2f, 0xcf, 0xce, 0xcc, 0xce, 0x3c, 0x33, 0xb3, 0xf4, 0x93, 0xc9, 0x37, 0xaf, 0xde, 0xbe, 0xfc,
+  0xf0, 0xf7, 0x77, 0x17, 0x64, 0xa9, 0x56, 0xc9, 0xf9, 0x93, 0x89, 0xfb, 0xc1, 0x68, 0x78, 0xfe,
+  0x84, 0x90, 0x89, 0x8a, 0x55, 0xc2, 0xce, 0x2f, 0xae, 0xde, 0x1d, 0x8e, 0xfa, 0x2f, 0xbf, 0xbb,
+  0x24, 0x97, 0x3c, 0x8d, 0x15, 0x17, 0x93, 0x81, 0x99, 0xc0, 0x25, 0x2b, 0xa6, 0x28, 0x49, 0xe9,
+  0x8a, 0x4d, 0x5b, 0xb7, 0x31, 0x5b, 0x67, 0x5c, 0xa8, 0x16, 0x99, 0xf3, 0x54, 0xb1, 0x54, 0x4d,
+  0x5b, 0xeb, 0x38, 0x54, 0xcb, 0x69, 0xc8, 0x6e, 0xe3, 0x39, 0xeb, 0xeb, 0x0f, 0x3d, 0x12, 0x03,
+  0x46, 0x4c, 0x93, 0xbe, 0x9c, 0xd3, 0x84, 0x4d, 0x0f, 0x5a, 0x1a, 0x46, 0xaa, 0x7b, 0x03, 0x48,
+  0xc8, 0x8c, 0x87, 0xf7, 0xe4, 0x33, 0x89, 0x00, 0xa3, 0x1f, 0xd1, 0x55, 0x9c, 0xdc, 0x9f, 0x91,
+  0xef, 0x04, 0xec, 0xe8, 0x11, 0x49, 0x53, 0xd9, 0x97, 0x4c, 0xc4, 0xd1, 0x98, 0xac, 0xa8, 0x58,
+  0xc4, 0xe9, 0x19, 0x19, 0x8e, 0x49, 0x46, 0xc3, 0x30, 0x4e, 0x17, 0x67, 0x64, 0x34, 0xcc, 0xee,
+  0xc6, 0x64, 0x46, 0xe7, 0x37, 0x0b, 0xc1, 0xf3, 0x34, 0x3c, 0x23, 0xdf, 0x46, 0x43, 0xfc, 0x3b,
+  0x26, 0x0f, 0x1a, 0x3b, 0x40, 0xc9, 0x68, 0x9c, 0x32, 0x01, 0x27, 0xac, 0xe8, 0x9d, 0x91, 0xe9,
+  0x8c, 0x1c, 0x8c, 0x86, 0x7a, 0x6b, 0x01, 0x4a, 0x68, 0xae, 0x78, 0x15, 0x6a, 0xbd, 0x8c, 0x15,
+  0x83, 0x21, 0x2e, 0x42, 0x26, 0xfa, 0x82, 0x86, 0x71, 0x2e, 0x61, 0xa7, 0xde, 0x57, 0x97, 0x80,
+  0xdf, 0xf5, 0xe5, 0x92, 0x86, 0x7c, 0x8d, 0x50, 0xa3, 0xec, 0x4e, 0x2f, 0x23, 0x62, 0x31, 0xa3,
+  0x9d, 0x61, 0x4f, 0xff, 0x0d, 0x0e, 0xba, 0x4e, 0xa8, 0xe5, 0x01, 0x08, 0xa3, 0xd8, 0x9d, 0xea,
+  0xd3, 0x24, 0x5e, 0xc0, 0xe9, 0x73, 0xb0, 0x1d, 0x13, 0x63, 0x30, 0x63, 0xc2, 0x05, 0xe8, 0x70,
+  0x78, 0x78, 0x58, 0x28, 0x70, 0x1b, 0x87, 0x8c, 0xf7, 0x7d, 0x35, 0x9c, 0x0a, 0xc3, 0xe1, 0x1f,
+  0x6a, 0xba, 0x0f, 0x87, 0xc3, 0x2d, 0xf2, 0xf2, 0x5b, 0x26, 0xa2, 0x04, 0xc5, 0x5b, 0xc6, 0x61,
+  0xc8, 0x52, 0xa7, 0x79, 0x7f, 0xc6, 0x95, 0xe2, 0x2b, 0xa7, 0x87, 0x39, 0xf3, 0x5b, 0xa9, 0x04,
+  0xa3, 0xab, 0xfa, 0x51, 0x68, 0xbe, 0x25, 0x8b, 0x17, 0x4b, 0x75, 0x46, 0x8e, 0x86, 0xde, 0x7a,
+  0x6d, 0x64, 0xc1, 0x93, 0x7e, 0x46, 0x53, 0x96, 0xc0, 0xb6, 0x30, 0x96, 0x59, 0x42, 0xe1, 0x1a,
+  0x17, 0x22, 0x0e, 0xc7, 0xfa, 0xff, 0x7d, 0xc5, 0x56, 0x30, 0xa6, 0x18, 0xa8, 0x92, 0xe4, 0xab,
+  0x14, 0x25, 0x8b, 0x04, 0xfe, 0x07, 0xf3, 0x34, 0x73, 0x02, 0xb8, 0xfb, 0xc0, 0x4f, 0xa4, 0xb8,
+  0xc5, 0x3f, 0xaf, 0x58, 0x18, 0x53, 0xd2, 0xf1, 0x2e, 0xf0, 0xf4, 0xe4, 0x69, 0x76, 0xd7, 0x85,
+  0xb3, 0x36, 0x0e, 0xdf, 0x7e, 0x1a, 0xc0, 0x39, 0x89, 0xdd, 0xe2, 0xaa, 0xeb, 0x3c, 0x8d, 0x9e,
+  0x45, 0xb4, 0xe1, 0x72, 0x2b, 0x06, 0x7d, 0x5a, 0x8e, 0x01, 0x2a, 0x88, 0x29, 0x79, 0x12, 0x87,
+  0xe4, 0xdb, 0x90, 0xb1, 0x11, 0x3b, 0x29, 0x6c, 0x32, 0x53, 0x69, 0x1d, 0x7f, 0x38, 0x3c, 0x9d,
+  0x45, 0x51, 0x71, 0xcd, 0x15, 0xff, 0x3a, 0x23, 0x29, 0x4f, 0x99, 0x77, 0xf6, 0x01, 0x7a, 0x51,
+  0xa3, 0x00, 0x27, 0x38, 0x36, 0xcf, 0x85, 0x44, 0x90, 0x8c, 0xc7, 0xc6, 0x77, 0x74, 0xf8, 0xc8,
+  0xf8, 0x17, 0x06, 0x5b, 0xf5, 0x8a, 0xda, 0xdd, 0x19, 0xbb, 0x1e, 0x1b, 0xb3, 0x2a, 0x01, 0x81,
+  0x05, 0x51, 0xc9, 0x61, 0xa8, 0x14, 0x91, 0x0c, 0x83, 0x43, 0xe9, 0x2b, 0x70, 0xb6, 0x44, 0xbf,
+  0xd9, 0x54, 0xe3, 0xf8, 0x64, 0x76, 0xe8, 0xaf, 0xeb, 0xcf, 0x69, 0xa6, 0x72, 0xc1, 0xea, 0x2b,
+  0x47, 0x4f, 0xe9, 0xe9, 0xd1, 0x71, 0xd3, 0xca, 0x66, 0xe4, 0x03, 0x76, 0xca, 0x0e, 0x8f, 0x2a,
+  0xeb, 0x15, 0x93, 0x6a, 0xe3, 0x9e, 0xa2, 0xf9, 0xc1, 0xf0, 0xb4, 0x0c, 0x97, 0xd1, 0xc1, 0xe8,
+  0x78, 0xf4, 0x6c, 0x63, 0x5b, 0xf3, 0x19, 0x6c, 0x48, 0x9f, 0x0e, 0x4b, 0x7e, 0x90, 0x8a, 0x2a,
+  0xd9, 0x47, 0x9f, 0xd9, 0xdb, 0x6f, 0x05, 0xcb, 0x18, 0x55, 0x9d, 0x51, 0x0f, 0x7d, 0xaa, 0x6b,
+  0xdd, 0xf7, 0xe0, 0x78, 0xbb, 0xfb, 0xea, 0x43, 0x40, 0x73, 0x11, 0x6e, 0x28, 0x7c, 0x4a, 0x47,
+  0xb3, 0xa7, 0x75, 0x8f, 0x28, 0x7d, 0xe0, 0x78, 0x9b, 0xff, 0x35, 0xb1, 0x87, 0x7f, 0xd8, 0x2d,
+  0x4d, 0x72, 0xe6, 0x48, 0xd5, 0x7a, 0x45, 0x70, 0xcc, 0x56, 0xd6, 0x4f, 0xd6, 0x36, 0x8c, 0x67,
+  0x3c, 0x09, 0x37, 0x9c, 0xc3, 0xe2, 0x24, 0x7c, 0x01, 0xd4, 0x3b, 0x47, 0x27, 0xa9, 0x8b, 0x7d,
+  0x78, 0x74, 0x48, 0x8f, 0x86, 0x5f, 0x21, 0x76, 0xdd, 0x3e, 0x15, 0xce, 0x5f, 0xf1, 0x94, 0xcb,
+  0x8c, 0xce, 0x59, 0xd5, 0x99, 0x8f, 0x3c, 0xa2, 0x09, 0xd9, 0x2c, 0xdf, 0x2a, 0xd5, 0xc9, 0xfc,
+  0xf4, 0xf8, 0x34, 0xfc, 0x3f, 0x49, 0x35, 0x32, 0x1b, 0x4b, 0x46, 0x1c, 0x1d, 0x55, 0x88, 0xb6,
+  0x0f, 0x5b, 0x4d, 0x4a, 0xb1, 0xa2, 0x47, 0x5c, 0xac, 0xfa, 0x28, 0x6b, 0xa6, 0x33, 0x51, 0x85,
+  0x7c, 0x8d, 0x68, 0x66, 0x61, 0x42, 0x67, 0x55, 0x0e, 0x9d, 0x25, 0x7c, 0x7e, 0xb3, 0xc1, 0xd7,
+  0x7a, 0x47, 0xc3, 0x5d, 0x1a, 0x10, 0xc9, 0x12, 0xb0, 0x11, 0xa6, 0xde, 0x2c, 0x57, 0x75, 0x1e,
+  0x2f, 0x2c, 0xb2, 0x8d, 0xc9, 0xe6, 0xf3, 0xf9, 0x86, 0xa1, 0x8e, 0x8a, 0x34, 0x17, 0xff, 0xa2,
+  0x37, 0xdb, 0x79, 0x18, 0x2a, 0x54, 0x5c, 0x02, 0x15, 0xd5, 0x7c, 0x4e, 0x9b, 0x89, 0x83, 0xf9,
+  0x62, 0x05, 0xaa, 0x0c, 0x83, 0xa7, 0xc7, 0x85, 0x26, 0x8a, 0x67, 0x96, 0xcb, 0x70, 0xfb, 0x64,
+  0x60, 0x2b, 0x82, 0xc9, 0xc0, 0x54, 0x23, 0x13, 0x2c, 0x0b, 0xe0, 0x47, 0x18, 0xdf, 0x92, 0x79,
+  0x42, 0xa5, 0x9c, 0xb6, 0x8a, 0x24, 0x68, 0x4a, 0x88, 0xe5, 0x81, 0x57, 0xa9, 0x5c, 0x31, 0x60,
+  0x44, 0x38, 0xa4, 0x2c, 0x59, 0x60, 0xfa, 0x09, 0x2e, 0xf3, 0x00, 0x6a, 0xb9, 0xb4, 0x65, 0xea,
+  0x8f, 0x49, 0xbc, 0x5a, 0x90, 0x38, 0x9c, 0xb6, 0x4c, 0xda, 0x6b, 0x11, 0x29, 0xe6, 0xd3, 0xd6,
+  0x60, 0x75, 0x9d, 0xb1, 0x45, 0x8b, 0x00, 0x2b, 0x0b, 0xc1, 0x85, 0x9b, 0xfd, 0x9e, 0x26, 0x09,
+  0x7a, 0x5d, 0xa7, 0x6b, 0x84, 0x18, 0x00, 0xfc, 0xc6, 0x39, 0x25, 0xa9, 0xb8, 0x23, 0x6a, 0x93,
+  0x9a, 0x0c, 0x5a, 0xe7, 0x38, 0x7c, 0xfe, 0xd2, 0x30, 0x62, 0x48, 0x5e, 0xaf, 0xe8, 0x82, 0x49,
+  0x83, 0xa8, 0x37, 0xa0, 0x4c, 0x96, 0x2f, 0xc3, 0x97, 0xe0, 0xe4, 0x58, 0x68, 0x79, 0x18, 0x3a,
+  0xc6, 0x5b, 0xe7, 0x43, 0xbb, 0xc3, 0x48, 0xb2, 0xeb, 0xb4, 0x2b, 0x20, 0x0b, 0xa2, 0x38, 0xf9,
+  0x00, 0x1e, 0xb2, 0x10, 0x74, 0x55, 0x3b, 0x4e, 0xc2, 0xf4, 0xfe, 0x47, 0x35, 0x6b, 0x5f, 0x49,
+  0xc8, 0x0d, 0x06, 0xf0, 0xc7, 0xf1, 0x1a, 0x0f, 0xcf, 0x2f, 0x69, 0x9a, 0xd3, 0x84, 0xbc, 0x34,
+  0x1b, 0xe1, 0xea, 0x0e, 0x8b, 0xd9, 0x59, 0x0e, 0xfe, 0x9e, 0xba, 0xad, 0x98, 0x54, 0xbd, 0x2c,
+  0x82, 0xb7, 0x33, 0x4f, 0xe2, 0xf9, 0x4d, 0x61, 0xa7, 0x9f, 0xf8, 0x1a, 0x6f, 0xc6, 0xda, 0xd4,
+  0x98, 0x94, 0xc0, 0xe0, 0x64, 0x60, 0x80, 0x76, 0xe0, 0x62, 0xda, 0xf0, 0x40, 0xf1, 0xa3, 0x33,
+  0x14, 0xc2, 0x7e, 0xc0, 0x64, 0x54, 0x5a, 0x6e, 0x2f, 0xc8, 0x4d, 0x51, 0x67, 0x90, 0xba, 0x95,
+  0x15, 0xf4, 0x05, 0xfe, 0x4e, 0xee, 0x8e, 0x77, 0x83, 0x79, 0x00, 0x82, 0x45, 0x82, 0xc9, 0xe5,
+  0x95, 0x76, 0x48, 0x44, 0x79, 0x6f, 0x06, 0x88, 0x19, 0xf9, 0x22, 0x2c, 0x9e, 0xb1, 0xf4, 0x15,
+  0xb2, 0x2a, 0xe2, 0xbc, 0x85, 0x0f, 0x64, 0xa0, 0x49, 0x76, 0x03, 0xc4, 0xbb, 0x40, 0x8c, 0x73,
+  0x30, 0x46, 0x9c, 0x69, 0x92, 0x4d, 0x18, 0x81, 0xea, 0x4c, 0x01, 0x29, 0x00, 0xed, 0x28, 0xfc,
+  0x29, 0x7b, 0x9a, 0xfa, 0xfa, 0x56, 0x4e, 0xb2, 0xe6, 0xe9, 0x6f, 0xff, 0xfa, 0x8f, 0xd2, 0xdc,
+  0x08, 0x31, 0xc1, 0xc8, 0x3d, 0xcf, 0x85, 0xe1, 0x26, 0x19, 0xf8, 0x7e, 0x5b, 0xb8, 0xd3, 0x2e,
+  0x87, 0xf9, 0x0e, 0xe0, 0x57, 0x54, 0x27, 0x81, 0x2b, 0x7b, 0x66, 0xc5, 0x6b, 0xbc, 0xcd, 0x25,
+  0xef, 0x16, 0x08, 0xb0, 0x40, 0xb3, 0x6c, 0xe1, 0x26, 0x97, 0x3c, 0x64, 0x67, 0x93, 0x81, 0x19,
+  0x2c, 0x17, 0x19, 0x16, 0xf5, 0xc3, 0x10, 0x17, 0x6a, 0xe3, 0x2d, 0x69, 0xba, 0x80, 0x0e, 0x28,
+  0xcf, 0x42, 0x28, 0x0d, 0x70, 0xd4, 0xf2, 0x41, 0xb1, 0x97, 0x67, 0x5a, 0x3a, 0x1d, 0x38, 0xd3,
+  0xd6, 0xb0, 0x75, 0x7e, 0xc9, 0xf5, 0xc0, 0x2b, 0xa6, 0x4c, 0xf6, 0x9a, 0x0c, 0xcc, 0x92, 0x47,
+  0x76, 0x1d, 0xa0, 0x91, 0x57, 0x8c, 0xbc, 0xa0, 0x92, 0x85, 0x7b, 0xac, 0x1f, 0xc1, 0x29, 0xf1,
+  0x1d, 0x30, 0x09, 0x0a, 0xb4, 0xb9, 0x1e, 0x28, 0x56, 0x2b, 0x54, 0x58, 0xc9, 0x33, 0xf7, 0xfe,
+  0x36, 0xd3, 0x12, 0xbd, 0xc6, 0x8a, 0x03, 0x4e, 0x85, 0x92, 0x3c, 0x4e, 0x73, 0x08, 0x93, 0x6e,
+  0x83, 0xf9, 0x4c, 0xf2, 0x51, 0xf7, 0x19, 0x88, 0x96, 0xe6, 0xab, 0x19, 0x10, 0xae, 0xb6, 0xa5,
+  0x02, 0x04, 0x07, 0xd0, 0x22, 0x00, 0x80, 0x9a, 0x62, 0x2e, 0x85, 0x9f, 0xd0, 0xc1, 0xb4, 0x9c,
+  0x3a, 0xc7, 0xad, 0xdf, 0x27, 0xa9, 0xb5, 0x38, 0x30, 0x1e, 0x96, 0xba, 0xb7, 0x98, 0x81, 0x1e,
+  0x17, 0x52, 0xe0, 0xa5, 0x1a, 0x19, 0x57, 0x7a, 0xef, 0x87, 0x25, 0xfa, 0x2f, 0xe4, 0x55, 0x27,
+  0xa6, 0x16, 0x4f, 0x4b, 0x0a, 0xfd, 0xa3, 0x2f, 0xaa, 0xfe, 0x20, 0x15, 0xcb, 0xec, 0x22, 0xef,
+  0x04, 0xcb, 0xba, 0x85, 0x0c, 0xe0, 0x57, 0xe0, 0xd0, 0x8e, 0x6d, 0xdd, 0xf0, 0xdf, 0x0c, 0xc3,
+  0x5e, 0x42, 0x28, 0xe5, 0x10, 0xc1, 0xb8, 0xc4, 0xa7, 0xf4, 0xaf, 0xb5, 0xc1, 0x3b, 0xc1, 0xfa,
+  0xec, 0x16, 0x39, 0x5f, 0x60, 0x80, 0x76, 0x7e, 0x7c, 0xd1, 0x83, 0x06, 0x75, 0x4a, 0x78, 0x14,
+  0x7d, 0xc9, 0x95, 0xe1, 0xe6, 0x1f, 0x5f, 0x58, 0x2b, 0x38, 0x13, 0x1c, 0x0d, 0x9f, 0x9d, 0x38,
+  0xa5, 0x4f, 0x8e, 0x0a, 0x5b, 0x40, 0x67, 0xb6, 0x29, 0xc7, 0xf7, 0x40, 0x98, 0x4c, 0x92, 0x19,
+  0x03, 0x61, 0x19, 0x19, 0x10, 0x1a, 0xc1, 0xfd, 0x13, 0x63, 0xe5, 0x2f, 0x90, 0x23, 0x13, 0xcc,
+  0x20, 0xd5, 0x44, 0x79, 0x56, 0x9c, 0x7e, 0xd8, 0xda, 0x07, 0x86, 0x4b, 0xb5, 0x03, 0x67, 0x54,
+  0xbb, 0xc2, 0x2a, 0xf7, 0xbd, 0xd7, 0x25, 0x50, 0x79, 0x91, 0x68, 0x9f, 0x9f, 0x25, 0xe4, 0x9a,
+  0xd6, 0x79, 0x7f, 0x8f, 0xcb, 0x7b, 0x8c, 0x90, 0x25, 0xbd, 0x65, 0x8e, 0xd3, 0x90, 0x54, 0xae,
+  0xe0, 0xb3, 0x47, 0x72, 0xbb, 0x58, 0xd9, 0xad, 0x24, 0x14, 0xec, 0x4c, 0xb3, 0x2c, 0x89, 0x81,
+  0x0f, 0xe2, 0x95, 0x6e, 0xa0, 0x15, 0x4b, 0xee, 0x09, 0x85, 0x3e, 0x6f, 0x1d, 0x27, 0x09, 0xdc,
+  0x05, 0xc9, 0x98, 0x90, 0x31, 0x5c, 0x60, 0x48, 0xc0, 0xcb, 0x85, 0x82, 0xd9, 0x8e, 0x5a, 0x0a,
+  0xa8, 0x30, 0x13, 0x18, 0xba, 0xb8, 0x78, 0xf7, 0xfe, 0xed, 0x25, 0x59, 0x43, 0x55, 0xc5, 0xba,
+  0x0d, 0x34, 0xbd, 0x2d, 0xfd, 0x7b, 0x7d, 0x83, 0x4b, 0xfe, 0xc8, 0xd8, 0x73, 0xe3, 0xe7, 0xe4,
+  0x0d, 0x5f, 0x94, 0x54, 0xad, 0x83, 0x63, 0x02, 0x95, 0x15, 0x4f, 0x17, 0xe7, 0x6f, 0x28, 0xa4,
+  0x42, 0x4b, 0xc9, 0x67, 0x58, 0x0f, 0xea, 0x51, 0xcf, 0xca, 0x80, 0xaf, 0xec, 0x3c, 0xb2, 0x50,
+  0xeb, 0xfc, 0x27, 0x70, 0x6d, 0xb1, 0x69, 0xef, 0xad, 0xa8, 0xe4, 0x03, 0xb8, 0xc2, 0x4e, 0x68,
+  0x58, 0x03, 0xd0, 0x50, 0xf7, 0xed, 0x83, 0xec, 0xaa, 0x01, 0xf2, 0x9e, 0xc9, 0x3c, 0x51, 0x5b,
+  0xc1, 0xdd, 0x3a, 0xb3, 0x6c, 0x3f, 0xd1, 0x5f, 0xe6, 0x42, 0x60, 0xe8, 0xda, 0xf4, 0xb4, 0x09,
+  0x3c, 0x37, 0x0b, 0x74, 0x56, 0x6a, 0x48, 0x30, 0x8f, 0x82, 0xbf, 0xd2, 0x6f, 0x74, 0xe4, 0xe7,
+  0x0c, 0xe9, 0xb8, 0x11, 0x3d, 0xd7, 0x53, 0x50, 0xf5, 0xc9, 0x3a, 0x54, 0xf3, 0xc5, 0x57, 0x9a,
+  0x33, 0xef, 0xea, 0x0b, 0x13, 0xbd, 0x32, 0x85, 0x85, 0x7f, 0xf9, 0x26, 0x21, 0xd8, 0x05, 0x7a,
+  0x1e, 0x4d, 0x4f, 0x34, 0x14, 0x54, 0x08, 0x11, 0x27, 0xf7, 0x4c, 0x05, 0x41, 0x50, 0x3f, 0xda,
+  0x49, 0x30, 0x91, 0x73, 0x11, 0x67, 0x3a, 0xa5, 0x0d, 0x06, 0xe4, 0xb7, 0xff, 0xfe, 0x9b, 0x00,
+  0x45, 0x20, 0xdf, 0x49, 0x32, 0xc0, 0xca, 0x35, 0x97, 0x24, 0xe3, 0x49, 0x82, 0xdc, 0x17, 0x09,
+  0xbe, 0xd2, 0x25, 0x08, 0x7a, 0x34, 0x0e, 0xe4, 0x92, 0xb9, 0x2a, 0xa4, 0x5a, 0xc7, 0x00, 0x58,
+  0xc2, 0x20, 0xef, 0xcb, 0x0b, 0x5b, 0xd7, 0x4c, 0x49, 0x44, 0x13, 0xc9, 0xc6, 0x76, 0x02, 0x97,
+  0xa1, 0x03, 0x0a, 0x98, 0x48, 0xf3, 0x24, 0x19, 0xa3, 0x25, 0xa2, 0x3c, 0x35, 0x5d, 0x29, 0x14,
+  0x41, 0x76, 0x5f, 0x87, 0xa7, 0x5d, 0xf2, 0x59, 0xeb, 0xea, 0x63, 0xf1, 0x74, 0x6c, 0xc6, 0x22,
+  0xd2, 0x29, 0xa0, 0xba, 0x60, 0x45, 0x46, 0x05, 0xfe, 0xce, 0x73, 0xe5, 0x8d, 0x97, 0x6b, 0x4b,
+  0x34, 0xad, 0xac, 0x2d, 0xb1, 0x60, 0x97, 0x34, 0x92, 0x03, 0x9d, 0x42, 0x6d, 0x65, 0x98, 0x55,
+  0xeb, 0x26, 0xa1, 0xc5, 0x92, 0x44, 0xbf, 0x0f, 0xd1, 0xb9, 0x55, 0x0c, 0xff, 0xf8, 0xf2, 0x83,
+  0xb4, 0xee, 0xcc, 0x4e, 0x97, 0x4c, 0xcf, 0xa1, 0x7f, 0xdb, 0xd4, 0x9b, 0x3c, 0xf4, 0xc8, 0x09,
+  0xa4, 0x35, 0x2b, 0x0c, 0xf6, 0x6b, 0x0f, 0x15, 0x9d, 0xfd, 0x3a, 0xc8, 0xca, 0x08, 0x5d, 0x80,
+  0xb4, 0x22, 0x4d, 0x49, 0xc8, 0xe7, 0xf9, 0x0a, 0x6e, 0x25, 0x58, 0x80, 0x71, 0x12, 0x86, 0xbf,
+  0xbe, 0xb8, 0x7f, 0x1d, 0x76, 0xda, 0x5e, 0x5d, 0xd5, 0xee, 0x06, 0x9a, 0x7b, 0xcd, 0x19, 0xdb,
+  0x77, 0x94, 0x3e, 0x0f, 0x3b, 0xf0, 0x1d, 0xe4, 0xa5, 0x79, 0x7c, 0x26, 0x53, 0xab, 0xde, 0xc7,
+  0x76, 0x3d, 0x14, 0xda, 0x3d, 0xd2, 0x2e, 0x2b, 0x29, 0xfc, 0x54, 0xd6, 0x49, 0xed, 0x4f, 0x1f,
+  0x51, 0xc8, 0x4f, 0xe3, 0x2d, 0x4a, 0x79, 0xa9, 0xbb, 0xa6, 0x9b, 0x79, 0x63, 0x99, 0x42, 0x3f,
+  0x2d, 0x24, 0x16, 0x34, 0x9d, 0xad, 0x32, 0xd7, 0xaa, 0x09, 0xa7, 0x69, 0x0f, 0x1a, 0xf2, 0xee,
+  0x0e, 0x75, 0xeb, 0x25, 0xc2, 0x16, 0x9d, 0x8d, 0x2c, 0x13, 0x82, 0x85, 0x08, 0x79, 0x4e, 0xda,
+  0x7f, 0x8d, 0x17, 0xcb, 0x36, 0x39, 0x2b, 0xc6, 0xb1, 0x28, 0xd1, 0x13, 0xa6, 0xc0, 0xc0, 0xa9,
+  0xf6, 0x1b, 0xbe, 0x6e, 0x17, 0x5a, 0x83, 0x43, 0xbd, 0x81, 0xf8, 0x87, 0x5e, 0x1d, 0x9c, 0x05,
+  0xa5, 0x85, 0x0c, 0x92, 0xca, 0x35, 0xf8, 0xc8, 0x3a, 0x56, 0x4b, 0x42, 0xc9, 0x35, 0x9f, 0x91,
+  0xd7, 0xaf, 0xa0, 0x8c, 0x58, 0x2c, 0x15, 0xa1, 0x6b, 0x7a, 0x3f, 0xd6, 0x91, 0x45, 0xa0, 0x57,
+  0x8c, 0x13, 0x12, 0x63, 0xb8, 0x80, 0x16, 0x29, 0xf3, 0x2d, 0x28, 0xf2, 0xf4, 0x07, 0x3e, 0xeb,
+  0xe4, 0x22, 0xe9, 0x99, 0x77, 0x0d, 0x67, 0xc0, 0x88, 0xa9, 0xf9, 0x12, 0xc7, 0xbb, 0x56, 0xfe,
+  0x40, 0x2d, 0x59, 0xda, 0x11, 0xe8, 0x80, 0x22, 0xb8, 0x96, 0x3c, 0xed, 0x74, 0xab, 0x53, 0xd7,
+  0xda, 0x37, 0x8b, 0x94, 0x8c, 0xf1, 0xf0, 0xcd, 0x75, 0x00, 0x42, 0xe1, 0x1b, 0x30, 0x4d, 0x98,
+  0x50, 0x1d, 0xf3, 0x72, 0xf2, 0x27, 0xd2, 0x06, 0xdd, 0xe0, 0x47, 0xe7, 0x3a, 0xd0, 0x9d, 0x3b,
+  0xf9, 0xf5, 0x57, 0xd2, 0x8e, 0x28, 0xc4, 0x37, 0x18, 0xbe, 0x3b, 0x26, 0x82, 0x81, 0xc7, 0xa5,
+  0xee, 0xd1, 0xa2, 0xbc, 0x4e, 0xad, 0xcd, 0x94, 0x98, 0x28, 0x30, 0x02, 0xb6, 0x07, 0x70, 0xc0,
+  0x73, 0xa0, 0x28, 0xc4, 0x33, 0xa7, 0x79, 0xd5, 0xf7, 0x23, 0x32, 0x97, 0xd3, 0xb2, 0x2a, 0xb7,
+  0x93, 0x5d, 0xea, 0x67, 0x3a, 0xf0, 0x9e, 0xe9, 0x94, 0xb4, 0xff, 0x99, 0xb3, 0x1c, 0x84, 0x43,
+  0x41, 0x2b, 0xe3, 0x60, 0xbe, 0x14, 0xc2, 0xb0, 0x8d, 0x2a, 0x7a, 0x71, 0x8a, 0x82, 0xf6, 0xc8,
+  0x29, 0x86, 0x63, 0x83, 0x32, 0xf8, 0xa7, 0xd1, 0x1e, 0x32, 0x10, 0x3a, 0xf7, 0x58, 0x8f, 0x73,
+  0x7f, 0xac, 0x97, 0x6b, 0xae, 0xec, 0x54, 0xe6, 0x1e, 0xbc, 0x4f, 0x78, 0x66, 0x39, 0xfb, 0x50,
+  0xdc, 0xcd, 0x9c, 0xa2, 0x9d, 0x8c, 0xcd, 0x36, 0x4e, 0x15, 0x0c, 0x34, 0x03, 0xcb, 0x96, 0xc6,
+  0xdf, 0x88, 0x31, 0xbf, 0x6d, 0xb7, 0x66, 0xb2, 0x4e, 0xd3, 0x1e, 0xd8, 0xb9, 0x7e, 0x0a, 0x7e,
+  0x0a, 0x21, 0x6b, 0xd3, 0x73, 0xbb, 0x01, 0xa5, 0xda, 0xa7, 0xd7, 0x71, 0x70, 0xb6, 0xef, 0x72,
+  0x8c, 0xa6, 0x02, 0x18, 0x68, 0x82, 0x29, 0x1b, 0xf3, 0x3a, 0x84, 0x9e, 0x79, 0x9e, 0x4e, 0x8f,
+  0x71, 0xbb, 0xee, 0xd9, 0xbd, 0xfd, 0x10, 0x3a, 0xe6, 0xb1, 0x88, 0xdc, 0x30, 0x06, 0x84, 0x9b,
+  0xe5, 0x72, 0x69, 0x12, 0x0e, 0x56, 0x98, 0x63, 0x4c, 0x44, 0xfa, 0xeb, 0x14, 0x20, 0x70, 0x46,
+  0x7e, 0x78, 0x77, 0xf1, 0x17, 0xac, 0xbb, 0x9c, 0x71, 0xba, 0x18, 0x37, 0xe0, 0x29, 0x06, 0x27,
+  0xb2, 0xaf, 0x4b, 0x90, 0x8f, 0xa0, 0x13, 0x87, 0x61, 0x82, 0xdf, 0xb1, 0xc1, 0xea, 0x24, 0x5e,
+  0x99, 0x10, 0x03, 0xa4, 0xf9, 0x92, 0x85, 0x36, 0x13, 0xe9, 0x63, 0xdf, 0xde, 0x80, 0xdb, 0x2a,
+  0x61, 0x98, 0xb3, 0x8c, 0xbd, 0xea, 0x23, 0x81, 0xd5, 0x68, 0x3b, 0xcf, 0xe8, 0x75, 0xc0, 0x2e,
+  0x52, 0xcc, 0x31, 0x0a, 0x1c, 0x32, 0x50, 0x86, 0x51, 0xee, 0xb9, 0x9a, 0x6a, 0xd6, 0xb0, 0xda,
+  0xe0, 0xc7, 0x2e, 0x5c, 0xf3, 0x2b, 0x70, 0x9e, 0x20, 0x45, 0x9b, 0x6d, 0xda, 0xb3, 0xfe, 0x62,
+  0x66, 0x65, 0x28, 0x85, 0x2e, 0xb2, 0x2a, 0xf1, 0xfd, 0xbb, 0x22, 0x79, 0x8f, 0x8c, 0x8e, 0x6d,
+  0xe2, 0xa9, 0x82, 0x7b, 0x0f, 0x17, 0x16, 0x77, 0x1d, 0xa7, 0x21, 0x5f, 0x07, 0x38, 0x01, 0x57,
+  0xa6, 0x4b, 0x08, 0xbc, 0xae, 0x7f, 0xcc, 0x12, 0x9a, 0xde, 0x34, 0xdd, 0x77, 0xb5, 0xd4, 0xb6,
+  0x28, 0x5e, 0xfa, 0xd6, 0xe2, 0x75, 0xc7, 0x4f, 0x3c, 0xce, 0x77, 0x2f, 0x1c, 0x20, 0xbc, 0x0b,
+  0x6a, 0xcc, 0x1e, 0x67, 0x7b, 0x24, 0x81, 0x86, 0x54, 0xa7, 0x13, 0x40, 0xcf, 0xe2, 0xc4, 0xb6,
+  0x25, 0xde, 0x07, 0xcb, 0x6f, 0xa1, 0x1b, 0xc1, 0x94, 0xcb, 0x35, 0x67, 0xbf, 0x33, 0x3d, 0x39,
+  0x40, 0xd3, 0x01, 0xee, 0x83, 0x66, 0x56, 0x36, 0x82, 0x14, 0xed, 0xdb, 0x3e, 0x38, 0xc5, 0xe2,
+  0x66, 0xa8, 0xa2, 0x85, 0xdb, 0x0b, 0xab, 0x58, 0x5d, 0x01, 0x33, 0xd5, 0x8c, 0xbd, 0x60, 0x47,
+  0xf9, 0xe8, 0x15, 0x7d, 0x77, 0xcf, 0xe0, 0x40, 0xc5, 0x3d, 0x33, 0xb5, 0xe4, 0x60, 0xcf, 0xf6,
+  0xbb, 0xb7, 0x57, 0x1f, 0xda, 0x4e, 0x0e, 0x7c, 0xac, 0x86, 0x2e, 0xea, 0x8c, 0x7c, 0x6e, 0xdb,
+  0x9c, 0xdc, 0xc7, 0x06, 0x02, 0x39, 0x57, 0x77, 0x5f, 0x73, 0x9d, 0x4c, 0x07, 0x98, 0x1e, 0xda,
+  0x0f, 0x6e, 0x13, 0x3e, 0x6d, 0x9f, 0x91, 0x1f, 0xae, 0xde, 0xfe, 0x04, 0x74, 0x8f, 0xf6, 0x8a,
+  0xa3, 0xfb, 0x8e, 0x3b, 0xd2, 0x4a, 0xd5, 0xad, 0xa4, 0x17, 0xcc, 0xf9, 0x90, 0x5e, 0xec, 0x98,
+  0xe6, 0x71, 0x3f, 0xb1, 0x18, 0xea, 0x6d, 0x63, 0xaf, 0x18, 0x1a, 0xb6, 0xaf, 0x71, 0x7d, 0x13,
+  0xcb, 0x3f, 0x54, 0x29, 0xcc, 0x96, 0xcd, 0xc8, 0x5e, 0x4c, 0x53, 0x12, 0x04, 0x0a, 0x64, 0x44,
+  0x5b, 0x45, 0x43, 0x7f, 0x0a, 0x36, 0xc3, 0xe3, 0xe1, 0x57, 0x68, 0x14, 0xf5, 0x7c, 0xcc, 0x92,
+  0x10, 0x97, 0x52, 0x45, 0xcc, 0x8b, 0x58, 0x38, 0xb6, 0x60, 0xb5, 0xda, 0x5b, 0xd1, 0x1b, 0xc0,
+  0xd4, 0x5f, 0xc7, 0x99, 0x4a, 0x1b, 0xb7, 0x9b, 0x77, 0x09, 0x4b, 0x8e, 0xba, 0x7a, 0x58, 0xa7,
+  0x96, 0xd7, 0xec, 0x76, 0x08, 0xb2, 0x07, 0x57, 0x74, 0x27, 0xf1, 0x2d, 0x2b, 0x29, 0xc3, 0x0f,
+  0x63, 0xb4, 0xf3, 0xbd, 0x55, 0x2d, 0x64, 0x89, 0xa2, 0x2e, 0x94, 0xdf, 0xce, 0xae, 0xa1, 0xfe,
+  0x0b, 0xa0, 0x39, 0x89, 0x17, 0x90, 0x89, 0xf5, 0x8a, 0x1e, 0x31, 0x4b, 0xc6, 0x5e, 0x50, 0x83,
+  0x69, 0x28, 0x96, 0xc2, 0x7a, 0xc1, 0xae, 0xf2, 0xd3, 0x7f, 0x8f, 0xaf, 0x17, 0x63, 0x1a, 0x29,
+  0xa8, 0x2c, 0xd9, 0x5d, 0xde, 0xa9, 0x47, 0xa0, 0x8a, 0xe9, 0x1d, 0x30, 0xb5, 0xce, 0xb8, 0x19,
+  0xac, 0xb6, 0xe8, 0x0b, 0x20, 0xd1, 0xa1, 0x77, 0x42, 0xc2, 0xa2, 0x3d, 0x20, 0xab, 0x7d, 0xf0,
+  0x76, 0xd4, 0xea, 0xba, 0xaf, 0xef, 0x09, 0xec, 0x95, 0x94, 0x0b, 0x76, 0x40, 0x55, 0x7a, 0xd1,
+  0x66, 0xb0, 0xca, 0x92, 0x1d, 0x70, 0xa6, 0x87, 0x6e, 0xc6, 0x31, 0x73, 0xbe, 0x23, 0x66, 0x33,
+  0x37, 0x07, 0xe4, 0x37, 0xcb, 0xa3, 0x88, 0xe9, 0xea, 0xd5, 0x04, 0xc1, 0x23, 0xa7, 0x14, 0xcf,
+  0x4f, 0x5b, 0xba, 0x83, 0x6c, 0x16, 0x40, 0x43, 0x18, 0xfe, 0xf8, 0x02, 0xeb, 0xb2, 0x01, 0xd2,
+  0x03, 0x8c, 0x40, 0x5a, 0xe6, 0xc0, 0x4e, 0x6e, 0x98, 0xe0, 0xd3, 0xa0, 0x9d, 0x32, 0x95, 0x8b,
+  0x1e, 0xb5, 0xbf, 0x76, 0x60, 0xc6, 0x82, 0x5d, 0x52, 0xb5, 0x0c, 0xf4, 0x77, 0xae, 0x9d, 0x0e,
+  0xac, 0x5d, 0xc6, 0xd0, 0x66, 0x8a, 0xfb, 0x4b, 0x89, 0x92, 0x0e, 0xbb, 0x64, 0xa0, 0x7b, 0x8d,
+  0xae, 0xde, 0x2c, 0xbb, 0x1a, 0xd2, 0x6e, 0xec, 0x14, 0xc8, 0xef, 0x98, 0xb8, 0xd0, 0xc1, 0xaf,
+  0xb7, 0x04, 0x8a, 0x7f, 0x8f, 0xed, 0x58, 0xe7, 0xa0, 0xeb, 0x1d, 0x69, 0xf8, 0xa8, 0x6d, 0xc9,
+  0xd9, 0x36, 0xf7, 0xd0, 0x60, 0xb4, 0x55, 0xd1, 0xc4, 0x1b, 0x1a, 0xc1, 0xe7, 0x4f, 0xcb, 0x2a,
+  0xa6, 0xa3, 0x97, 0x5e, 0x1f, 0x6f, 0x3b, 0x85, 0xa2, 0xa5, 0x2d, 0x3b, 0xe8, 0x2f, 0xc9, 0xd3,
+  0xb5, 0xc8, 0x2e, 0xdd, 0xe8, 0x31, 0x47, 0x6a, 0x48, 0xd1, 0x85, 0x07, 0x79, 0x73, 0x3b, 0x81,
+  0xb6, 0x64, 0x67, 0x87, 0x55, 0x9b, 0xde, 0x09, 0x57, 0x4d, 0xcf, 0xd8, 0xbe, 0xce, 0x02, 0x33,
+  0xb6, 0x73, 0xeb, 0x46, 0x46, 0x36, 0xbb, 0x8b, 0xe1, 0xdd, 0x00, 0x1b, 0x69, 0xd8, 0x22, 0x14,
+  0xe3, 0xb5, 0x7c, 0xe5, 0xf7, 0xde, 0xd5, 0x29, 0xf3, 0xd6, 0xf0, 0xf8, 0x7b, 0x84, 0x4b, 0x77,
+  0x95, 0xa6, 0xb3, 0x6d, 0x73, 0x53, 0x7b, 0xef, 0xd6, 0xd3, 0xcb, 0x2f, 0x8d, 0x7d, 0xcf, 0xe7,
+  0x87, 0xc6, 0xda, 0x97, 0x0a, 0xa5, 0x9d, 0xbc, 0x14, 0x40, 0xbb, 0xa2, 0xad, 0x52, 0xf5, 0xd4,
+  0x15, 0xcf, 0xc5, 0x9c, 0x75, 0x5d, 0x17, 0xe7, 0x31, 0x01, 0xc3, 0xe4, 0x97, 0xb2, 0x35, 0xf1,
+  0xd6, 0x81, 0xe8, 0x26, 0x47, 0xb7, 0xad, 0xde, 0x4c, 0x06, 0x34, 0x0c, 0xf5, 0x8a, 0x37, 0xf8,
+  0x8c, 0x9b, 0x32, 0x81, 0x85, 0xbc, 0xd6, 0xae, 0x47, 0x98, 0x79, 0xcd, 0xb1, 0x79, 0x53, 0xf7,
+  0x07, 0x95, 0xbc, 0x5a, 0xc9, 0x9b, 0xba, 0x16, 0xd1, 0x75, 0x54, 0x87, 0x05, 0xe8, 0x57, 0xd8,
+  0x29, 0x3f, 0x3c, 0x76, 0x8e, 0x4e, 0xa3, 0xee, 0x98, 0x1d, 0x50, 0x25, 0x8e, 0xfd, 0x36, 0xbd,
+  0xe8, 0xb3, 0x3f, 0x57, 0xf3, 0x3a, 0x14, 0x63, 0x26, 0xd8, 0x31, 0xb0, 0x67, 0x82, 0xaf, 0xa5,
+  0xee, 0x94, 0xc0, 0x26, 0x29, 0x64, 0x72, 0x49, 0x66, 0xf7, 0x24, 0x56, 0x92, 0x25, 0x11, 0xc9,
+  0xd3, 0x84, 0x49, 0x6c, 0x87, 0x22, 0x64, 0x36, 0xaf, 0x8e, 0xb9, 0xa4, 0xe2, 0xa6, 0xf8, 0x42,
+  0x12, 0x2e, 0xa2, 0x78, 0xfe, 0xe2, 0x58, 0x5c, 0x94, 0xaf, 0x52, 0x17, 0xc9, 0xde, 0xef, 0x52,
+  0xe3, 0x62, 0xa3, 0xab, 0xd1, 0x1f, 0xdf, 0x5c, 0x0d, 0xfd, 0x72, 0x37, 0x14, 0xe5, 0x8f, 0x6f,
+  0xdc, 0x08, 0xf5, 0x72, 0x2f, 0x86, 0xe8, 0x45, 0x82, 0x57, 0xf7, 0xd1, 0x85, 0x30, 0x70, 0x6b,
+  0x19, 0x91, 0xf8, 0xa1, 0x8c, 0xae, 0x4f, 0xc1, 0x8a, 0x66, 0x9d, 0x38, 0x44, 0x13, 0x6f, 0x3b,
+  0x2d, 0x0e, 0xbb, 0xa6, 0xb7, 0xf9, 0x68, 0xcc, 0xd1, 0xf3, 0xb4, 0xeb, 0x19, 0x59, 0x7b, 0x24,
+  0x08, 0x02, 0x7b, 0xf2, 0x27, 0xfc, 0x17, 0x2c, 0x17, 0xd0, 0x7c, 0x76, 0xa0, 0xbd, 0x2f, 0x4a,
+  0x4f, 0x96, 0x34, 0xb8, 0x46, 0x04, 0x27, 0xa2, 0x44, 0xe6, 0x8a, 0xbd, 0x86, 0x0a, 0x9d, 0xb0,
+  0x70, 0x86, 0xa6, 0x9d, 0xfa, 0x35, 0xf6, 0xab, 0x76, 0x9a, 0xfa, 0xf3, 0xab, 0xb6, 0xce, 0x92,
+  0x5c, 0x34, 0x6d, 0x34, 0xed, 0x9f, 0x89, 0x6d, 0x63, 0xa9, 0x2f, 0xe0, 0xe8, 0xed, 0xba, 0x6d,
+  0x50, 0x9b, 0xc1, 0xb6, 0x19, 0x4e, 0x7b, 0x75, 0xc2, 0x69, 0xd8, 0xd3, 0xdf, 0xd4, 0xa4, 0xdc,
+  0x15, 0xc8, 0xc5, 0x97, 0xe9, 0xb5, 0x97, 0x6a, 0x10, 0xd8, 0xf9, 0x5a, 0xf9, 0x82, 0x8b, 0x44,
+  0x83, 0x81, 0xd5, 0xad, 0x17, 0xfe, 0xf8, 0x92, 0x7b, 0xe4, 0x5e, 0x72, 0x1b, 0xb6, 0x36, 0xa4,
+  0x4c, 0xf2, 0xc7, 0x3f, 0x92, 0x6f, 0x6c, 0xcf, 0xde, 0xad, 0x3f, 0x2b, 0x68, 0xe3, 0x14, 0x3d,
+  0xfa, 0x93, 0x8d, 0x46, 0xa3, 0xca, 0x83, 0xe3, 0x46, 0x5e, 0xaf, 0x31, 0xfa, 0x64, 0xe0, 0xde,
+  0xf4, 0x27, 0x03, 0xfb, 0x6f, 0x80, 0x06, 0xe6, 0xdf, 0x29, 0xff, 0x0f, 0x7a, 0x91, 0xb4, 0xa3,
+  0xc0, 0x2c, 0x00, 0x00,
+};
+
+static_assert(sizeof(INDEX_HTML) - 1 == INDEX_HTML_SOURCE_LEN,
+              "html_page.h changed: run tools/gzip_html.py");
+
+#endif
@@ -0,0 +1,279 @@
+#ifndef LIVE_EVENTS_H
+#define LIVE_EVENTS_H
+
+// ------------ Live dashboard push (/events) ------------
+// Server-Sent Events instead of a /status poll every 4 s. A new client gets
+// the full status once (`event: status`), after that `event: delta` carries
+// only the top-level /status fields whose value changed. Every
+// SSE_COALESCE_MS the web task rebuilds the status document and compares a
+// CRC32 per field with what was pushed last, so a burst of captures, uploads
+// or motion checks becomes one small event. The uptime rides along with
+// every event and with a keep-alive every SSE_HEARTBEAT_MS, which is also
+// how dead sockets are found. The per-check motion telemetry (cost, gap,
+// box) differs on nearly every check, so it never triggers an event on its
+// own: it goes out with the next real change or heartbeat.
+//
+// One writer task sends each event to every client from the same buffer: a
+// stalled browser holds up the other event clients, never the web server or
+// loop(). The page polls /status instead while EventSource is missing, the
+// connection is down or SSE_MAX_CLIENTS are already connected.
+
+#ifndef SSE_MAX_CLIENTS
+#define SSE_MAX_CLIENTS 4
+#endif
+#ifndef SSE_COALESCE_MS
+#define SSE_COALESCE_MS 1000UL
+#endif
+#ifndef SSE_HEARTBEAT_MS
+#define SSE_HEARTBEAT_MS 15000UL
+#endif
+static_assert(SSE_MAX_CLIENTS <= WEB_JSON_SSE_CLIENTS, "raise WEB_JSON_SSE_CLIENTS: /debug lists every client");
+#define SSE_MAX_FIELDS 32                          // top-level /status keys tracked
+#define SSE_EVENT_MAX (STATUS_SNAPSHOT_MAX + 64)
+#define SSE_WRITER_STACK 3072
+
+struct SseClient {
+  volatile bool active;  // false: the web task may claim it, true: the writer owns it
+  WiFiClient client;
+  char ip[16];
+  unsigned long sinceMs;
+  uint32_t events;
+  uint32_t bytes;
+};
+
+struct SseStats {
+  uint32_t connects = 0;
+  uint32_t rejected = 0;        // turned away at SSE_MAX_CLIENTS
+  uint32_t dropped = 0;         // write failed or peer gone
+  uint32_t events = 0;
+  uint32_t coalesced = 0;       // status changes folded into an earlier event
+  uint32_t writerBusy = 0;      // push due while the last event was still going out
+  uint32_t overflows = 0;
+  unsigned long lastBuildUs = 0;
+};
+
+static SseClient sseClients[SSE_MAX_CLIENTS];
+static volatile int sseClientCount = 0;
+static uint32_t sseFieldCrc[SSE_MAX_FIELDS];   // per /status field, as last pushed
+static uint32_t ssePushedVersion = 0;
+static char* sseEvent = nullptr;               // built by the web task, sent by the writer
+static size_t sseEventLen = 0;
+static volatile bool sseBusy = false;
+static unsigned long ssePushMs = 0;
+static unsigned long sseBeatMs = 0;
+static TaskHandle_t sseWriter = nullptr;
+static SseStats sseStats;
+
+class CrcPrint : public Print {
+ public:
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* p, size_t n) override {
+    crc = crc32Update(crc, p, n);
+    return n;
+  }
+  uint32_t crc = 0;
+};
+
+class FixedTextPrint : public Print {
+ public:
+  explicit FixedTextPrint(FixedText& t) : text(t) {}
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* p, size_t n) override {
+    text.add((const char*)p, n);
+    return n;
+  }
+
+ private:
+  FixedText& text;
+};
+
+static bool isUptimeField(JsonPair kv) {
+  return strcmp(kv.key().c_str(), "uptime") == 0;
+}
+
+// Jitters with every motion check; sent when changed, but never a reason to push
+static bool isJitterField(JsonPair kv) {
+  const char* k = kv.key().c_str();
+  return strcmp(k, "motionCostUs") == 0 || strcmp(k, "motionGapMs") == 0 || strcmp(k, "motionMaxGapMs") == 0 ||
+         strcmp(k, "motionBox") == 0;
+}
+
+// Web task. Length of the delta event in sseEvent, 0 when nothing changed.
+static size_t buildLiveDelta(bool heartbeat) {
+  unsigned long t0 = micros();
+  JsonDocument& doc = webJsonDoc;
+  doc.clear();
+  InlineText<24> uptime = uptimeText();
+  fillStatusDoc(doc, uptime.c_str());
+  noteWebJsonDoc();
+  JsonObject root = doc.as<JsonObject>();
+
+  uint32_t crc[SSE_MAX_FIELDS];
+  int fields = 0;
+  bool changed = false;
+  for (JsonPair kv : root) {
+    if (fields == SSE_MAX_FIELDS) break;
+    CrcPrint c;
+    serializeJson(kv.value(), c);
+    crc[fields] = c.crc;
+    if (crc[fields] != sseFieldCrc[fields] && !isUptimeField(kv) && !isJitterField(kv)) changed = true;
+    fields++;
+  }
+  if (!changed && !heartbeat) return 0;
+
+  FixedText ev(sseEvent, SSE_EVENT_MAX);
+  FixedTextPrint out(ev);
+  ev.add("event: delta\ndata: {");
+  int i = 0;
+  bool first = true;
+  for (JsonPair kv : root) {
+    if (i == fields) break;
+    if (crc[i] != sseFieldCrc[i] || isUptimeField(kv)) {
+      ev.add(first ? "\"" : ",\"").addJson(kv.key().c_str()).add("\":");
+      serializeJson(kv.value(), out);
+      first = false;
+    }
+    i++;
+  }
+  ev.add("}\n\n");
+  sseStats.lastBuildUs = micros() - t0;
+  if (!ev.ok()) {
+    sseStats.overflows++;
+    return 0;
+  }
+  memcpy(sseFieldCrc, crc, fields * sizeof(uint32_t));
+  return ev.length();
+}
+
+// Web task, after every handleClient()
+void liveEventsTick() {
+  if (sseClientCount == 0 || !sseEvent) return;
+  unsigned long now = millis();
+  if (now - ssePushMs < SSE_COALESCE_MS) return;
+  ssePushMs = now;
+  if (sseBusy) {
+    sseStats.writerBusy++;
+    return;
+  }
+
+  uint32_t version = statusVersion;
+  size_t len = buildLiveDelta(now - sseBeatMs >= SSE_HEARTBEAT_MS);
+  if (len == 0) return;
+  if (version - ssePushedVersion > 1) sseStats.coalesced += version - ssePushedVersion - 1;
+  ssePushedVersion = version;
+  sseBeatMs = now;
+  sseEventLen = len;
+  sseBusy = true;
+  xTaskNotifyGive(sseWriter);
+}
+
+static void sseWriterTask(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+      SseClient& c = sseClients[i];
+      if (!c.active) continue;
+      if (c.client.connected() && mjpegWriteAll(c.client, (const uint8_t*)sseEvent, sseEventLen)) {
+        c.events++;
+        c.bytes += sseEventLen;
+        continue;
+      }
+      Serial.printf("Event client %s left after %u events\n", c.ip, (unsigned)c.events);
+      c.client.stop();
+      c.client = WiFiClient();
+      sseStats.dropped++;
+      __atomic_sub_fetch(&sseClientCount, 1, __ATOMIC_RELAXED);
+      c.active = false;
+    }
+    sseStats.events++;
+    sseBusy = false;
+  }
+}
+
+// GET /events: the socket is handed to the writer task and the web server
+// moves on, as with /mjpeg.
+void handleEvents() {
+  if (!sseWriter) {
+    server.send(503, "text/plain", "Events not ready");
+    return;
+  }
+  SseClient* c = nullptr;
+  for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+    if (!sseClients[i].active) { c = &sseClients[i]; break; }
+  }
+  if (!c) {
+    sseStats.rejected++;
+    server.send(503, "text/plain", "Too many event clients");
+    return;
+  }
+  if (!buildStatusSnapshot()) {
+    sseStats.overflows++;
+    server.send(503, "text/plain", "Status too large");
+    return;
+  }
+
+  c->client = server.client();
+  c->client.setNoDelay(true);
+  strncpy(c->ip, c->client.remoteIP().toString().c_str(), sizeof(c->ip) - 1);
+  c->ip[sizeof(c->ip) - 1] = 0;
+  c->sinceMs = millis();
+  c->events = c->bytes = 0;
+
+  // retry: how long the browser waits before reconnecting on its own
+  static const char head[] =
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Type: text/event-stream\r\n"
+      "Cache-Control: no-cache\r\n"
+      "Connection: close\r\n\r\n"
+      "retry: 5000\n\n"
+      "event: status\ndata: ";
+  bool ok = mjpegWriteAll(c->client, (const uint8_t*)head, sizeof(head) - 1) &&
+            mjpegWriteAll(c->client, (const uint8_t*)statusSnap.json, statusSnap.len) &&
+            mjpegWriteAll(c->client, (const uint8_t*)"\n\n", 2);
+  if (!ok) {
+    c->client.stop();
+    c->client = WiFiClient();
+    return;
+  }
+
+  // The snapshot may be a few seconds old: the next delta resends every field
+  memset(sseFieldCrc, 0, sizeof(sseFieldCrc));
+  sseStats.connects++;
+  __atomic_add_fetch(&sseClientCount, 1, __ATOMIC_RELAXED);
+  c->active = true;
+  Serial.printf("Event client %s joined (%d connected)\n", c->ip, (int)sseClientCount);
+}
+
+// Called from setup() before startWebServer()
+void startLiveEvents() {
+  sseEvent = (char*)uploadAlloc(SSE_EVENT_MAX);
+  if (!sseEvent) return;
+  xTaskCreatePinnedToCore(sseWriterTask, "events", SSE_WRITER_STACK, nullptr, 1, &sseWriter, 0);
+}
+
+void fillLiveEventStats(JsonObject o) {
+  o["clients"] = sseClientCount;
+  o["coalesceMs"] = SSE_COALESCE_MS;
+  o["connects"] = sseStats.connects;
+  o["rejected"] = sseStats.rejected;
+  o["dropped"] = sseStats.dropped;
+  o["events"] = sseStats.events;
+  o["coalesced"] = sseStats.coalesced;
+  o["writerBusy"] = sseStats.writerBusy;
+  o["overflows"] = sseStats.overflows;
+  o["lastBuildUs"] = sseStats.lastBuildUs;
+
+  JsonArray a = o.createNestedArray("connected");
+  unsigned long now = millis();
+  for (int i = 0; i < SSE_MAX_CLIENTS; i++) {
+    const SseClient& c = sseClients[i];
+    if (!c.active) continue;
+    JsonObject e = a.createNestedObject();
+    e["ip"] = (const char*)c.ip;
+    e["events"] = c.events;
+    e["bytes"] = c.bytes;
+    e["seconds"] = (now - c.sinceMs) / 1000UL;
+  }
+}
+
+#endif
@@ -0,0 +1,189 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+// ------------ Per-stage latency histograms ------------
+// Hot paths (camera grab, sensor profile switch, motion analysis, TLS
+// handshake, upload, getUpdates, command handling) record their duration into fixed log2
+// buckets in RAM: one micros() pair, a count-leading-zeros and a few adds
+// under a spinlock, i.e. a couple of microseconds per event and no heap.
+// GET /metrics serves them in Prometheus text format; the Telegram
+// /metrics command sends a per-stage summary.
+
+#define METRIC_BUCKETS 20          // bucket b: <= 2^(b+7) us (128 us .. 67 s)
+#define METRIC_BUCKET_SHIFT 7
+
+enum MetricStage : uint8_t {
+  MET_CAMERA_GRAB,
+  MET_PROFILE_SWITCH,
+  MET_MOTION,
+  MET_TLS_CONNECT,
+  MET_UPLOAD,
+  MET_GET_UPDATES,
+  MET_COMMAND,
+  MET_STAGE_COUNT
+};
+
+static const char* const metricStageNames[MET_STAGE_COUNT] = {
+  "camera_grab", "profile_switch", "motion", "tls_connect", "upload", "get_updates", "command"
+};
+
+struct MetricHistogram {
+  uint32_t count;
+  uint32_t maxUs;
+  uint64_t sumUs;
+  uint32_t buckets[METRIC_BUCKETS + 1];   // last one: above the largest bound
+};
+
+static MetricHistogram metricHists[MET_STAGE_COUNT];
+static portMUX_TYPE metricMux = portMUX_INITIALIZER_UNLOCKED;
+
+static inline uint8_t metricBucket(uint32_t us) {
+  uint32_t v = (us - 1) >> METRIC_BUCKET_SHIFT;    // us == 0 lands in bucket 0
+  if (us == 0 || v == 0) return 0;
+  uint8_t b = 32 - __builtin_clz(v);
+  return b > METRIC_BUCKETS ? METRIC_BUCKETS : b;
+}
+
+void metricObserve(MetricStage stage, uint32_t us) {
+  uint8_t b = metricBucket(us);
+  portENTER_CRITICAL(&metricMux);
+  MetricHistogram& h = metricHists[stage];
+  h.count++;
+  h.sumUs += us;
+  if (us > h.maxUs) h.maxUs = us;
+  h.buckets[b]++;
+  portEXIT_CRITICAL(&metricMux);
+}
+
+// Times the enclosing scope
+class MetricTimer {
+ public:
+  explicit MetricTimer(MetricStage s) : stage(s), t0(micros()) {}
+  ~MetricTimer() { metricObserve(stage, micros() - t0); }
+
+ private:
+  MetricStage stage;
+  unsigned long t0;
+};
+
+static void metricSnapshot(MetricStage stage, MetricHistogram& out) {
+  portENTER_CRITICAL(&metricMux);
+  out = metricHists[stage];
+  portEXIT_CRITICAL(&metricMux);
+}
+
+// Upper bound (us) of the bucket holding the p-th percentile
+static uint32_t metricPercentileUs(const MetricHistogram& h, uint8_t pct) {
+  if (h.count == 0) return 0;
+  uint32_t want = (uint32_t)(((uint64_t)h.count * pct + 99) / 100);
+  uint32_t seen = 0;
+  for (uint8_t b = 0; b < METRIC_BUCKETS; b++) {
+    seen += h.buckets[b];
+    if (seen >= want) return 1UL << (b + METRIC_BUCKET_SHIFT);
+  }
+  return h.maxUs;
+}
+
+// ------------ Heap fragmentation ------------
+// Largest free block vs total free heap. loop() samples it every
+// HEAP_WATCH_MS and keeps the lowest largest block and the worst ratio since
+// boot; /debug and /metrics show them. A largest block that stays flat over
+// days of uptime means nothing is cutting the heap into small holes.
+#define HEAP_WATCH_MS 10000UL
+
+struct HeapWatch {
+  uint32_t minMaxAlloc = 0;      // lowest largest-free-block seen
+  uint8_t maxFragPct = 0;
+  unsigned long lastMs = 0;
+};
+
+static HeapWatch heapWatch;
+
+// 0 = the free heap is one block
+static uint8_t heapFragmentationPct() {
+  uint32_t freeHeap = ESP.getFreeHeap();
+  uint32_t largest = ESP.getMaxAllocHeap();
+  if (freeHeap == 0 || largest >= freeHeap) return 0;
+  return (uint8_t)(100 - (uint64_t)largest * 100 / freeHeap);
+}
+
+void heapWatchTick() {
+  unsigned long now = millis();
+  if (heapWatch.lastMs && now - heapWatch.lastMs < HEAP_WATCH_MS) return;
+  heapWatch.lastMs = now;
+  uint32_t largest = ESP.getMaxAllocHeap();
+  if (heapWatch.minMaxAlloc == 0 || largest < heapWatch.minMaxAlloc) heapWatch.minMaxAlloc = largest;
+  uint8_t pct = heapFragmentationPct();
+  if (pct > heapWatch.maxFragPct) heapWatch.maxFragPct = pct;
+}
+
+// GET /metrics (Prometheus text exposition format), streamed in small chunks
+void handleMetrics() {
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/plain; version=0.0.4", "");
+
+  char buf[512];   // the closing gauge block is ~460 bytes
+  int n = snprintf(buf, sizeof(buf),
+                   "# HELP esp32cam_stage_seconds Duration of firmware stages.\n"
+                   "# TYPE esp32cam_stage_seconds histogram\n");
+  server.sendContent(buf, n);
+
+  for (uint8_t s = 0; s < MET_STAGE_COUNT; s++) {
+    MetricHistogram h;
+    metricSnapshot((MetricStage)s, h);
+    const char* name = metricStageNames[s];
+    uint32_t cumulative = 0;
+    for (uint8_t b = 0; b < METRIC_BUCKETS; b++) {
+      cumulative += h.buckets[b];
+      n = snprintf(buf, sizeof(buf), "esp32cam_stage_seconds_bucket{stage=\"%s\",le=\"%.6f\"} %lu\n",
+                   name, (double)(1UL << (b + METRIC_BUCKET_SHIFT)) / 1e6, (unsigned long)cumulative);
+      server.sendContent(buf, n);
+    }
+    n = snprintf(buf, sizeof(buf),
+                 "esp32cam_stage_seconds_bucket{stage=\"%s\",le=\"+Inf\"} %lu\n"
+                 "esp32cam_stage_seconds_sum{stage=\"%s\"} %.6f\n"
+                 "esp32cam_stage_seconds_count{stage=\"%s\"} %lu\n",
+                 name, (unsigned long)h.count, name, (double)h.sumUs / 1e6, name, (unsigned long)h.count);
+    server.sendContent(buf, n);
+  }
+
+  n = snprintf(buf, sizeof(buf),
+               "# TYPE esp32cam_stage_max_seconds gauge\n");
+  server.sendContent(buf, n);
+  for (uint8_t s = 0; s < MET_STAGE_COUNT; s++) {
+    MetricHistogram h;
+    metricSnapshot((MetricStage)s, h);
+    n = snprintf(buf, sizeof(buf), "esp32cam_stage_max_seconds{stage=\"%s\"} %.6f\n",
+                 metricStageNames[s], (double)h.maxUs / 1e6);
+    server.sendContent(buf, n);
+  }
+
+  n = snprintf(buf, sizeof(buf),
+               "# TYPE esp32cam_uptime_seconds counter\nesp32cam_uptime_seconds %lu\n"
+               "# TYPE esp32cam_free_heap_bytes gauge\nesp32cam_free_heap_bytes %lu\n"
+               "# TYPE esp32cam_max_alloc_heap_bytes gauge\nesp32cam_max_alloc_heap_bytes %lu\n"
+               "# TYPE esp32cam_heap_fragmentation_percent gauge\nesp32cam_heap_fragmentation_percent %u\n"
+               "# TYPE esp32cam_captured_total counter\nesp32cam_captured_total %lu\n"
+               "# TYPE esp32cam_sent_total counter\nesp32cam_sent_total %lu\n",
+               millis() / 1000UL, (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMaxAllocHeap(),
+               (unsigned)heapFragmentationPct(),
+               (unsigned long)capturedCount, (unsigned long)sentCount);
+  server.sendContent(buf, n);
+  n = outboxMetricsText(buf, sizeof(buf));
+  server.sendContent(buf, n);
+  server.sendContent("");
+}
+
+// Telegram /metrics: one line per stage that has seen events
+void metricsSummary(FixedText& out) {
+  out.add("⏱️ Stage latency (count, avg / p99 / max ms):\n");
+  for (uint8_t i = 0; i < MET_STAGE_COUNT; i++) {
+    MetricHistogram h;
+    metricSnapshot((MetricStage)i, h);
+    if (h.count == 0) continue;
+    out.addf("%s: %lu, %.1f / %.1f / %.1f\n", metricStageNames[i], (unsigned long)h.count,
+             (float)h.sumUs / h.count / 1000.0f, metricPercentileUs(h, 99) / 1000.0f, h.maxUs / 1000.0f);
+  }
+}
+
+#endif
@@ -0,0 +1,341 @@
+#ifndef MJPEG_STREAM_H
+#define MJPEG_STREAM_H
+
+// ------------ Live MJPEG stream (/mjpeg) ------------
+// While anyone is watching, a producer task grabs at most MJPEG_MAX_FPS
+// frames a second, copies each once into a refcounted slot and wakes every
+// viewer. Viewers write the slot they hold straight from that buffer (no
+// per-viewer copy); a viewer still busy with an older frame simply takes the
+// newest one when it is done, so a slow client drops frames instead of
+// holding the others back. detectMotion() reuses a fresh stream frame rather
+// than competing with the producer for the camera.
+
+#ifndef MJPEG_MAX_FPS
+#define MJPEG_MAX_FPS 10
+#endif
+#ifndef MJPEG_MAX_CLIENTS
+#define MJPEG_MAX_CLIENTS 3
+#endif
+#ifndef MOTION_STREAM_MAX_AGE_MS
+#define MOTION_STREAM_MAX_AGE_MS 300UL   // older stream frames -> motion grabs its own
+#endif
+#define MJPEG_SLOTS (MJPEG_MAX_CLIENTS + 1)   // one held per viewer + the newest
+#define MJPEG_BOUNDARY "esp32camframe"
+#define MJPEG_VIEWER_STACK 4096
+#define MJPEG_PRODUCER_STACK 4096
+#define MJPEG_FPS_WINDOW_MS 2000UL
+
+struct StreamFrame {
+  uint8_t* buf;
+  size_t len;
+  size_t cap;
+  uint32_t seq;
+  unsigned long capturedMs;
+  int refs;            // viewers/motion reading it, +1 while it is the newest
+};
+
+struct MjpegViewer {
+  bool active;
+  WiFiClient client;
+  TaskHandle_t task;
+  char ip[16];
+  unsigned long sinceMs;
+  uint32_t lastSeq;
+  uint32_t sent;
+  uint32_t skipped;    // frames published while this viewer was still writing
+  uint32_t kbytes;
+  uint32_t windowFrames;
+  unsigned long windowStart;
+  float fps;
+};
+
+struct MjpegStats {
+  uint32_t produced = 0;
+  uint32_t cameraFailures = 0;
+  uint32_t slotStalls = 0;      // every slot still held by a viewer
+  uint32_t rejected = 0;        // viewers turned away at MJPEG_MAX_CLIENTS
+  uint32_t motionReuse = 0;     // motion checks served from a stream frame
+  unsigned long lastCopyUs = 0;
+};
+
+static StreamFrame streamSlots[MJPEG_SLOTS];
+static MjpegViewer mjpegViewers[MJPEG_MAX_CLIENTS];
+static int streamLatest = -1;
+static uint32_t streamSeq = 0;
+static volatile int mjpegViewerCount = 0;
+static SemaphoreHandle_t mjpegMutex = nullptr;
+static TaskHandle_t mjpegProducer = nullptr;
+static MjpegStats mjpegStats;
+
+static void* streamAlloc(size_t n) {
+  void* p = psramFound() ? ps_malloc(n) : nullptr;
+  return p ? p : malloc(n);
+}
+
+// Caller holds mjpegMutex
+static void releaseSlotLocked(int slot) {
+  if (slot >= 0 && streamSlots[slot].refs > 0) streamSlots[slot].refs--;
+}
+
+// Newest frame newer than `afterSeq`, or -1. The slot stays valid until
+// releaseStreamFrame().
+static int acquireNewestFrame(uint32_t afterSeq) {
+  int slot = -1;
+  xSemaphoreTake(mjpegMutex, portMAX_DELAY);
+  if (streamLatest >= 0 && streamSlots[streamLatest].seq > afterSeq) {
+    slot = streamLatest;
+    streamSlots[slot].refs++;
+  }
+  xSemaphoreGive(mjpegMutex);
+  return slot;
+}
+
+void releaseStreamFrame(int slot) {
+  if (slot < 0 || !mjpegMutex) return;
+  xSemaphoreTake(mjpegMutex, portMAX_DELAY);
+  releaseSlotLocked(slot);
+  xSemaphoreGive(mjpegMutex);
+}
+
+// For detectMotion(): the newest stream frame if it is at most maxAgeMs old
+int acquireStreamFrame(unsigned long maxAgeMs, const uint8_t** buf, size_t* len) {
+  if (!mjpegMutex || mjpegViewerCount == 0) return -1;
+  int slot = acquireNewestFrame(0);
+  if (slot < 0) return -1;
+  if (millis() - streamSlots[slot].capturedMs > maxAgeMs) {
+    releaseStreamFrame(slot);
+    return -1;
+  }
+  *buf = streamSlots[slot].buf;
+  *len = streamSlots[slot].len;
+  mjpegStats.motionReuse++;
+  return slot;
+}
+
+// Grabs one frame into a free slot and makes it the newest
+static bool publishFrame() {
+  int slot = -1;
+  xSemaphoreTake(mjpegMutex, portMAX_DELAY);
+  for (int i = 0; i < MJPEG_SLOTS; i++) {
+    if (streamSlots[i].refs == 0) { slot = i; break; }
+  }
+  if (slot >= 0) streamSlots[slot].refs = 1;   // not visible to anyone yet
+  xSemaphoreGive(mjpegMutex);
+  if (slot < 0) {
+    mjpegStats.slotStalls++;
+    return false;
+  }
+
+  StreamFrame& f = streamSlots[slot];
+  camera_fb_t* fb = grabFrame(PROFILE_CAPTURE);
+  if (!fb) {
+    mjpegStats.cameraFailures++;
+    releaseStreamFrame(slot);
+    return false;
+  }
+
+  unsigned long t0 = micros();
+  if (fb->len > f.cap) {
+    free(f.buf);
+    f.cap = fb->len + fb->len / 4;   // headroom so busier scenes don't realloc every frame
+    f.buf = (uint8_t*)streamAlloc(f.cap);
+    if (!f.buf) f.cap = 0;
+  }
+  bool ok = f.buf != nullptr;
+  if (ok) {
+    memcpy(f.buf, fb->buf, fb->len);
+    f.len = fb->len;
+    f.capturedMs = millis();
+  }
+  esp_camera_fb_return(fb);
+  mjpegStats.lastCopyUs = micros() - t0;
+
+  xSemaphoreTake(mjpegMutex, portMAX_DELAY);
+  if (ok) {
+    f.seq = ++streamSeq;
+    releaseSlotLocked(streamLatest);
+    streamLatest = slot;               // keeps the producer's reference
+    mjpegStats.produced++;
+  } else {
+    releaseSlotLocked(slot);
+  }
+  xSemaphoreGive(mjpegMutex);
+  return ok;
+}
+
+static void mjpegProducerTask(void*) {
+  const TickType_t period = pdMS_TO_TICKS(1000 / MJPEG_MAX_FPS);
+  TickType_t last = xTaskGetTickCount();
+
+  for (;;) {
+    if (mjpegViewerCount == 0) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);   // woken by the next viewer
+      last = xTaskGetTickCount();
+      continue;
+    }
+    vTaskDelayUntil(&last, period);
+    if (!publishFrame()) continue;
+
+    xSemaphoreTake(mjpegMutex, portMAX_DELAY);
+    for (int i = 0; i < MJPEG_MAX_CLIENTS; i++) {
+      if (mjpegViewers[i].active && mjpegViewers[i].task) xTaskNotifyGive(mjpegViewers[i].task);
+    }
+    xSemaphoreGive(mjpegMutex);
+  }
+}
+
+static bool mjpegWriteAll(WiFiClient& c, const uint8_t* p, size_t left) {
+  while (left > 0) {
+    size_t w = c.write(p, left);
+    if (w == 0) return false;
+    p += w;
+    left -= w;
+  }
+  return true;
+}
+
+static bool mjpegSendFrame(MjpegViewer& v, const StreamFrame& f) {
+  char head[96];
+  int n = snprintf(head, sizeof(head),
+                   "--" MJPEG_BOUNDARY "\r\nContent-Type: image/jpeg\r\nContent-Length: %u\r\n\r\n",
+                   (unsigned)f.len);
+  return mjpegWriteAll(v.client, (const uint8_t*)head, n) &&
+         mjpegWriteAll(v.client, f.buf, f.len) &&
+         mjpegWriteAll(v.client, (const uint8_t*)"\r\n", 2);
+}
+
+static void mjpegViewerTask(void* arg) {
+  MjpegViewer& v = *(MjpegViewer*)arg;
+
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+    if (!v.client.connected()) break;
+
+    int slot = acquireNewestFrame(v.lastSeq);
+    if (slot < 0) continue;
+
+    const StreamFrame& f = streamSlots[slot];
+    if (v.lastSeq) v.skipped += f.seq - v.lastSeq - 1;
+    v.lastSeq = f.seq;
+    bool ok = mjpegSendFrame(v, f);
+    size_t len = f.len;
+    releaseStreamFrame(slot);
+    if (!ok) break;
+
+    v.sent++;
+    v.kbytes += len / 1024;
+    v.windowFrames++;
+    unsigned long now = millis();
+    if (now - v.windowStart >= MJPEG_FPS_WINDOW_MS) {
+      v.fps = v.windowFrames * 1000.0f / (now - v.windowStart);
+      v.windowFrames = 0;
+      v.windowStart = now;
+    }
+  }
+
+  Serial.printf("MJPEG viewer %s left after %u frames\n", v.ip, (unsigned)v.sent);
+  xSemaphoreTake(mjpegMutex, portMAX_DELAY);
+  v.client.stop();
+  v.client = WiFiClient();
+  v.task = nullptr;
+  v.active = false;
+  mjpegViewerCount--;
+  xSemaphoreGive(mjpegMutex);
+  vTaskDelete(nullptr);
+}
+
+// GET /mjpeg: the socket is handed to a viewer task and the web server moves
+// on (it may linger in its close-wait for a couple of seconds, as with any
+// response it did not send itself).
+void handleMjpegStream() {
+  if (!mjpegMutex) {
+    server.send(503, "text/plain", "Stream not ready");
+    return;
+  }
+
+  xSemaphoreTake(mjpegMutex, portMAX_DELAY);
+  MjpegViewer* v = nullptr;
+  for (int i = 0; i < MJPEG_MAX_CLIENTS; i++) {
+    if (!mjpegViewers[i].active) { v = &mjpegViewers[i]; break; }
+  }
+  if (!v) {
+    mjpegStats.rejected++;
+    xSemaphoreGive(mjpegMutex);
+    server.send(503, "text/plain", "Too many viewers");
+    return;
+  }
+  v->active = true;
+  xSemaphoreGive(mjpegMutex);
+
+  v->client = server.client();
+  v->client.setNoDelay(true);
+  strncpy(v->ip, v->client.remoteIP().toString().c_str(), sizeof(v->ip) - 1);
+  v->ip[sizeof(v->ip) - 1] = 0;
+  v->sinceMs = v->windowStart = millis();
+  v->lastSeq = 0;
+  v->sent = v->skipped = v->kbytes = v->windowFrames = 0;
+  v->fps = 0;
+
+  static const char head[] =
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Type: multipart/x-mixed-replace; boundary=" MJPEG_BOUNDARY "\r\n"
+      "Cache-Control: no-cache, no-store\r\n"
+      "Connection: close\r\n\r\n";
+  bool ok = mjpegWriteAll(v->client, (const uint8_t*)head, sizeof(head) - 1);
+
+  xSemaphoreTake(mjpegMutex, portMAX_DELAY);
+  if (ok) ok = xTaskCreatePinnedToCore(mjpegViewerTask, "mjpeg", MJPEG_VIEWER_STACK, v, 1, &v->task, 0) == pdPASS;
+  if (ok) {
+    mjpegViewerCount++;
+  } else {
+    v->client.stop();
+    v->client = WiFiClient();
+    v->active = false;
+  }
+  xSemaphoreGive(mjpegMutex);
+
+  if (ok) {
+    Serial.printf("MJPEG viewer %s joined (%d watching)\n", v->ip, mjpegViewerCount);
+    xTaskNotifyGive(mjpegProducer);
+  }
+}
+
+void startMjpegStream() {
+  mjpegMutex = xSemaphoreCreateMutex();
+  xTaskCreatePinnedToCore(mjpegProducerTask, "mjpegcam", MJPEG_PRODUCER_STACK, nullptr, 1, &mjpegProducer, 0);
+}
+
+void fillMjpegStats(JsonObject o) {
+  o["maxFps"] = MJPEG_MAX_FPS;
+  o["viewers"] = mjpegViewerCount;
+  o["produced"] = mjpegStats.produced;
+  o["cameraFailures"] = mjpegStats.cameraFailures;
+  o["slotStalls"] = mjpegStats.slotStalls;
+  o["rejected"] = mjpegStats.rejected;
+  o["motionReuse"] = mjpegStats.motionReuse;
+  o["lastCopyUs"] = mjpegStats.lastCopyUs;
+
+  JsonArray a = o.createNestedArray("clients");
+  unsigned long now = millis();
+  for (int i = 0; i < MJPEG_MAX_CLIENTS; i++) {
+    const MjpegViewer& v = mjpegViewers[i];
+    if (!v.active) continue;
+    JsonObject c = a.createNestedObject();
+    c["ip"] = (const char*)v.ip;
+    c["fps"] = v.fps;
+    c["sent"] = v.sent;
+    c["skipped"] = v.skipped;
+    c["kbytes"] = v.kbytes;
+    c["seconds"] = (now - v.sinceMs) / 1000UL;
+  }
+}
+
+void mjpegStatsLine(FixedText& out) {
+  out.addf("mjpeg: %d viewer(s), %lu frames", (int)mjpegViewerCount, (unsigned long)mjpegStats.produced);
+  for (int i = 0; i < MJPEG_MAX_CLIENTS; i++) {
+    const MjpegViewer& v = mjpegViewers[i];
+    if (v.active) out.addf(", %s %.1f fps", v.ip, v.fps);
+  }
+}
+
+#endif
@@ -0,0 +1,454 @@
+#ifndef MOTION_ENGINE_H
+#define MOTION_ENGINE_H
+
+// Reduced-resolution luma motion engine.
+//
+// Decodes only the DC coefficient of each luma 8x8 block of a baseline JPEG
+// (no IDCT, no chroma, no AC dequantisation) and averages the block means into
+// a small grayscale grid. Two consecutive grids are compared cell by cell after
+// removing the global brightness shift, so auto-exposure changes do not count
+// as motion. Plain C++ (no Arduino headers) so it also builds on a host.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifndef MOTION_GRID_W
+#define MOTION_GRID_W 20          // cells across (SVGA: 5x5 blocks = 40x40 px each)
+#endif
+#ifndef MOTION_GRID_H
+#define MOTION_GRID_H 15
+#endif
+#ifndef MOTION_MIN_CHANGED_CELLS
+#define MOTION_MIN_CHANGED_CELLS 2
+#endif
+
+#define LUMA_GRID_MAX_DIM   32
+#define LUMA_GRID_MAX_CELLS (LUMA_GRID_MAX_DIM * LUMA_GRID_MAX_DIM)
+
+struct LumaGrid {
+  uint8_t w = 0, h = 0;           // grid cells
+  uint16_t imgW = 0, imgH = 0;    // source image pixels
+  uint8_t px[LUMA_GRID_MAX_CELLS];
+};
+
+// ------------ JPEG DC-only decoder ------------
+class JpegLumaDecoder {
+ public:
+  // Decodes `jpg` into a gw x gh grid of average luma. Returns false for
+  // anything that is not a baseline Huffman JPEG or is truncated/corrupt.
+  bool decode(const uint8_t* jpg, size_t len, uint8_t gw, uint8_t gh, LumaGrid& out) {
+    if (!jpg || len < 4 || gw == 0 || gh == 0 ||
+        gw > LUMA_GRID_MAX_DIM || gh > LUMA_GRID_MAX_DIM) return false;
+    if (jpg[0] != 0xFF || jpg[1] != 0xD8) return false;
+
+    resetState();
+    const uint8_t* p = jpg + 2;
+    const uint8_t* end = jpg + len;
+
+    while (p + 4 <= end) {
+      if (p[0] != 0xFF) return false;
+      uint8_t marker = p[1];
+      if (marker == 0xFF) { p++; continue; }   // fill byte
+      p += 2;
+      if (marker == 0xD8 || (marker >= 0xD0 && marker <= 0xD7)) continue;
+      if (marker == 0xD9) return false;         // EOI before SOS
+
+      uint16_t segLen = (uint16_t)((p[0] << 8) | p[1]);
+      if (segLen < 2 || p + segLen > end) return false;
+      const uint8_t* seg = p + 2;
+      const uint8_t* segEnd = p + segLen;
+
+      switch (marker) {
+        case 0xDB: if (!parseDQT(seg, segEnd)) return false; break;
+        case 0xC4: if (!parseDHT(seg, segEnd)) return false; break;
+        case 0xC0:
+        case 0xC1: if (!parseSOF(seg, segEnd)) return false; break;
+        case 0xC2: case 0xC3: case 0xC5: case 0xC6: case 0xC7:
+        case 0xC9: case 0xCA: case 0xCB: case 0xCD: case 0xCE: case 0xCF:
+          return false;                         // progressive / lossless / arithmetic
+        case 0xDD:
+          if (segEnd - seg < 2) return false;
+          restartInterval = (uint16_t)((seg[0] << 8) | seg[1]);
+          break;
+        case 0xDA:
+          if (!parseSOS(seg, segEnd)) return false;
+          return decodeScan(segEnd, end, gw, gh, out);
+        default: break;                         // APPn, COM, ...
+      }
+      p = segEnd;
+    }
+    return false;
+  }
+
+ private:
+  struct Huff {
+    uint16_t lut[512];            // 9-bit lookup: (len << 8) | symbol, 0 = slow path
+    int32_t maxcode[18];
+    int32_t valoff[17];
+    uint8_t vals[256];
+    bool present;
+  };
+
+  struct Comp {
+    uint8_t id, h, v, tq, td, ta;
+  };
+
+  Huff dc[4], ac[4];
+  uint16_t qDC[4];
+  Comp comps[4];
+  uint8_t ncomp = 0;
+  uint8_t scanComp[4];
+  uint8_t nscan = 0;
+  uint16_t width = 0, height = 0;
+  uint16_t restartInterval = 0;
+  uint32_t sums[LUMA_GRID_MAX_CELLS];
+
+  // bit reader
+  const uint8_t* bp;
+  const uint8_t* bend;
+  uint32_t bitBuf;
+  int bitCnt;
+  int padBits;                    // zero bits fed in past a marker or the end
+  bool hitMarker;
+
+  void resetState() {
+    for (int i = 0; i < 4; i++) { dc[i].present = false; ac[i].present = false; qDC[i] = 1; }
+    ncomp = 0; nscan = 0; width = 0; height = 0; restartInterval = 0;
+  }
+
+  bool parseDQT(const uint8_t* s, const uint8_t* e) {
+    while (s < e) {
+      uint8_t pq = s[0] >> 4, tq = s[0] & 0x0F;
+      size_t n = pq ? 128 : 64;
+      if (tq > 3 || s + 1 + n > e) return false;
+      qDC[tq] = pq ? (uint16_t)((s[1] << 8) | s[2]) : s[1];
+      s += 1 + n;
+    }
+    return true;
+  }
+
+  bool parseDHT(const uint8_t* s, const uint8_t* e) {
+    while (s + 17 <= e) {
+      uint8_t tc = s[0] >> 4, th = s[0] & 0x0F;
+      if (tc > 1 || th > 3) return false;
+      Huff& t = tc ? ac[th] : dc[th];
+      const uint8_t* counts = s + 1;
+      int total = 0;
+      for (int i = 0; i < 16; i++) total += counts[i];
+      if (total > 256 || s + 17 + total > e) return false;
+      memcpy(t.vals, s + 17, total);
+      buildHuff(t, counts);
+      s += 17 + total;
+    }
+    return true;
+  }
+
+  static void buildHuff(Huff& t, const uint8_t* counts) {
+    memset(t.lut, 0, sizeof(t.lut));
+    int code = 0, k = 0;
+    for (int len = 1; len <= 16; len++) {
+      int n = counts[len - 1];
+      t.valoff[len] = k - code;
+      if (n) {
+        for (int i = 0; i < n; i++, k++, code++) {
+          if (len <= 9) {
+            int shift = 9 - len;
+            int base = code << shift;
+            uint16_t entry = (uint16_t)((len << 8) | t.vals[k]);
+            for (int f = 0; f < (1 << shift); f++) t.lut[base + f] = entry;
+          }
+        }
+        t.maxcode[len] = code - 1;
+      } else {
+        t.maxcode[len] = -1;
+      }
+      code <<= 1;
+    }
+    t.maxcode[17] = 0x7FFFFFFF;
+    t.present = true;
+  }
+
+  bool parseSOF(const uint8_t* s, const uint8_t* e) {
+    if (e - s < 6 || s[0] != 8) return false;
+    height = (uint16_t)((s[1] << 8) | s[2]);
+    width = (uint16_t)((s[3] << 8) | s[4]);
+    ncomp = s[5];
+    if (ncomp == 0 || ncomp > 3 || width == 0 || height == 0) return false;
+    if (e - s < 6 + 3 * ncomp) return false;
+    for (int i = 0; i < ncomp; i++) {
+      const uint8_t* c = s + 6 + 3 * i;
+      comps[i].id = c[0];
+      comps[i].h = c[1] >> 4;
+      comps[i].v = c[1] & 0x0F;
+      comps[i].tq = c[2] & 0x03;
+      if (comps[i].h < 1 || comps[i].h > 2 || comps[i].v < 1 || comps[i].v > 2) return false;
+    }
+    return true;
+  }
+
+  bool parseSOS(const uint8_t* s, const uint8_t* e) {
+    if (ncomp == 0 || e - s < 1) return false;
+    nscan = s[0];
+    if (nscan < 1 || nscan > ncomp || e - s < 1 + 2 * nscan + 3) return false;
+    for (int i = 0; i < nscan; i++) {
+      uint8_t id = s[1 + 2 * i], tbl = s[2 + 2 * i];
+      int ci = -1;
+      for (int c = 0; c < ncomp; c++) if (comps[c].id == id) ci = c;
+      if (ci < 0) return false;
+      comps[ci].td = tbl >> 4;
+      comps[ci].ta = tbl & 0x0F;
+      if (comps[ci].td > 3 || comps[ci].ta > 3) return false;
+      if (!dc[comps[ci].td].present || !ac[comps[ci].ta].present) return false;
+      scanComp[i] = (uint8_t)ci;
+    }
+    // Luma must be the first component of the scan (true for every JFIF encoder).
+    return scanComp[0] == 0;
+  }
+
+  // ---- bit reader (handles 0xFF00 stuffing, stops at markers) ----
+  inline void fill() {
+    while (bitCnt <= 24) {
+      uint32_t b = 0;
+      if (hitMarker || bp >= bend) {
+        padBits += 8;
+      } else {
+        b = *bp;
+        if (b == 0xFF) {
+          uint8_t nx = (bp + 1 < bend) ? bp[1] : 0xD9;
+          if (nx == 0x00) bp += 2;
+          else { hitMarker = true; b = 0; padBits += 8; }
+        } else {
+          bp++;
+        }
+      }
+      bitBuf |= b << (24 - bitCnt);
+      bitCnt += 8;
+    }
+  }
+
+  inline void skipBits(int n) { bitBuf <<= n; bitCnt -= n; }
+
+  // A well-formed interval ends inside its last data byte; reading into the
+  // padding means the scan was cut short (zeros decode as valid codes).
+  inline bool overran() const { return padBits > bitCnt; }
+
+  inline int decodeHuff(const Huff& t) {
+    fill();
+    uint16_t e = t.lut[bitBuf >> 23];
+    if (e) {
+      skipBits(e >> 8);
+      return e & 0xFF;
+    }
+    for (int len = 10; len <= 16; len++) {
+      int32_t code = (int32_t)(bitBuf >> (32 - len));
+      if (code <= t.maxcode[len]) {
+        skipBits(len);
+        return t.vals[(code + t.valoff[len]) & 0xFF];
+      }
+    }
+    return -1;
+  }
+
+  inline int receiveExtend(int s) {
+    fill();
+    int v = (int)(bitBuf >> (32 - s));
+    skipBits(s);
+    if (v < (1 << (s - 1))) v += 1 - (1 << s);
+    return v;
+  }
+
+  bool restart() {
+    bitBuf = 0; bitCnt = 0; padBits = 0;
+    // After the last MCU of an interval the reader sits on the RSTn marker.
+    while (bp + 1 < bend && !(bp[0] == 0xFF && bp[1] >= 0xD0 && bp[1] <= 0xD7)) bp++;
+    if (bp + 1 >= bend) return false;
+    bp += 2;
+    hitMarker = false;
+    return true;
+  }
+
+  // Decodes one block, accumulating its DC into `pred`; false on corrupt data.
+  inline bool decodeBlock(const Comp& c, int& pred) {
+    int s = decodeHuff(dc[c.td]);
+    if (s < 0 || s > 11) return false;
+    if (s) pred += receiveExtend(s);
+    const Huff& at = ac[c.ta];
+    for (int k = 1; k < 64;) {
+      int rs = decodeHuff(at);
+      if (rs < 0) return false;
+      int r = rs >> 4, sz = rs & 0x0F;
+      if (sz) {
+        k += r + 1;
+        fill();
+        skipBits(sz);
+      } else {
+        if (r != 15) break;   // EOB
+        k += 16;
+      }
+    }
+    return !overran();
+  }
+
+  bool decodeScan(const uint8_t* data, const uint8_t* end, uint8_t gw, uint8_t gh, LumaGrid& out) {
+    bp = data; bend = end; bitBuf = 0; bitCnt = 0; padBits = 0; hitMarker = false;
+
+    uint8_t hmax = 1, vmax = 1;
+    for (int i = 0; i < ncomp; i++) {
+      if (comps[i].h > hmax) hmax = comps[i].h;
+      if (comps[i].v > vmax) vmax = comps[i].v;
+    }
+
+    const Comp& y = comps[0];
+    const int blocksW = (width * y.h / hmax + 7) / 8;
+    const int blocksH = (height * y.v / vmax + 7) / 8;
+    if (blocksW < gw || blocksH < gh) return false;
+
+    int mcusX, mcusY;
+    if (nscan == 1) {            // non-interleaved: one block per MCU
+      mcusX = blocksW; mcusY = blocksH;
+    } else {
+      mcusX = (width + 8 * hmax - 1) / (8 * hmax);
+      mcusY = (height + 8 * vmax - 1) / (8 * vmax);
+    }
+
+    memset(sums, 0, sizeof(uint32_t) * gw * gh);
+    int pred[4] = {0, 0, 0, 0};
+    const int32_t q0 = qDC[y.tq];
+    int mcusLeft = restartInterval;
+
+    for (int my = 0; my < mcusY; my++) {
+      for (int mx = 0; mx < mcusX; mx++) {
+        if (restartInterval) {
+          if (mcusLeft == 0) {
+            if (!restart()) return false;
+            pred[0] = pred[1] = pred[2] = pred[3] = 0;
+            mcusLeft = restartInterval;
+          }
+          mcusLeft--;
+        }
+
+        for (int si = 0; si < nscan; si++) {
+          const Comp& c = comps[scanComp[si]];
+          const int bh = (nscan == 1) ? 1 : c.h;
+          const int bv = (nscan == 1) ? 1 : c.v;
+          for (int v = 0; v < bv; v++) {
+            for (int h = 0; h < bh; h++) {
+              if (!decodeBlock(c, pred[si])) return false;
+              if (si != 0) continue;
+
+              int bx = mx * bh + h, by = my * bv + v;
+              if (bx >= blocksW || by >= blocksH) continue;
+              int32_t lum = (pred[0] * q0) / 8 + 128;
+              if (lum < 0) lum = 0;
+              if (lum > 255) lum = 255;
+              sums[(by * gh / blocksH) * gw + (bx * gw / blocksW)] += (uint32_t)lum;
+            }
+          }
+        }
+      }
+    }
+
+    // Each cell averages a fixed number of whole blocks per row and column.
+    for (int gy = 0; gy < gh; gy++) {
+      int rows = ((gy + 1) * blocksH + gh - 1) / gh - (gy * blocksH + gh - 1) / gh;
+      for (int gx = 0; gx < gw; gx++) {
+        int cols = ((gx + 1) * blocksW + gw - 1) / gw - (gx * blocksW + gw - 1) / gw;
+        uint32_t n = (uint32_t)(rows * cols);
+        out.px[gy * gw + gx] = n ? (uint8_t)(sums[gy * gw + gx] / n) : 0;
+      }
+    }
+    out.w = gw; out.h = gh;
+    out.imgW = width; out.imgH = height;
+    return true;
+  }
+};
+
+// ------------ Block comparison ------------
+struct MotionResult {
+  bool motion = false;
+  uint16_t changedCells = 0;
+  uint16_t totalCells = 0;
+  int16_t globalShift = 0;        // median luma change (exposure), removed before compare
+  uint8_t peakDelta = 0;
+  // Bounding box of changed cells in image pixels (w == 0 when nothing changed)
+  uint16_t boxX = 0, boxY = 0, boxW = 0, boxH = 0;
+};
+
+class MotionEngine {
+ public:
+  // cellDelta: luma levels a cell must move (after exposure compensation)
+  // minCells:  changed cells needed to report motion
+  void configure(uint8_t cellDelta, uint16_t minCells) {
+    delta = cellDelta ? cellDelta : 1;
+    minChanged = minCells ? minCells : 1;
+  }
+
+  void reset() { havePrev = false; }
+
+  // Returns false when the frame could not be decoded (caller may fall back).
+  // The first decodable frame (or a resolution change) only primes the baseline.
+  bool analyze(const uint8_t* jpg, size_t len, MotionResult& r) {
+    r = MotionResult();
+    LumaGrid& cur = grids[curIdx];
+    if (!decoder.decode(jpg, len, MOTION_GRID_W, MOTION_GRID_H, cur)) return false;
+
+    LumaGrid& prev = grids[curIdx ^ 1];
+    const int n = cur.w * cur.h;
+    r.totalCells = (uint16_t)n;
+
+    if (!havePrev || prev.imgW != cur.imgW || prev.imgH != cur.imgH) {
+      havePrev = true;
+      curIdx ^= 1;
+      return true;
+    }
+
+    // Median signed difference = global exposure shift.
+    uint16_t hist[511];
+    memset(hist, 0, sizeof(hist));
+    for (int i = 0; i < n; i++) hist[(int)cur.px[i] - (int)prev.px[i] + 255]++;
+    int acc = 0, median = 0;
+    for (int d = 0; d < 511; d++) {
+      acc += hist[d];
+      if (acc * 2 >= n) { median = d - 255; break; }
+    }
+    r.globalShift = (int16_t)median;
+
+    int x0 = cur.w, y0 = cur.h, x1 = -1, y1 = -1;
+    for (int gy = 0; gy < cur.h; gy++) {
+      for (int gx = 0; gx < cur.w; gx++) {
+        int i = gy * cur.w + gx;
+        int d = (int)cur.px[i] - (int)prev.px[i] - median;
+        if (d < 0) d = -d;
+        if (d > r.peakDelta) r.peakDelta = (uint8_t)(d > 255 ? 255 : d);
+        if (d < delta) continue;
+        r.changedCells++;
+        if (gx < x0) x0 = gx;
+        if (gx > x1) x1 = gx;
+        if (gy < y0) y0 = gy;
+        if (gy > y1) y1 = gy;
+      }
+    }
+
+    if (r.changedCells) {
+      r.boxX = (uint16_t)(x0 * cur.imgW / cur.w);
+      r.boxY = (uint16_t)(y0 * cur.imgH / cur.h);
+      r.boxW = (uint16_t)((x1 + 1) * cur.imgW / cur.w - r.boxX);
+      r.boxH = (uint16_t)((y1 + 1) * cur.imgH / cur.h - r.boxY);
+    }
+    r.motion = r.changedCells >= minChanged;
+
+    curIdx ^= 1;
+    return true;
+  }
+
+ private:
+  JpegLumaDecoder decoder;
+  LumaGrid grids[2];
+  int curIdx = 0;
+  bool havePrev = false;
+  uint8_t delta = 20;
+  uint16_t minChanged = MOTION_MIN_CHANGED_CELLS;
+};
+
+#endif
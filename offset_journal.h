@@ -0,0 +1,244 @@
+#ifndef OFFSET_JOURNAL_H
+#define OFFSET_JOURNAL_H
+
+// ------------ Telegram update offset: RAM + append-only journal ------------
+// The offset lives in RAM. Persisting appends one small CRC-checked record to
+// a SPIFFS journal instead of rewriting TELEGRAM_OFFSET_FILE; the newest valid
+// record wins on boot and a torn tail record is ignored. Once the journal
+// reaches OFFSET_JOURNAL_MAX_RECORDS it is compacted to a single record
+// (write tmp -> remove -> rename; boot falls back to tmp if interrupted).
+// A journal whose size is not a whole number of records, or that holds a bad
+// record, is compacted on boot: appends after a torn record would otherwise
+// land misaligned and never read back. A failed append forces the same
+// compaction on the next save.
+//
+// Batches that carry a command are written synchronously before any of them
+// runs, as the CRITICAL FIX requires; batches without commands are
+// write-behind (flushed by loop() after OFFSET_FLUSH_MS). A save that did
+// not reach flash leaves the offset dirty and is retried.
+
+#define OFFSET_JOURNAL_FILE "/tg_offset.log"
+#define OFFSET_JOURNAL_TMP  "/tg_offset.tmp"
+#define OFFSET_JOURNAL_MAGIC 0x4F464631UL   // "OFF1"
+#ifndef OFFSET_JOURNAL_MAX_RECORDS
+#define OFFSET_JOURNAL_MAX_RECORDS 64
+#endif
+#ifndef OFFSET_FLUSH_MS
+#define OFFSET_FLUSH_MS 30000UL
+#endif
+
+struct OffsetRecord {
+  uint32_t magic;
+  uint32_t seq;
+  int64_t updateId;
+  uint32_t reserved;   // keeps the record 24 bytes with no padding
+  uint32_t crc;
+};
+
+struct OffsetJournalStats {
+  uint32_t appends = 0;
+  uint32_t compactions = 0;
+  uint32_t bytesWritten = 0;
+  uint32_t deferred = 0;          // saves absorbed by write-behind
+  uint32_t failed = 0;            // saves that did not reach flash
+  uint32_t repairs = 0;           // torn or corrupt journals compacted on boot
+  unsigned long lastSaveUs = 0;
+  unsigned long maxSaveUs = 0;
+};
+
+static long journalOffset = 0;       // authoritative (RAM)
+static long journalPersisted = 0;    // last value on flash
+static uint32_t journalSeq = 0;
+static uint32_t journalRecords = 0;
+static unsigned long journalDirtySince = 0;
+static SemaphoreHandle_t journalMutex = nullptr;
+static OffsetJournalStats journalStats;
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t* p, size_t n) {
+  crc = ~crc;
+  while (n--) {
+    crc ^= *p++;
+    for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+  }
+  return ~crc;
+}
+
+static uint32_t offsetRecordCrc(const OffsetRecord& r) {
+  return crc32Update(0, (const uint8_t*)&r, offsetof(OffsetRecord, crc));
+}
+
+// Returns the number of valid records; `best` gets the newest one. `clean`
+// is false when the file has a partial tail or a record failed its CRC.
+static uint32_t scanJournal(const char* path, OffsetRecord& best, bool& clean) {
+  clean = true;
+  File f = SPIFFS.open(path, "r");
+  if (!f) return 0;
+  if (f.size() % sizeof(OffsetRecord) != 0) clean = false;
+  uint32_t valid = 0;
+  OffsetRecord r;
+  while (f.read((uint8_t*)&r, sizeof(r)) == sizeof(r)) {
+    if (r.magic != OFFSET_JOURNAL_MAGIC || r.crc != offsetRecordCrc(r)) {
+      clean = false;
+      continue;
+    }
+    if (valid == 0 || r.seq > best.seq) best = r;
+    valid++;
+  }
+  f.close();
+  return valid;
+}
+
+static bool writeOffsetRecord(File& f, long updateId) {
+  OffsetRecord r;
+  r.magic = OFFSET_JOURNAL_MAGIC;
+  r.seq = ++journalSeq;
+  r.updateId = updateId;
+  r.reserved = 0;
+  r.crc = offsetRecordCrc(r);
+  bool ok = f.write((const uint8_t*)&r, sizeof(r)) == sizeof(r);
+  journalStats.bytesWritten += sizeof(r);
+  return ok;
+}
+
+static bool compactJournal(long updateId) {
+  File t = SPIFFS.open(OFFSET_JOURNAL_TMP, "w");
+  if (!t) return false;
+  bool ok = writeOffsetRecord(t, updateId);
+  t.close();
+  if (!ok) return false;
+  SPIFFS.remove(OFFSET_JOURNAL_FILE);
+  if (!SPIFFS.rename(OFFSET_JOURNAL_TMP, OFFSET_JOURNAL_FILE)) return false;
+  journalRecords = 1;
+  journalStats.compactions++;
+  return true;
+}
+
+// Caller holds journalMutex. False when the offset did not reach flash; it
+// stays dirty so the next save or flush tries again.
+static bool persistOffsetLocked() {
+  if (journalOffset == journalPersisted) return true;
+  unsigned long t0 = micros();
+
+  bool ok;
+  if (journalRecords >= OFFSET_JOURNAL_MAX_RECORDS) {
+    ok = compactJournal(journalOffset);
+  } else {
+    File f = SPIFFS.open(OFFSET_JOURNAL_FILE, "a");
+    ok = f && writeOffsetRecord(f, journalOffset);
+    if (f) f.close();
+    if (ok) journalRecords++;
+  }
+  if (!ok) {
+    // Part of a record may be on flash: rewrite the journal next time
+    journalRecords = OFFSET_JOURNAL_MAX_RECORDS;
+    journalStats.failed++;
+    if (journalDirtySince == 0) journalDirtySince = millis();
+    Serial.println("Failed to write offset journal");
+    return false;
+  }
+  journalStats.appends++;
+  journalPersisted = journalOffset;
+  journalDirtySince = 0;
+
+  unsigned long dt = micros() - t0;
+  journalStats.lastSaveUs = dt;
+  if (dt > journalStats.maxSaveUs) journalStats.maxSaveUs = dt;
+  return true;
+}
+
+// Called once from setup() after SPIFFS is mounted
+void loadUpdateOffset() {
+  journalMutex = xSemaphoreCreateMutex();
+
+  OffsetRecord best;
+  bool clean;
+  journalRecords = scanJournal(OFFSET_JOURNAL_FILE, best, clean);
+  bool tmpClean;
+  if (journalRecords == 0 && scanJournal(OFFSET_JOURNAL_TMP, best, tmpClean) > 0) {
+    // Compaction was interrupted between remove and rename
+    SPIFFS.remove(OFFSET_JOURNAL_FILE);
+    SPIFFS.rename(OFFSET_JOURNAL_TMP, OFFSET_JOURNAL_FILE);
+    journalRecords = 1;
+    clean = tmpClean;
+  }
+
+  if (journalRecords > 0) {
+    journalOffset = (long)best.updateId;
+    journalSeq = best.seq;
+  }
+  if (!clean) {
+    journalStats.repairs++;
+    if (journalRecords == 0) {
+      SPIFFS.remove(OFFSET_JOURNAL_FILE);       // nothing readable in it
+    } else if (!compactJournal(journalOffset)) {
+      journalRecords = OFFSET_JOURNAL_MAX_RECORDS;   // retry with the next save
+    }
+  }
+
+  if (journalRecords == 0 && SPIFFS.exists(TELEGRAM_OFFSET_FILE)) {
+    // Migrate the legacy plain-text offset file
+    File file = SPIFFS.open(TELEGRAM_OFFSET_FILE, "r");
+    if (file) {
+      String content = file.readString();
+      file.close();
+      content.trim();
+      journalOffset = content.toInt();
+    }
+  }
+  journalPersisted = journalOffset;
+
+  if (journalRecords == 0 && journalOffset != 0) {
+    journalPersisted = 0;
+    if (persistOffsetLocked()) SPIFFS.remove(TELEGRAM_OFFSET_FILE);
+  }
+  Serial.printf("Telegram offset %ld (%u journal records%s)\n", journalOffset, (unsigned)journalRecords,
+                clean ? "" : ", repaired");
+}
+
+long getLastUpdateID() {
+  return journalOffset;
+}
+
+// False when a durable save did not reach flash (the offset stays dirty)
+bool saveLastUpdateID(long update_id, bool durable) {
+  if (!journalMutex) return false;
+  xSemaphoreTake(journalMutex, portMAX_DELAY);
+  journalOffset = update_id;
+  bool ok = true;
+  if (durable) {
+    ok = persistOffsetLocked();
+  } else {
+    if (journalDirtySince == 0) journalDirtySince = millis();
+    journalStats.deferred++;
+  }
+  xSemaphoreGive(journalMutex);
+  return ok;
+}
+
+// loop(): write-behind flush. force = true before a restart. False when a
+// due write failed.
+bool flushUpdateOffset(bool force) {
+  if (!journalMutex || journalOffset == journalPersisted) return true;
+  if (!force && (journalDirtySince == 0 || millis() - journalDirtySince < OFFSET_FLUSH_MS)) return true;
+  xSemaphoreTake(journalMutex, portMAX_DELAY);
+  bool ok = persistOffsetLocked();
+  xSemaphoreGive(journalMutex);
+  return ok;
+}
+
+void fillOffsetJournalStats(JsonObject o) {
+  unsigned long upMs = millis();
+  o["offset"] = journalOffset;
+  o["records"] = journalRecords;
+  o["flashWrites"] = journalStats.appends;
+  o["flashWritesPerHour"] = upMs ? (float)journalStats.appends * 3600000.0f / upMs : 0.0f;
+  o["bytesWritten"] = journalStats.bytesWritten;
+  o["compactions"] = journalStats.compactions;
+  o["deferredSaves"] = journalStats.deferred;
+  o["failedSaves"] = journalStats.failed;
+  o["repairs"] = journalStats.repairs;
+  o["lastSaveUs"] = journalStats.lastSaveUs;
+  o["maxSaveUs"] = journalStats.maxSaveUs;
+}
+
+#endif
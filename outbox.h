@@ -0,0 +1,319 @@
+#ifndef OUTBOX_H
+#define OUTBOX_H
+
+// ------------ Store-and-forward outbox (SPIFFS) ------------
+// Photos whose upload failed are written to SPIFFS (one file per photo:
+// header with caption + CRC, then the JPEG) instead of being lost. The
+// upload task retries the oldest one whenever its RAM queue is idle, with
+// exponential backoff plus jitter while Telegram stays unreachable. Any
+// successful upload resets the backoff, so a backlog drains back to back as
+// soon as connectivity returns. OUTBOX_QUOTA_KB bounds the space used; the
+// oldest photos are evicted first. Files survive reboots.
+//
+// Only failures a retry can fix are parked: no answer at all, a 5xx or a
+// 429. A photo Telegram refused (any other 4xx, or a request too large to
+// frame) would fail the same way forever and block the photos behind it, so
+// it is dropped, as is a parked photo after OUTBOX_MAX_ATTEMPTS tries.
+
+#ifndef OUTBOX_QUOTA_KB
+#define OUTBOX_QUOTA_KB 384
+#endif
+#define OUTBOX_MAX_ITEMS 64
+#define OUTBOX_PREFIX "/ob_"
+#define OUTBOX_MAGIC 0x3158424FUL          // "OBX1"
+#define OUTBOX_BACKOFF_MIN_MS 10000UL
+#define OUTBOX_BACKOFF_MAX_MS 600000UL
+#define OUTBOX_SPIFFS_RESERVE 16384UL      // leave room for the journal/settings
+#define OUTBOX_MAX_ATTEMPTS 16             // per photo, since boot (~2 h at the backoff cap)
+
+struct OutboxHeader {
+  uint32_t magic;
+  uint32_t seq;
+  uint32_t len;
+  uint32_t crc;          // of the JPEG
+  uint32_t createdEpoch; // 0 when the clock was not synced yet
+  char caption[88];
+  uint32_t group;        // seq of the job's first photo; an album is parked photo by photo
+  uint16_t part;
+  uint16_t parts;        // 0 or 1: a photo on its own (0 in files from before albums)
+};
+
+struct OutboxEntry {
+  uint32_t seq;
+  uint32_t bytes;        // file size (header + JPEG)
+  uint8_t attempts;      // drain attempts since boot
+};
+
+struct OutboxStats {
+  uint32_t stored = 0;
+  uint32_t drained = 0;
+  uint32_t evicted = 0;      // quota / SPIFFS space
+  uint32_t rejected = 0;     // could not be written at all
+  uint32_t corrupt = 0;
+  uint32_t attempts = 0;
+  uint32_t failures = 0;
+  uint32_t dropped = 0;      // refused by Telegram, or OUTBOX_MAX_ATTEMPTS failed
+  uint32_t unsendable = 0;   // live uploads Telegram refused, never parked
+  uint32_t drainSessionBytes = 0;
+  unsigned long drainSessionStart = 0;
+  unsigned long drainSessionEnd = 0;
+};
+
+static OutboxEntry outboxIndex[OUTBOX_MAX_ITEMS];   // oldest first
+static int outboxCount = 0;
+static uint32_t outboxBytes = 0;
+static uint32_t outboxNextSeq = 1;
+static unsigned long outboxBackoffMs = 0;
+static unsigned long outboxNextAttemptMs = 0;
+static bool outboxWaiting = false;                  // backoff in effect
+static uint32_t outboxGroupSeq = 0;                 // group of the job being parked
+static uint32_t outboxCountedGroup = 0;             // last job drained and counted as sent
+static SemaphoreHandle_t outboxMutex = nullptr;
+static OutboxStats outboxStats;
+
+static String outboxPath(uint32_t seq) {
+  char name[24];
+  snprintf(name, sizeof(name), OUTBOX_PREFIX "%08lu", (unsigned long)seq);
+  return String(name);
+}
+
+static void outboxRemoveOldestLocked() {
+  SPIFFS.remove(outboxPath(outboxIndex[0].seq));
+  outboxBytes -= outboxIndex[0].bytes;
+  memmove(&outboxIndex[0], &outboxIndex[1], (outboxCount - 1) * sizeof(OutboxEntry));
+  outboxCount--;
+}
+
+// Called once from setup() after SPIFFS is mounted
+void loadOutbox() {
+  outboxMutex = xSemaphoreCreateMutex();
+
+  File root = SPIFFS.open("/");
+  if (!root) return;
+  for (File f = root.openNextFile(); f; f = root.openNextFile()) {
+    const char* n = f.name();
+    if (n[0] == '/') n++;                      // name() may or may not keep the '/'
+    if (strncmp(n, OUTBOX_PREFIX + 1, 3) != 0) continue;
+    uint32_t seq = strtoul(n + 3, nullptr, 10);
+    uint32_t bytes = f.size();
+    f.close();
+    if (seq == 0 || outboxCount == OUTBOX_MAX_ITEMS) continue;
+
+    // Insertion sort by seq (directory order is arbitrary)
+    int i = outboxCount++;
+    while (i > 0 && outboxIndex[i - 1].seq > seq) {
+      outboxIndex[i] = outboxIndex[i - 1];
+      i--;
+    }
+    outboxIndex[i].seq = seq;
+    outboxIndex[i].bytes = bytes;
+    outboxIndex[i].attempts = 0;
+    outboxBytes += bytes;
+    if (seq >= outboxNextSeq) outboxNextSeq = seq + 1;
+  }
+  root.close();
+  if (outboxCount) {
+    Serial.printf("Outbox: %d photo(s), %u KB pending\n", outboxCount, (unsigned)(outboxBytes / 1024));
+  }
+}
+
+static void outboxScheduleRetry() {
+  outboxBackoffMs = outboxBackoffMs ? outboxBackoffMs * 2 : OUTBOX_BACKOFF_MIN_MS;
+  if (outboxBackoffMs > OUTBOX_BACKOFF_MAX_MS) outboxBackoffMs = OUTBOX_BACKOFF_MAX_MS;
+  // +-25% jitter so a fleet (or a flapping AP) doesn't retry in lockstep
+  unsigned long jitter = esp_random() % (outboxBackoffMs / 2 + 1);
+  outboxNextAttemptMs = millis() + outboxBackoffMs - outboxBackoffMs / 4 + jitter;
+  outboxWaiting = true;
+}
+
+// Upload task: a live upload went through, so drain at full speed
+void outboxKick() {
+  outboxBackoffMs = 0;
+  outboxWaiting = false;
+}
+
+// Upload task: a live upload Telegram refused; a retry would fail the same way
+void outboxRefused() {
+  outboxStats.unsendable++;
+  logEvent(EV_OUTBOX_DROP, uploadFailStatus(), 1);
+}
+
+// Upload task: keep a photo whose upload failed. Evicts the oldest photos
+// to stay within OUTBOX_QUOTA_KB and the free SPIFFS space. The photos of
+// one album or burst are stored as parts 0..parts-1 of one job, in order.
+bool outboxStore(const uint8_t* buf, size_t len, const char* caption, uint8_t part, uint8_t parts) {
+  if (!outboxMutex) return false;
+  uint32_t need = sizeof(OutboxHeader) + len;
+  if (need > OUTBOX_QUOTA_KB * 1024UL) {
+    outboxStats.rejected++;
+    return false;
+  }
+
+  xSemaphoreTake(outboxMutex, portMAX_DELAY);
+  while (outboxCount > 0 &&
+         (outboxCount == OUTBOX_MAX_ITEMS ||
+          outboxBytes + need > OUTBOX_QUOTA_KB * 1024UL ||
+          SPIFFS.totalBytes() - SPIFFS.usedBytes() < need + OUTBOX_SPIFFS_RESERVE)) {
+    outboxRemoveOldestLocked();
+    outboxStats.evicted++;
+  }
+
+  OutboxHeader h;
+  memset(&h, 0, sizeof(h));
+  h.magic = OUTBOX_MAGIC;
+  h.seq = outboxNextSeq++;
+  if (part == 0) outboxGroupSeq = h.seq;
+  h.group = outboxGroupSeq;
+  h.part = part;
+  h.parts = parts;
+  h.len = len;
+  h.crc = crc32Update(0, buf, len);
+  h.createdEpoch = (uint32_t)time(nullptr);
+  memcpy(h.caption, caption, strnlen(caption, sizeof(h.caption) - 1));   // h is zeroed: stays terminated
+
+  String path = outboxPath(h.seq);
+  File f = SPIFFS.open(path, "w");
+  bool ok = f && f.write((const uint8_t*)&h, sizeof(h)) == sizeof(h) && f.write(buf, len) == len;
+  if (f) f.close();
+  if (!ok) {
+    SPIFFS.remove(path);
+    outboxStats.rejected++;
+    xSemaphoreGive(outboxMutex);
+    return false;
+  }
+
+  outboxIndex[outboxCount].seq = h.seq;
+  outboxIndex[outboxCount].bytes = need;
+  outboxIndex[outboxCount].attempts = 0;
+  outboxCount++;
+  outboxBytes += need;
+  outboxStats.stored++;
+  if (!outboxWaiting) outboxScheduleRetry();
+  int depth = outboxCount;
+  xSemaphoreGive(outboxMutex);
+  logEvent(EV_OUTBOX_STORE, (int32_t)len, depth);
+
+  setTelegramDebugf("📦 Stored in outbox (%d pending)", depth);
+  return true;
+}
+
+// Upload task, when its RAM queue is empty: send the oldest stored photo if
+// a retry is due. True if one was sent or dropped (call again to keep
+// draining).
+bool outboxDrainOne() {
+  if (!outboxMutex || outboxCount == 0 || WiFi.status() != WL_CONNECTED) return false;
+  if (outboxWaiting && (long)(millis() - outboxNextAttemptMs) < 0) return false;
+
+  xSemaphoreTake(outboxMutex, portMAX_DELAY);
+  uint32_t seq = outboxIndex[0].seq;
+  xSemaphoreGive(outboxMutex);
+
+  // Read outside the lock; only this task removes entries while draining
+  String path = outboxPath(seq);
+  File f = SPIFFS.open(path, "r");
+  OutboxHeader h;
+  uint8_t* buf = nullptr;
+  bool oom = false;
+  bool valid = f && f.read((uint8_t*)&h, sizeof(h)) == sizeof(h) && h.magic == OUTBOX_MAGIC &&
+               h.len > 0 && h.len <= OUTBOX_QUOTA_KB * 1024UL;
+  if (valid) {
+    buf = (uint8_t*)(psramFound() ? ps_malloc(h.len) : malloc(h.len));
+    oom = !buf;
+    valid = buf && f.read(buf, h.len) == h.len && crc32Update(0, buf, h.len) == h.crc;
+  }
+  if (f) f.close();
+
+  if (!valid) {
+    free(buf);
+    if (oom) return false;         // leave it for later
+    outboxStats.corrupt++;
+    xSemaphoreTake(outboxMutex, portMAX_DELAY);
+    if (outboxCount && outboxIndex[0].seq == seq) outboxRemoveOldestLocked();
+    xSemaphoreGive(outboxMutex);
+    return true;
+  }
+
+  unsigned long t0 = millis();
+  if (outboxStats.drainSessionEnd == 0 || t0 - outboxStats.drainSessionEnd > 5000) {
+    outboxStats.drainSessionStart = t0;
+    outboxStats.drainSessionBytes = 0;
+  }
+  outboxStats.attempts++;
+  h.caption[sizeof(h.caption) - 12] = 0;
+  strcat(h.caption, " (delayed)");
+  bool ok = sendPhotoBuffer(buf, h.len, h.caption);
+  free(buf);
+  bool retry = !ok && uploadFailureRetryable();
+
+  xSemaphoreTake(outboxMutex, portMAX_DELAY);
+  bool head = outboxCount && outboxIndex[0].seq == seq;
+  uint8_t tries = head ? ++outboxIndex[0].attempts : 0;
+  bool drop = !ok && (!retry || tries >= OUTBOX_MAX_ATTEMPTS);
+  if ((ok || drop) && head) outboxRemoveOldestLocked();
+  if (ok) {
+    outboxStats.drained++;
+    outboxStats.drainSessionBytes += h.len;
+    outboxStats.drainSessionEnd = millis();
+    outboxKick();
+    logEvent(EV_OUTBOX_SENT, (int32_t)h.len, outboxCount);
+  } else {
+    outboxStats.failures++;
+    if (drop) outboxStats.dropped++;
+    if (retry) outboxScheduleRetry();
+  }
+  xSemaphoreGive(outboxMutex);
+  if (drop) logEvent(EV_OUTBOX_DROP, uploadFailStatus(), tries);
+
+  // An album parked photo by photo is still one capture: counted as sent
+  // once, with its first photo that gets through
+  bool newJob = h.parts <= 1 || h.group != outboxCountedGroup;
+  if (ok && newJob) outboxCountedGroup = h.group;
+  onUploadFinished(ok, newJob);
+  return ok || !retry;
+}
+
+int outboxDepth() {
+  return outboxCount;
+}
+
+void fillOutboxStatus(JsonObject o) {
+  o["depth"] = outboxCount;
+  o["pendingKB"] = outboxBytes / 1024;
+  o["quotaKB"] = OUTBOX_QUOTA_KB;
+}
+
+void fillOutboxStats(JsonObject o) {
+  fillOutboxStatus(o);
+  o["stored"] = outboxStats.stored;
+  o["drained"] = outboxStats.drained;
+  o["evicted"] = outboxStats.evicted;
+  o["rejected"] = outboxStats.rejected;
+  o["corrupt"] = outboxStats.corrupt;
+  o["attempts"] = outboxStats.attempts;
+  o["failures"] = outboxStats.failures;
+  o["dropped"] = outboxStats.dropped;
+  o["unsendable"] = outboxStats.unsendable;
+  o["backoffMs"] = outboxBackoffMs;
+  long wait = outboxWaiting ? (long)(outboxNextAttemptMs - millis()) : 0;
+  o["nextRetryMs"] = wait > 0 ? wait : 0;
+  unsigned long span = outboxStats.drainSessionEnd - outboxStats.drainSessionStart;
+  o["drainKBps"] = span ? (float)outboxStats.drainSessionBytes / 1.024f / span : 0.0f;
+  o["spiffsFreeKB"] = (SPIFFS.totalBytes() - SPIFFS.usedBytes()) / 1024;
+}
+
+// /metrics: photos given up on
+int outboxMetricsText(char* buf, size_t size) {
+  return snprintf(buf, size,
+                  "# TYPE esp32cam_outbox_dropped_total counter\nesp32cam_outbox_dropped_total %lu\n"
+                  "# TYPE esp32cam_upload_unsendable_total counter\nesp32cam_upload_unsendable_total %lu\n",
+                  (unsigned long)outboxStats.dropped, (unsigned long)outboxStats.unsendable);
+}
+
+void outboxStatsLine(FixedText& out) {
+  unsigned long span = outboxStats.drainSessionEnd - outboxStats.drainSessionStart;
+  out.addf("outbox: %d pending (%lu KB), %lu drained, %.1f KB/s", (int)outboxCount,
+           (unsigned long)(outboxBytes / 1024), (unsigned long)outboxStats.drained,
+           span ? outboxStats.drainSessionBytes / 1.024f / span : 0.0f);
+}
+
+#endif
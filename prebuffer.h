@@ -0,0 +1,333 @@
+#ifndef PREBUFFER_H
+#define PREBUFFER_H
+
+// ------------ Pre-event frame ring (PSRAM) ------------
+// Every frame detectMotion() looks at is copied into a byte-bounded ring
+// (preEventKB), so when motion fires the frames *before* the trigger are
+// still there. A motion event pins the trigger frame plus preEventFrames
+// older ones, keeps pinning the next postEventFrames frames, then goes to
+// the upload queue as one sendMediaGroup album. The album is sent straight
+// from the ring (body parts point into it) and unpinned afterwards; while
+// frames are pinned the ring drops new frames rather than overwrite them.
+
+#define PREBUFFER_MAX_KB 4096
+#define PREBUFFER_ENTRIES 48
+#define PREBUFFER_EVENTS 2
+static_assert(PREBUFFER_EVENTS <= 32, "prebufferPush() collects closed events in a 32-bit mask");
+#define PREBUFFER_ALBUM_MAX TELEGRAM_ALBUM_MAX
+#ifndef PREBUFFER_POST_TIMEOUT_MS
+#define PREBUFFER_POST_TIMEOUT_MS 8000UL // close an event even if motion checks stop
+#endif
+
+struct PreFrame {
+  uint32_t off;
+  uint32_t len;
+  uint32_t seq;
+  unsigned long ms;
+  uint8_t pins;          // events still holding this frame
+};
+
+struct PreEvent {
+  bool used;
+  bool open;             // still collecting post-event frames
+  uint32_t firstSeq;
+  uint32_t lastSeq;
+  uint8_t postLeft;
+  unsigned long startMs;
+  char caption[96];
+};
+
+struct PrebufferStats {
+  uint32_t pushed = 0;
+  uint32_t evicted = 0;
+  uint32_t pinnedDrops = 0;    // new frames refused: pinned frames in the way (or frame > ring)
+  uint32_t events = 0;
+  uint32_t eventFrames = 0;
+  uint32_t eventsRejected = 0; // no free event slot / empty ring
+  unsigned long lastPushUs = 0;
+};
+
+static uint8_t* preRing = nullptr;
+static uint32_t preCap = 0;
+static uint32_t preWritePos = 0;
+static PreFrame preFrames[PREBUFFER_ENTRIES];
+static int preHead = 0;        // oldest
+static int preCount = 0;
+static uint32_t preSeq = 0;
+static PreEvent preEvents[PREBUFFER_EVENTS];
+static SemaphoreHandle_t preMutex = nullptr;
+static PrebufferStats preStats;
+
+// Clamp the three settings to what the ring and Telegram can handle
+void clampPrebufferSettings() {
+  if (preEventKB < 0) preEventKB = 0;
+  if (preEventKB > PREBUFFER_MAX_KB) preEventKB = PREBUFFER_MAX_KB;
+  if (preEventFrames < 0) preEventFrames = 0;
+  if (postEventFrames < 0) postEventFrames = 0;
+  if (preEventFrames > PREBUFFER_ALBUM_MAX - 1) preEventFrames = PREBUFFER_ALBUM_MAX - 1;
+  if (preEventFrames + 1 + postEventFrames > PREBUFFER_ALBUM_MAX) {
+    postEventFrames = PREBUFFER_ALBUM_MAX - 1 - preEventFrames;
+  }
+}
+
+static bool prePinnedLocked() {
+  for (int i = 0; i < PREBUFFER_EVENTS; i++) if (preEvents[i].used) return true;
+  return false;
+}
+
+// (Re)allocates the ring for preEventKB; deferred while an event holds frames
+static void applyPrebufferSizeLocked() {
+  uint32_t want = (uint32_t)preEventKB * 1024UL;
+  if (want == preCap || prePinnedLocked()) return;
+
+  free(preRing);
+  preRing = nullptr;
+  preCap = 0;
+  preHead = preCount = 0;
+  preWritePos = 0;
+  if (want == 0) return;
+
+  // PSRAM only: the ring would not fit next to the camera in internal RAM
+  preRing = psramFound() ? (uint8_t*)ps_malloc(want) : nullptr;
+  if (preRing) {
+    preCap = want;
+  } else {
+    Serial.printf("Pre-event ring: %u KB not available\n", (unsigned)preEventKB);
+  }
+}
+
+void applyPrebufferSettings() {
+  if (!preMutex) return;
+  clampPrebufferSettings();
+  xSemaphoreTake(preMutex, portMAX_DELAY);
+  applyPrebufferSizeLocked();
+  xSemaphoreGive(preMutex);
+}
+
+void startPrebuffer() {
+  preMutex = xSemaphoreCreateMutex();
+  applyPrebufferSettings();
+}
+
+static PreFrame& preAt(int i) {
+  return preFrames[(preHead + i) % PREBUFFER_ENTRIES];
+}
+
+// Makes room for `len` bytes; false if a pinned frame is in the way
+static bool preReserveLocked(uint32_t len, uint32_t& pos) {
+  if (len > preCap) return false;
+  pos = preWritePos;
+  bool wrap = pos + len > preCap;
+  if (wrap) pos = 0;
+
+  while (preCount > 0) {
+    const PreFrame& o = preAt(0);
+    bool overlaps = o.off < pos + len && pos < o.off + o.len;
+    bool skipped = wrap && o.off >= preWritePos;   // tail we are wrapping past
+    if (!overlaps && !skipped && preCount < PREBUFFER_ENTRIES) break;
+    if (o.pins) return false;
+    preHead = (preHead + 1) % PREBUFFER_ENTRIES;
+    preCount--;
+    preStats.evicted++;
+  }
+  return true;
+}
+
+static void closeEvent(int e);
+
+// detectMotion(): copy the frame it just analysed into the ring
+void prebufferPush(const uint8_t* buf, size_t len) {
+  if (!preMutex || !preRing) return;
+  unsigned long t0 = micros();
+  uint32_t closed = 0;            // bit e: event e took its last frame
+
+  xSemaphoreTake(preMutex, portMAX_DELAY);
+  uint32_t pos;
+  if (!preReserveLocked(len, pos)) {
+    preStats.pinnedDrops++;
+    xSemaphoreGive(preMutex);
+    return;
+  }
+  memcpy(preRing + pos, buf, len);
+  preWritePos = pos + len;
+
+  PreFrame& f = preFrames[(preHead + preCount) % PREBUFFER_ENTRIES];
+  f.off = pos;
+  f.len = len;
+  f.seq = ++preSeq;
+  f.ms = millis();
+  f.pins = 0;
+  preCount++;
+  preStats.pushed++;
+
+  for (int e = 0; e < PREBUFFER_EVENTS; e++) {
+    PreEvent& ev = preEvents[e];
+    if (!ev.used || !ev.open) continue;
+    f.pins++;
+    ev.lastSeq = f.seq;
+    if (--ev.postLeft == 0) {
+      ev.open = false;
+      closed |= 1UL << e;
+    }
+  }
+  preStats.lastPushUs = micros() - t0;
+  xSemaphoreGive(preMutex);
+
+  for (int e = 0; e < PREBUFFER_EVENTS; e++) {
+    if (closed & (1UL << e)) closeEvent(e);
+  }
+}
+
+// Motion fired on the newest frame: pin it plus preEventFrames before it.
+// False when the ring is off/empty or both event slots are busy; the caller
+// then falls back to a single captureImage().
+bool prebufferTrigger(const char* caption) {
+  if (!preMutex || !preRing || preEventFrames + 1 + postEventFrames < 2) return false;
+
+  xSemaphoreTake(preMutex, portMAX_DELAY);
+  int e = -1;
+  for (int i = 0; i < PREBUFFER_EVENTS; i++) {
+    if (!preEvents[i].used) { e = i; break; }
+  }
+  if (e < 0 || preCount == 0) {
+    preStats.eventsRejected++;
+    xSemaphoreGive(preMutex);
+    return false;
+  }
+
+  int n = preEventFrames + 1;
+  if (n > preCount) n = preCount;
+  for (int i = preCount - n; i < preCount; i++) preAt(i).pins++;
+
+  PreEvent& ev = preEvents[e];
+  ev.used = true;
+  ev.open = postEventFrames > 0;
+  ev.firstSeq = preAt(preCount - n).seq;
+  ev.lastSeq = preAt(preCount - 1).seq;
+  ev.postLeft = (uint8_t)postEventFrames;
+  ev.startMs = millis();
+  strncpy(ev.caption, caption, sizeof(ev.caption) - 1);
+  ev.caption[sizeof(ev.caption) - 1] = 0;
+  preStats.events++;
+  xSemaphoreGive(preMutex);
+
+  if (!ev.open) closeEvent(e);
+  return true;
+}
+
+static int preEventFrameCount(const PreEvent& ev) {
+  return (int)(ev.lastSeq - ev.firstSeq + 1);
+}
+
+static void closeEvent(int e) {
+  PreEvent& ev = preEvents[e];
+  preStats.eventFrames += preEventFrameCount(ev);
+  if (!enqueueAlbum(e, ev.caption)) releasePreEvent(e);
+}
+
+// loop(): close events whose post frames never came (motion checks stopped)
+void prebufferTick() {
+  if (!preMutex) return;
+  uint32_t closed = 0;
+  xSemaphoreTake(preMutex, portMAX_DELAY);
+  for (int e = 0; e < PREBUFFER_EVENTS; e++) {
+    PreEvent& ev = preEvents[e];
+    if (ev.used && ev.open && millis() - ev.startMs > PREBUFFER_POST_TIMEOUT_MS) {
+      ev.open = false;
+      closed |= 1UL << e;
+    }
+  }
+  xSemaphoreGive(preMutex);
+  for (int e = 0; e < PREBUFFER_EVENTS; e++) {
+    if (closed & (1UL << e)) closeEvent(e);
+  }
+}
+
+// Upload task (or queue eviction): unpin the event's frames
+void releasePreEvent(int e) {
+  if (!preMutex || e < 0 || e >= PREBUFFER_EVENTS) return;
+  xSemaphoreTake(preMutex, portMAX_DELAY);
+  PreEvent& ev = preEvents[e];
+  for (int i = 0; i < preCount; i++) {
+    PreFrame& f = preAt(i);
+    if (f.seq >= ev.firstSeq && f.seq <= ev.lastSeq && f.pins) f.pins--;
+  }
+  ev.used = false;
+  ev.open = false;
+  applyPrebufferSizeLocked();   // a resize may have been waiting for this
+  xSemaphoreGive(preMutex);
+}
+
+// Upload task: one sendMediaGroup with the event's frames, sent from the ring
+bool sendPreEventAlbum(int e) {
+  const uint8_t* bufs[PREBUFFER_ALBUM_MAX];
+  size_t lens[PREBUFFER_ALBUM_MAX];
+  int n = 0;
+  PreEvent& ev = preEvents[e];
+
+  xSemaphoreTake(preMutex, portMAX_DELAY);
+  for (int i = 0; i < preCount && n < PREBUFFER_ALBUM_MAX; i++) {
+    const PreFrame& f = preAt(i);
+    if (f.seq < ev.firstSeq || f.seq > ev.lastSeq) continue;
+    bufs[n] = preRing + f.off;
+    lens[n] = f.len;
+    n++;
+  }
+  xSemaphoreGive(preMutex);   // pinned frames neither move nor get overwritten
+  if (n == 0) return false;
+  if (n == 1) return sendPhotoBuffer(bufs[0], lens[0], ev.caption);
+  return sendAlbumBuffers(bufs, lens, n, ev.caption);
+}
+
+// Upload task: the album failed, park its frames in the outbox one by one
+void storePreEventInOutbox(int e) {
+  PreEvent& ev = preEvents[e];
+  int n = preEventFrameCount(ev);
+  int i = 0;
+  for (uint32_t seq = ev.firstSeq; seq <= ev.lastSeq; seq++) {
+    const PreFrame* f = nullptr;
+    xSemaphoreTake(preMutex, portMAX_DELAY);
+    for (int k = 0; k < preCount; k++) {
+      if (preAt(k).seq == seq) { f = &preAt(k); break; }
+    }
+    xSemaphoreGive(preMutex);
+    if (!f) continue;
+    InlineText<24> part;
+    part.addf("Motion %d/%d", i + 1, n);
+    outboxStore(preRing + f->off, f->len, i == 0 ? ev.caption : part.c_str(), (uint8_t)i, (uint8_t)n);
+    i++;
+  }
+}
+
+void fillPrebufferStatus(JsonObject o) {
+  o["ringKB"] = preEventKB;
+  o["preFrames"] = preEventFrames;
+  o["postFrames"] = postEventFrames;
+  if (!preMutex) return;
+
+  xSemaphoreTake(preMutex, portMAX_DELAY);
+  uint32_t used = 0;
+  for (int i = 0; i < preCount; i++) used += preAt(i).len;
+  o["allocatedKB"] = preCap / 1024;
+  o["usedKB"] = used / 1024;
+  o["frames"] = preCount;
+  o["historyMs"] = preCount ? millis() - preAt(0).ms : 0;
+  int pending = 0;
+  for (int e = 0; e < PREBUFFER_EVENTS; e++) if (preEvents[e].used) pending++;
+  o["pendingEvents"] = pending;
+  xSemaphoreGive(preMutex);
+
+  o["events"] = preStats.events;
+  o["framesPerEvent"] = preStats.events ? (float)preStats.eventFrames / preStats.events : 0.0f;
+  o["eventsRejected"] = preStats.eventsRejected;
+  o["pinnedDrops"] = preStats.pinnedDrops;
+  o["evicted"] = preStats.evicted;
+  o["lastPushUs"] = preStats.lastPushUs;
+}
+
+void prebufferSettingsLine(FixedText& out) {
+  out.addf("Pre-event ring: %d KB (%lu KB allocated, %d frames), %d before + %d after", preEventKB,
+           (unsigned long)(preCap / 1024), (int)preCount, preEventFrames, postEventFrames);
+}
+
+#endif
@@ -0,0 +1,283 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <sys/time.h>
+
+// ------------ Deadline-based capture scheduler ------------
+// Every scheduled capture has an absolute deadline. The time-based mode
+// (captureMode 1/2, every `timeInterval` minutes) is job 0; the wall-clock
+// rules from /schedule ("every 10 min between 22:00 and 06:00") are jobs
+// 1..n. Once NTP has set the clock, deadlines are epoch milliseconds aligned
+// to local midnight, so "every 5 min" fires at :00, :05, ...; before that
+// job 0 runs on millis() and windowed rules wait for the clock.
+//
+// A deadline found more than SCHED_GRACE_MS late (an upload or a long
+// command held loop()) counts as missed: SCHED_CATCH_UP still captures once
+// right away, SCHED_SKIP drops it. Either way the next deadline is the
+// first slot after now, so a long stall never produces a burst.
+// schedMsUntilNext() gives loop() one number to sleep on.
+
+#define SCHED_GRACE_MS 2000
+#define SCHED_MAX_IDLE_MS 1000          // loop() wakes at least this often
+#define SCHED_MIN_EPOCH 1609459200L     // 2021-01-01: anything earlier means "not synced"
+#ifndef SCHED_INTERVAL_POLICY
+#define SCHED_INTERVAL_POLICY SCHED_CATCH_UP
+#endif
+
+struct SchedJob {
+  ScheduleRule rule;      // what `due` was planned with
+  bool active;
+  bool wallClock;         // due is epoch ms (else millis())
+  int64_t due;
+};
+
+struct SchedStats {
+  uint32_t fired = 0;
+  uint32_t missed = 0;        // found later than SCHED_GRACE_MS
+  uint32_t suppressed = 0;    // another capture in the last 30 s
+  uint32_t deadlines = 0;     // acted on (fired or suppressed), for the jitter average
+  unsigned long lastLateMs = 0;
+  unsigned long maxLateMs = 0;
+  uint64_t totalLateMs = 0;   // over fired deadlines: schedule jitter
+};
+
+static SchedJob schedJobs[1 + SCHED_MAX_RULES];
+static SchedStats schedStats;
+
+static bool schedClockSynced() {
+  return time(nullptr) > SCHED_MIN_EPOCH;
+}
+
+static int64_t schedEpochMs() {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+// First slot of `r` at or after `from` (epoch seconds, local time)
+static time_t nextWallSlot(const ScheduleRule& r, time_t from) {
+  struct tm lt;
+  localtime_r(&from, &lt);
+  lt.tm_hour = lt.tm_min = lt.tm_sec = 0;
+  time_t midnight = mktime(&lt);
+  long window = r.startMin == r.endMin ? 1440L : (r.endMin + 1440L - r.startMin) % 1440L;
+  long period = r.periodMin * 60L;
+
+  // A window that started yesterday may still be open (22:00 -> 06:00)
+  time_t best = 0;
+  for (int d = -1; d <= 1; d++) {
+    time_t base = midnight + d * 86400L + r.startMin * 60L;
+    long k = from > base ? (long)((from - base + period - 1) / period) : 0;
+    if (k * (long)r.periodMin >= window) continue;
+    time_t t = base + k * period;
+    if (best == 0 || t < best) best = t;
+  }
+  return best;
+}
+
+static bool schedRuleFor(int job, ScheduleRule& r) {
+  if (job == 0) {
+    if (captureMode != 1 && captureMode != 2) return false;
+    r.periodMin = (uint16_t)(timeInterval < 1 ? 1 : timeInterval);
+    r.startMin = r.endMin = 0;
+    r.policy = SCHED_INTERVAL_POLICY;
+    return true;
+  }
+  if (job > scheduleRuleCount) return false;
+  r = scheduleRules[job - 1];
+  return r.periodMin > 0;
+}
+
+static bool sameRule(const ScheduleRule& a, const ScheduleRule& b) {
+  return a.periodMin == b.periodMin && a.startMin == b.startMin && a.endMin == b.endMin &&
+         a.policy == b.policy;
+}
+
+// Plans the first deadline at or after `fromMs` in the job's time base
+static void schedPlan(int job, SchedJob& j, bool synced, int64_t fromMs) {
+  bool allDay = j.rule.startMin == j.rule.endMin;
+  if (synced) {
+    j.wallClock = true;
+    j.due = (int64_t)nextWallSlot(j.rule, (time_t)((fromMs + 999) / 1000)) * 1000;
+  } else if (job == 0 && allDay) {
+    j.wallClock = false;
+    j.due = fromMs + (int64_t)j.rule.periodMin * 60000;
+  } else {
+    j.due = 0;    // needs the wall clock
+  }
+}
+
+static void schedFire(int job) {
+  if (millis() - lastCaptureMillis <= 30000) {
+    schedStats.suppressed++;
+    return;
+  }
+  schedStats.fired++;
+  captureImage(job == 0 ? "Time Based" : "Schedule " + String(job), true);
+}
+
+// Called from loop()
+void schedulerTick() {
+  bool synced = schedClockSynced();
+  int64_t wallNow = synced ? schedEpochMs() : 0;
+  int64_t monoNow = (int64_t)millis();
+
+  for (int i = 0; i <= SCHED_MAX_RULES; i++) {
+    SchedJob& j = schedJobs[i];
+    ScheduleRule r;
+    if (!schedRuleFor(i, r)) {
+      j.active = false;
+      continue;
+    }
+    // (Re)plan on a new or changed rule, and when NTP sync arrives
+    if (!j.active || !sameRule(j.rule, r) || (synced && !j.wallClock) || j.due == 0) {
+      j.active = true;
+      j.rule = r;
+      schedPlan(i, j, synced, synced ? wallNow : monoNow);
+      continue;
+    }
+
+    int64_t now = j.wallClock ? wallNow : monoNow;
+    if (now < j.due) continue;
+
+    unsigned long late = (unsigned long)(now - j.due);
+    bool missed = late > SCHED_GRACE_MS;
+    if (missed) {
+      schedStats.missed++;
+      logEvent(EV_SCHED_MISSED, i, (int32_t)late);
+    }
+    if (!missed || j.rule.policy == SCHED_CATCH_UP) {
+      schedStats.deadlines++;
+      schedStats.lastLateMs = late;
+      schedStats.totalLateMs += late;
+      if (late > schedStats.maxLateMs) schedStats.maxLateMs = late;
+      schedFire(i);
+    }
+    // Next slot after this deadline and not in the past
+    if (j.wallClock) {
+      schedPlan(i, j, true, j.due + 1000 > now ? j.due + 1000 : now);
+    } else {
+      int64_t period = (int64_t)j.rule.periodMin * 60000;
+      do j.due += period; while (j.due <= now);
+    }
+  }
+}
+
+// Milliseconds until the earliest deadline, capped at SCHED_MAX_IDLE_MS
+unsigned long schedMsUntilNext() {
+  int64_t wallNow = schedClockSynced() ? schedEpochMs() : 0;
+  int64_t monoNow = (int64_t)millis();
+  int64_t best = SCHED_MAX_IDLE_MS;
+  for (int i = 0; i <= SCHED_MAX_RULES; i++) {
+    const SchedJob& j = schedJobs[i];
+    if (!j.active || j.due == 0) continue;
+    int64_t wait = j.due - (j.wallClock ? wallNow : monoNow);
+    if (wait < best) best = wait;
+  }
+  return best > 0 ? (unsigned long)best : 0;
+}
+
+// "every 10 min 22:00-06:00 (skip)"
+static FixedText& addSchedRule(FixedText& out, const ScheduleRule& r) {
+  out.addf("every %u min", (unsigned)r.periodMin);
+  if (r.startMin != r.endMin) {
+    out.addf(" %02u:%02u-%02u:%02u", r.startMin / 60, r.startMin % 60, r.endMin / 60, r.endMin % 60);
+  }
+  return out.add(r.policy == SCHED_SKIP ? " (skip)" : " (catch-up)");
+}
+
+// Seconds until job `i` is due, -1 if it has no deadline
+static long schedDueInS(int i) {
+  const SchedJob& j = schedJobs[i];
+  if (!j.active || j.due == 0) return -1;
+  int64_t now = j.wallClock ? schedEpochMs() : (int64_t)millis();
+  return j.due > now ? (long)((j.due - now) / 1000) : 0;
+}
+
+void fillScheduleStatus(JsonObject o) {
+  o["clockSynced"] = schedClockSynced();
+  o["fired"] = schedStats.fired;
+  o["missed"] = schedStats.missed;
+  o["suppressed"] = schedStats.suppressed;
+  o["lastLateMs"] = schedStats.lastLateMs;
+  o["maxLateMs"] = schedStats.maxLateMs;
+  o["avgLateMs"] = schedStats.deadlines ? (unsigned long)(schedStats.totalLateMs / schedStats.deadlines) : 0;
+  JsonArray jobs = o.createNestedArray("jobs");
+  for (int i = 0; i <= SCHED_MAX_RULES; i++) {
+    if (!schedJobs[i].active) continue;
+    JsonObject e = jobs.createNestedObject();
+    e["job"] = i;
+    InlineText<48> rule;
+    addSchedRule(rule, schedJobs[i].rule);
+    e["rule"] = (char*)rule.c_str();   // char*: copied into the document
+    e["dueInS"] = schedDueInS(i);
+  }
+}
+
+void scheduleText(FixedText& out) {
+  out.addf("🗓️ Schedule (%s):\n", schedClockSynced() ? "NTP time" : "clock not synced");
+  ScheduleRule r;
+  if (schedRuleFor(0, r)) addSchedRule(out.add("0: "), r).addf(" [mode %d]\n", captureMode);
+  for (int i = 1; i <= scheduleRuleCount; i++) {
+    addSchedRule(out.addf("%d: ", i), scheduleRules[i - 1]);
+    long due = schedDueInS(i);
+    if (due >= 0) out.addf(", next in %ld min", due / 60);
+    out.add("\n");
+  }
+  out.addf("fired %lu, missed %lu, suppressed %lu, late avg %lu ms / max %lu ms",
+           (unsigned long)schedStats.fired, (unsigned long)schedStats.missed,
+           (unsigned long)schedStats.suppressed,
+           schedStats.deadlines ? (unsigned long)(schedStats.totalLateMs / schedStats.deadlines) : 0UL,
+           (unsigned long)schedStats.maxLateMs);
+}
+
+// "HH:MM" -> minute of day, -1 if malformed
+static int parseClock(const char* s) {
+  int h, m;
+  if (sscanf(s, "%d:%d", &h, &m) != 2 || h < 0 || h > 23 || m < 0 || m > 59) return -1;
+  return h * 60 + m;
+}
+
+// /schedule add MIN [HH:MM HH:MM] [skip|catchup]; the reason for a refusal is appended to `error`
+bool addScheduleRule(const char* args, FixedText& error) {
+  if (scheduleRuleCount >= SCHED_MAX_RULES) {
+    error.addf("at most %d rules", SCHED_MAX_RULES);
+    return false;
+  }
+  char from[8] = "", to[8] = "", policy[12] = "";
+  int period = 0;
+  int n = sscanf(args, "%d %7s %7s %11s", &period, from, to, policy);
+  if (n == 2) {                     // MIN skip|catchup
+    strcpy(policy, from);
+    from[0] = 0;
+  }
+  bool policyOk = !policy[0] || !strcmp(policy, "skip") || !strcmp(policy, "catchup");
+  if (n < 1 || period < 1 || period > 1440 || !policyOk) {
+    error.add("usage: /schedule add MIN [HH:MM HH:MM] [skip|catchup]");
+    return false;
+  }
+  ScheduleRule r;
+  r.periodMin = (uint16_t)period;
+  r.startMin = r.endMin = 0;
+  if (from[0]) {
+    int a = parseClock(from), b = parseClock(to);
+    if (a < 0 || b < 0) {
+      error.add("times must be HH:MM");
+      return false;
+    }
+    r.startMin = (uint16_t)a;
+    r.endMin = (uint16_t)b;
+  }
+  r.policy = strcmp(policy, "skip") == 0 ? SCHED_SKIP : SCHED_CATCH_UP;
+  scheduleRules[scheduleRuleCount++] = r;
+  return true;
+}
+
+bool removeScheduleRule(int index) {
+  if (index < 1 || index > scheduleRuleCount) return false;
+  for (int i = index; i < scheduleRuleCount; i++) scheduleRules[i - 1] = scheduleRules[i];
+  scheduleRuleCount--;
+  return true;
+}
+
+#endif
@@ -0,0 +1,296 @@
+#ifndef SETTINGS_STORE_H
+#define SETTINGS_STORE_H
+
+// ------------ Settings and counters: append-only record log ------------
+// Replaces rewriting the EEPROM Persisted struct (a 4 KB flash sector erase
+// per commit) on every throttled save. Each save appends small CRC-checked
+// records to a SPIFFS log, the same way offset_journal.h keeps the Telegram
+// offset:
+//   STORE_KEY_SETTINGS       full StoredSettings, only when something changed
+//   STORE_KEY_COUNTERS       absolute captured/sent counts
+//   STORE_KEY_COUNTER_DELTA  captured/sent increments since the previous save
+// On boot the newest settings record wins and the counters are the newest
+// absolute record plus every delta after it. A torn or corrupt tail ends the
+// scan and forces a compaction, so later appends are never hidden behind it;
+// a failed or partial append schedules the same compaction.
+// Once the log passes STORE_COMPACT_BYTES, loop() rewrites it as one settings
+// and one counters record (write tmp -> remove -> rename; boot falls back to
+// tmp if interrupted). With no log yet, the legacy EEPROM struct is migrated.
+//
+// Schema: records carry STORE_SCHEMA_VERSION. New StoredSettings fields go at
+// the end and must treat 0 as "default"; shorter (older) records are
+// zero-filled, records from a newer schema are skipped.
+// Only used from setup() and loop(), so there is no lock.
+
+#define STORE_FILE "/settings.log"
+#define STORE_TMP  "/settings.tmp"
+#define STORE_MAGIC 0x53                 // 'S'
+#define STORE_SCHEMA_VERSION 1
+#ifndef STORE_COMPACT_BYTES
+#define STORE_COMPACT_BYTES 4096
+#endif
+#define STORE_COMPACT_RETRY_MS 60000UL   // after a failed compaction (flash full)
+#define STORE_FLASH_SECTOR 4096          // SPIFFS erases a block per 4 KB written
+
+enum StoreKey : uint8_t {
+  STORE_KEY_SETTINGS = 1,
+  STORE_KEY_COUNTERS = 2,
+  STORE_KEY_COUNTER_DELTA = 3
+};
+
+struct StoreRecordHeader {
+  uint8_t magic;
+  uint8_t version;
+  uint8_t key;
+  uint8_t len;            // payload bytes; a uint32_t CRC over header + payload follows
+  uint32_t seq;
+};
+
+struct StoredSettings {
+  uint8_t mode;
+  uint8_t motionEn;
+  uint16_t intervalMin;
+  uint16_t threshold;
+  uint16_t preKB;
+  uint8_t preFrames;
+  uint8_t postFrames;
+  uint8_t dedupDistance;
+  uint8_t dedupHeartbeat;
+  uint8_t schedCount;
+  ScheduleRule sched[SCHED_MAX_RULES];
+};
+static_assert(sizeof(StoredSettings) < 256, "StoredSettings must fit one record");
+
+struct StoredCounters {
+  uint32_t captured;
+  uint32_t sent;
+};
+
+struct SettingsStoreStats {
+  uint32_t saves = 0;             // throttled saves (each was an EEPROM sector erase before)
+  uint32_t records = 0;           // appended since boot
+  uint32_t settingsRecords = 0;
+  uint32_t bytesWritten = 0;
+  uint32_t compactions = 0;
+  uint32_t tornTails = 0;
+  uint32_t failedWrites = 0;      // records cut short (flash full / write error)
+  bool migrated = false;
+  unsigned long lastSaveUs = 0;
+  unsigned long maxSaveUs = 0;
+  uint64_t totalSaveUs = 0;
+};
+
+static StoredSettings storeSettings;       // what the log holds
+static StoredCounters storeCounters;
+static bool storeHaveSettings = false;
+static uint32_t storeSeq = 0;
+static uint32_t storeBytes = 0;            // log file size
+static bool storeCompactPending = false;
+static unsigned long storeCompactFailedMs = 0;
+static SettingsStoreStats storeStats;
+
+static uint32_t storeRecordCrc(const StoreRecordHeader& h, const void* payload) {
+  uint32_t crc = crc32Update(0, (const uint8_t*)&h, sizeof(h));
+  return crc32Update(crc, (const uint8_t*)payload, h.len);
+}
+
+static bool writeStoreRecord(File& f, StoreKey key, const void* payload, uint8_t len) {
+  StoreRecordHeader h;
+  h.magic = STORE_MAGIC;
+  h.version = STORE_SCHEMA_VERSION;
+  h.key = key;
+  h.len = len;
+  h.seq = ++storeSeq;
+  uint32_t crc = storeRecordCrc(h, payload);
+  size_t n = f.write((const uint8_t*)&h, sizeof(h));
+  if (n == sizeof(h)) n += f.write((const uint8_t*)payload, len);
+  if (n == sizeof(h) + len) n += f.write((const uint8_t*)&crc, sizeof(crc));
+  storeBytes += n;
+  storeStats.bytesWritten += n;
+  if (n != sizeof(h) + len + sizeof(crc)) {
+    // A torn record ends the boot scan; rewrite the log before it hides more
+    storeStats.failedWrites++;
+    storeCompactPending = true;
+    return false;
+  }
+  storeStats.records++;
+  return true;
+}
+
+// Replays the log. Returns the number of valid records; `clean` is false when
+// the scan stopped at a torn or corrupt record before the end of the file.
+static uint32_t scanStore(const char* path, StoredSettings& s, bool& haveSettings, StoredCounters& c,
+                          uint32_t& bytes, bool& clean) {
+  clean = true;
+  bytes = 0;
+  File f = SPIFFS.open(path, "r");
+  if (!f) return 0;
+
+  uint32_t valid = 0;
+  uint8_t payload[256];
+  StoreRecordHeader h;
+  while (f.read((uint8_t*)&h, sizeof(h)) == sizeof(h)) {
+    uint32_t crc;
+    if (h.magic != STORE_MAGIC || f.read(payload, h.len) != h.len ||
+        f.read((uint8_t*)&crc, sizeof(crc)) != sizeof(crc) || crc != storeRecordCrc(h, payload)) {
+      clean = false;
+      break;
+    }
+    bytes += sizeof(h) + h.len + sizeof(crc);
+    valid++;
+    if (h.seq > storeSeq) storeSeq = h.seq;
+    if (h.version > STORE_SCHEMA_VERSION) continue;   // written by newer firmware
+
+    if (h.key == STORE_KEY_SETTINGS) {
+      memset(&s, 0, sizeof(s));
+      memcpy(&s, payload, h.len < sizeof(s) ? h.len : sizeof(s));
+      haveSettings = true;
+    } else if (h.key == STORE_KEY_COUNTERS && h.len >= sizeof(StoredCounters)) {
+      memcpy(&c, payload, sizeof(c));
+    } else if (h.key == STORE_KEY_COUNTER_DELTA && h.len >= sizeof(StoredCounters)) {
+      StoredCounters d;
+      memcpy(&d, payload, sizeof(d));
+      c.captured += d.captured;
+      c.sent += d.sent;
+    }
+  }
+  if (bytes != f.size()) clean = false;   // also a tail shorter than a header
+  f.close();
+  return valid;
+}
+
+// Rewrites the log as one settings and one counters record
+static bool compactStore(const StoredSettings* s, const StoredCounters& c) {
+  File t = SPIFFS.open(STORE_TMP, "w");
+  uint32_t logBytes = storeBytes;
+  storeBytes = 0;
+  bool ok = t && (!s || writeStoreRecord(t, STORE_KEY_SETTINGS, s, sizeof(*s))) &&
+            writeStoreRecord(t, STORE_KEY_COUNTERS, &c, sizeof(c));
+  if (t) t.close();
+  if (!ok) {
+    // The old log is still in place; try again later
+    SPIFFS.remove(STORE_TMP);
+    storeBytes = logBytes;
+    storeCompactPending = true;
+    storeCompactFailedMs = millis();
+    return false;
+  }
+  SPIFFS.remove(STORE_FILE);
+  SPIFFS.rename(STORE_TMP, STORE_FILE);
+  storeCompactPending = false;
+  storeCompactFailedMs = 0;
+  storeStats.compactions++;
+  logEvent(EV_STORE_COMPACT, (int32_t)storeBytes);
+  return true;
+}
+
+// setup(), SPIFFS mounted. False when there is no log yet (migrate or use defaults).
+bool settingsStoreLoad(StoredSettings& s, uint32_t& captured, uint32_t& sent) {
+  memset(&storeSettings, 0, sizeof(storeSettings));
+  memset(&storeCounters, 0, sizeof(storeCounters));
+  storeHaveSettings = false;
+
+  bool clean;
+  uint32_t n = scanStore(STORE_FILE, storeSettings, storeHaveSettings, storeCounters, storeBytes, clean);
+  if (n == 0) {
+    n = scanStore(STORE_TMP, storeSettings, storeHaveSettings, storeCounters, storeBytes, clean);
+    if (n > 0) {
+      // Compaction was interrupted between remove and rename
+      SPIFFS.rename(STORE_TMP, STORE_FILE);
+    }
+  }
+  if (n == 0) return false;
+  if (!clean) {
+    storeStats.tornTails++;
+    compactStore(storeHaveSettings ? &storeSettings : nullptr, storeCounters);
+  }
+
+  s = storeSettings;
+  captured = storeCounters.captured;
+  sent = storeCounters.sent;
+  Serial.printf("Settings store: %u records, %u bytes%s\n", (unsigned)n, (unsigned)storeBytes,
+                clean ? "" : " (torn tail dropped)");
+  return storeHaveSettings;
+}
+
+// setup(): first boot with the log; seeds it from the legacy EEPROM values
+void settingsStoreMigrate(const StoredSettings& s, uint32_t captured, uint32_t sent) {
+  storeSettings = s;
+  storeCounters.captured = captured;
+  storeCounters.sent = sent;
+  storeHaveSettings = compactStore(&storeSettings, storeCounters);
+  storeStats.migrated = storeHaveSettings;
+}
+
+// Appends what changed since the last save. `s` must be memset before filling
+// (padding is compared).
+void settingsStoreSave(const StoredSettings& s, uint32_t captured, uint32_t sent) {
+  unsigned long t0 = micros();
+  bool settingsChanged = !storeHaveSettings || memcmp(&s, &storeSettings, sizeof(s)) != 0;
+  bool countersChanged = captured != storeCounters.captured || sent != storeCounters.sent;
+  if (!settingsChanged && !countersChanged) return;
+
+  File f = SPIFFS.open(STORE_FILE, "a");
+  if (!f) {
+    Serial.println("Failed to open settings store for append");
+    return;
+  }
+  if (settingsChanged && writeStoreRecord(f, STORE_KEY_SETTINGS, &s, sizeof(s))) {
+    storeSettings = s;
+    storeHaveSettings = true;
+    storeStats.settingsRecords++;
+  }
+  if (countersChanged) {
+    StoredCounters c;
+    StoreKey key;
+    if (captured >= storeCounters.captured && sent >= storeCounters.sent) {
+      c.captured = captured - storeCounters.captured;
+      c.sent = sent - storeCounters.sent;
+      key = STORE_KEY_COUNTER_DELTA;
+    } else {
+      c.captured = captured;
+      c.sent = sent;
+      key = STORE_KEY_COUNTERS;
+    }
+    if (writeStoreRecord(f, key, &c, sizeof(c))) {
+      storeCounters.captured = captured;
+      storeCounters.sent = sent;
+    }
+  }
+  f.close();
+
+  if (storeBytes >= STORE_COMPACT_BYTES) storeCompactPending = true;
+  unsigned long dt = micros() - t0;
+  storeStats.saves++;
+  storeStats.lastSaveUs = dt;
+  storeStats.totalSaveUs += dt;
+  if (dt > storeStats.maxSaveUs) storeStats.maxSaveUs = dt;
+}
+
+// loop(): compaction runs here, never inside a save
+void settingsStoreTick() {
+  if (!storeCompactPending) return;
+  if (storeCompactFailedMs && millis() - storeCompactFailedMs < STORE_COMPACT_RETRY_MS) return;
+  compactStore(storeHaveSettings ? &storeSettings : nullptr, storeCounters);
+}
+
+void fillSettingsStoreStats(JsonObject o) {
+  o["saves"] = storeStats.saves;
+  o["records"] = storeStats.records;
+  o["settingsRecords"] = storeStats.settingsRecords;
+  o["logBytes"] = storeBytes;
+  o["bytesWritten"] = storeStats.bytesWritten;
+  o["compactions"] = storeStats.compactions;
+  o["tornTails"] = storeStats.tornTails;
+  o["failedWrites"] = storeStats.failedWrites;
+  o["compactPending"] = storeCompactPending;
+  // Estimate: SPIFFS reclaims one 4 KB block for every 4 KB written; the
+  // EEPROM struct cost one sector erase per save
+  o["estSectorErases"] = storeStats.bytesWritten / STORE_FLASH_SECTOR;
+  o["migratedFromEeprom"] = storeStats.migrated;
+  o["lastSaveUs"] = storeStats.lastSaveUs;
+  o["maxSaveUs"] = storeStats.maxSaveUs;
+  o["avgSaveUs"] = storeStats.saves ? (uint32_t)(storeStats.totalSaveUs / storeStats.saves) : 0;
+}
+
+#endif
@@ -0,0 +1,550 @@
+#ifndef TELEGRAM_COMMANDS_H
+#define TELEGRAM_COMMANDS_H
+
+// ------------ Telegram command registry ------------
+// Every command is one row of telegramCommands[]: name, argument schema,
+// usage, handler and /help line. An alias is a row with the same handler
+// and no help text; /help is generated from the table.
+//
+// Lookup is a compile-time perfect hash: FNV-1a of the name with
+// CMD_HASH_SEED, top CMD_HASH_BITS bits = slot. cmdSlotTable[] (slot -> row)
+// is built by constexpr functions, and a static_assert fails the build if
+// two names share a slot (pick another seed then). A lookup is one hash of
+// the name, one table read and one strcmp.
+//
+// Arguments are parsed in place in a stack copy of the message, following
+// the schema: 'i' integer, 'w' word, 'r' the rest of the line; upper case =
+// required. A parse failure answers with the row's usage line.
+//
+// Longer replies are formatted into telegramReply (fixed_text.h), one static
+// buffer shared by all handlers: commands only run from loop(), one at a time.
+
+#define CMD_MAX_ARGS 4
+#define TELEGRAM_REPLY_MAX 3072         // bytes; Telegram allows 4096 characters
+#define CMD_HASH_BITS 6
+#define CMD_HASH_SLOTS (1 << CMD_HASH_BITS)
+#define CMD_HASH_SEED 0x811C9E2AUL      // FNV offset basis + 101: first seed without collisions
+#define CMD_NONE 0xFF
+
+enum CommandGroup : uint8_t { CMD_GROUP_MAIN, CMD_GROUP_SETTINGS };
+
+struct CommandArgs {
+  uint8_t count;                   // parsed 'i'/'w' arguments
+  int32_t num[CMD_MAX_ARGS];       // value of 'i' arguments
+  const char* str[CMD_MAX_ARGS];   // token text of every argument
+  const char* rest;                // 'r' argument ("" when absent)
+};
+
+typedef void (*CommandHandler)(const CommandArgs& a);
+
+struct CommandSpec {
+  const char* name;                // without the slash, lower case
+  CommandHandler handler;
+  const char* schema;
+  const char* usage;               // shown in /help and on a parse error
+  const char* icon;
+  const char* help;                // nullptr: alias of the previous row with this handler
+  CommandGroup group;
+};
+
+struct CommandStats {
+  uint32_t dispatched = 0;
+  uint32_t unknown = 0;
+  uint32_t badArgs = 0;
+  uint32_t lastLookupCycles = 0;
+  uint32_t maxLookupCycles = 0;
+  uint64_t totalLookupCycles = 0;
+};
+
+static CommandStats commandStats;
+static InlineText<TELEGRAM_REPLY_MAX> telegramReply;
+
+static FixedText& beginReply() {
+  telegramReply.clear();
+  return telegramReply;
+}
+
+static void persistSettingsDirty() {
+  extern void markStatsDirty();
+  markStatsDirty();
+}
+
+static const char* modeName() {
+  return (captureMode == 0) ? "Motion" : (captureMode == 1) ? "Time" : "Mixed";
+}
+
+static FixedText& addLocalIp(FixedText& out) {
+  IPAddress ip = WiFi.localIP();
+  return out.addf("%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+}
+
+// ------------ Handlers ------------
+static void cmdHelp(const CommandArgs& a);
+
+static void cmdCapture(const CommandArgs& a) {
+  sendTelegramMessage("📸 Capturing photo...");
+  captureImage("Telegram Command");
+}
+
+static void cmdBurst(const CommandArgs& a) {
+  int n = a.count > 0 ? a.num[0] : 5;
+  int interval = a.count > 1 ? a.num[1] : 0;
+  bool single = a.count > 2 && strcmp(a.str[2], "single") == 0;
+  if (n < 2 || n > BURST_MAX_FRAMES || interval < 0 || (a.count > 2 && !single)) {
+    FixedText& r = beginReply();
+    r.addf("❌ usage: /burst N [interval_ms] [single] (N = 2..%d)", BURST_MAX_FRAMES);
+    sendTelegramMessage(r.c_str());
+    return;
+  }
+  InlineText<128> result;
+  bool ok = captureBurst(n, (unsigned long)interval, single, result);
+  FixedText& r = beginReply();
+  r.add(ok ? "🎞️ Burst: " : "❌ Burst: ").add(result.c_str());
+  sendTelegramMessage(r.c_str());
+}
+
+static void cmdStatus(const CommandArgs& a) {
+  FixedText& s = beginReply();
+  s.add("📊 Camera Status:\n\n");
+  addLocalIp(s.add("IP: ")).add("\n");
+  s.addf("WiFi: %d dBm\n", (WiFi.status() == WL_CONNECTED) ? (int)WiFi.RSSI() : 0);
+  s.addf("Uptime: %s\n", uptimeText().c_str());
+  s.addf("Captured: %d\n", capturedCount);
+  s.addf("Sent: %d\n", sentCount);
+  s.addf("Mode: %s", modeName());
+  s.addf("\nInterval: %d min", timeInterval);
+  s.addf("\nSensitivity: %d", motionThreshold);
+  s.addf("\nMotion: %s", motionEnabled ? "ON" : "OFF");
+  s.addf("\nLast motion: %d/%d cells, %lu ms", (int)lastMotion.changedCells, (int)lastMotion.totalCells,
+         lastMotionCostUs / 1000UL);
+  sendTelegramMessage(s.c_str());
+}
+
+static void cmdSettings(const CommandArgs& a) {
+  FixedText& s = beginReply();
+  s.add("⚙️ Current Settings:\n\n");
+  s.addf("Mode: %s", modeName());
+  s.addf("\nInterval: %d min", timeInterval);
+  s.addf("\nSensitivity: %d", motionThreshold);
+  s.addf("\nMotion: %s", motionEnabled ? "ON" : "OFF");
+  {
+    StatusLock lock;
+    s.addf("\nLast Capture: %s", lastCaptureTime.c_str());
+    s.addf("\nLast Telegram: %s", lastTelegramResult.c_str());
+  }
+  s.addf("\nUpload queue: %d/%d", uploadQueueDepth(), UPLOAD_QUEUE_DEPTH);
+  s.add("\n");
+  prebufferSettingsLine(s);
+  s.add("\n");
+  dedupSettingsLine(s);
+  s.addf("\nOutbox: %d photo(s) waiting", outboxDepth());
+  sendTelegramMessage(s.c_str());
+}
+
+static void cmdDebug(const CommandArgs& a) {
+  FixedText& s = beginReply();
+  s.add("🧠 Memory Debug:\n");
+  s.addf("freeHeap: %lu\n", (unsigned long)ESP.getFreeHeap());
+  s.addf("minHeap: %lu\n", (unsigned long)ESP.getMinFreeHeap());
+  s.addf("maxAlloc: %lu (lowest %lu)\n", (unsigned long)ESP.getMaxAllocHeap(),
+         (unsigned long)heapWatch.minMaxAlloc);
+  s.addf("fragmentation: %u%% (worst %u%%)\n", (unsigned)heapFragmentationPct(), (unsigned)heapWatch.maxFragPct);
+#if defined(BOARD_HAS_PSRAM) || defined(CONFIG_SPIRAM_SUPPORT)
+  s.addf("freePSRAM: %lu\n", (unsigned long)ESP.getFreePsram());
+#else
+  s.add("freePSRAM: 0\n");
+#endif
+  s.addf("reset: %s (%d)\n", resetReasonString(), resetReasonCode());
+  telegramLink.statsLine(s);
+  s.add("\n");
+  telegramPollStatsLine(s);
+  s.add("\n");
+  commandStatsLine(s);
+  s.add("\n");
+  mjpegStatsLine(s);
+  s.add("\n");
+  webStatsLine(s);
+  s.add("\n");
+  outboxStatsLine(s);
+  s.add("\n");
+  cameraStatsLine(s);
+  s.add("\n");
+  burstStatsLine(s);
+  s.add("\n");
+  fanoutStatsLine(s);
+  s.add("\n");
+  s.addf("motion check every %lu ms (max %lu), %lu us%s", motionGapMs, motionMaxGapMs, lastMotionCostUs,
+         motionFromStream ? " on stream frames" : "");
+  sendTelegramMessage(s.c_str());
+}
+
+static void cmdLog(const CommandArgs& a) {
+  FixedText& r = beginReply();
+  eventLogText(r, a.count ? a.num[0] : 20);
+  sendTelegramMessage(r.c_str());
+}
+
+static void cmdMetrics(const CommandArgs& a) {
+  FixedText& r = beginReply();
+  metricsSummary(r);
+  sendTelegramMessage(r.c_str());
+}
+
+static void cmdTest(const CommandArgs& a) {
+  sendTelegramMessage("🔍 Testing connection...");
+  testTelegramConnection();
+}
+
+static void cmdReboot(const CommandArgs& a) {
+  sendTelegramMessage("🔄 Restarting ESP32-CAM...");
+  logEvent(EV_REBOOT);
+  // This command's own offset was saved before it ran; a failure here only
+  // means some write-behind updates may be seen again after the restart
+  if (!flushUpdateOffset(true)) Serial.println("Offset flush failed before restart");
+  saveSettings();
+  delay(800);
+  ESP.restart();
+}
+
+static void cmdMotionOn(const CommandArgs& a) {
+  {
+    SettingsLock lock;
+    motionEnabled = true;
+  }
+  persistSettingsDirty();
+  sendTelegramMessage("✅ Motion detection enabled");
+}
+
+static void cmdMotionOff(const CommandArgs& a) {
+  {
+    SettingsLock lock;
+    motionEnabled = false;
+  }
+  persistSettingsDirty();
+  sendTelegramMessage("⭕ Motion detection disabled");
+}
+
+static void cmdMode(const CommandArgs& a) {
+  int m = a.num[0];
+  if (m < 0 || m > 2) {
+    sendTelegramMessage("❌ mode must be 0,1,2\n0=motion 1=time 2=mixed");
+    return;
+  }
+  {
+    SettingsLock lock;
+    captureMode = m;
+  }
+  persistSettingsDirty();
+  FixedText& r = beginReply();
+  sendTelegramMessage(r.addf("✅ Mode set to %d", m).c_str());
+}
+
+static void cmdInterval(const CommandArgs& a) {
+  int v = a.num[0];
+  if (v < 1 || v > 1000) {
+    sendTelegramMessage("❌ interval must be 1..1000 (minutes)");
+    return;
+  }
+  {
+    SettingsLock lock;
+    timeInterval = v;
+  }
+  persistSettingsDirty();
+  FixedText& r = beginReply();
+  sendTelegramMessage(r.addf("✅ Interval set to %d min", v).c_str());
+}
+
+static void cmdThreshold(const CommandArgs& a) {
+  int v = a.num[0];
+  if (v < 1000 || v > 20000) {
+    sendTelegramMessage("❌ threshold must be 1000..20000");
+    return;
+  }
+  {
+    SettingsLock lock;
+    motionThreshold = v;
+  }
+  persistSettingsDirty();
+  FixedText& r = beginReply();
+  sendTelegramMessage(r.addf("✅ Threshold set to %d", v).c_str());
+}
+
+static void cmdPrebuffer(const CommandArgs& a) {
+  if (a.num[0] < 0 || a.num[1] < 0 || a.num[2] < 0) {
+    sendTelegramMessage("❌ usage: /prebuffer KB PRE POST\ne.g. /prebuffer 768 3 2 (KB 0 = off)");
+    return;
+  }
+  {
+    SettingsLock lock;
+    preEventKB = a.num[0];
+    preEventFrames = a.num[1];
+    postEventFrames = a.num[2];
+    applyPrebufferSettings();
+  }
+  persistSettingsDirty();
+  FixedText& r = beginReply();
+  prebufferSettingsLine(r.add("✅ "));
+  sendTelegramMessage(r.c_str());
+}
+
+static void cmdDedup(const CommandArgs& a) {
+  if (a.count) {
+    char* end;
+    long n = strtol(a.str[0], &end, 10);
+    const char* mode = a.count > 1 ? a.str[1] : "";
+    bool off = strcmp(a.str[0], "off") == 0;
+    if (!off && (*end || n < 0 || n > DEDUP_MAX_DISTANCE ||
+                 (*mode && strcmp(mode, "heartbeat") && strcmp(mode, "silent")))) {
+      FixedText& r = beginReply();
+      r.addf("❌ usage: /dedup N [heartbeat|silent] (N = 1..%d differing bits of 64, 0/off = disabled)",
+             DEDUP_MAX_DISTANCE);
+      sendTelegramMessage(r.c_str());
+      return;
+    }
+    {
+      SettingsLock lock;
+      dedupDistance = off ? 0 : (int)n;
+      if (*mode) dedupHeartbeat = strcmp(mode, "heartbeat") == 0;
+    }
+    persistSettingsDirty();
+  }
+  FixedText& r = beginReply();
+  dedupSettingsLine(r.add("🪞 "));
+  sendTelegramMessage(r.c_str());
+}
+
+static void cmdSchedule(const CommandArgs& a) {
+  const char* args = a.rest;
+  if (strncmp(args, "add ", 4) == 0) {
+    FixedText& error = beginReply();
+    if (!addScheduleRule(args + 4, error.add("❌ "))) {
+      sendTelegramMessage(error.c_str());
+      return;
+    }
+    persistSettingsDirty();
+  } else if (strncmp(args, "del ", 4) == 0) {
+    if (!removeScheduleRule(atoi(args + 4))) {
+      sendTelegramMessage("❌ no such rule (see /schedule)");
+      return;
+    }
+    persistSettingsDirty();
+  } else if (strcmp(args, "clear") == 0) {
+    scheduleRuleCount = 0;
+    persistSettingsDirty();
+  } else if (*args) {
+    sendTelegramMessage("❌ usage: /schedule [add MIN [HH:MM HH:MM] [skip|catchup] | del N | clear]");
+    return;
+  }
+  FixedText& r = beginReply();
+  scheduleText(r);
+  sendTelegramMessage(r.c_str());
+}
+
+static void cmdStream(const CommandArgs& a) {
+  FixedText& r = beginReply();
+  addLocalIp(r.add("🌐 Live Stream:\nhttp://")).add("\n");
+  sendTelegramMessage(r.c_str());
+}
+
+// ------------ Registry ------------
+static constexpr CommandSpec telegramCommands[] = {
+  { "help",       cmdHelp,      "",    "",                  "🤖", "This list",                          CMD_GROUP_MAIN },
+  { "start",      cmdHelp,      "",    "",                  "",   nullptr,                              CMD_GROUP_MAIN },
+  { "capture",    cmdCapture,   "",    "",                  "📸", "Take photo",                         CMD_GROUP_MAIN },
+  { "photo",      cmdCapture,   "",    "",                  "",   nullptr,                              CMD_GROUP_MAIN },
+  { "pic",        cmdCapture,   "",    "",                  "",   nullptr,                              CMD_GROUP_MAIN },
+  { "burst",      cmdBurst,     "iiw", "N [ms] [single]",   "🎞️", "N frames as one album",              CMD_GROUP_MAIN },
+  { "status",     cmdStatus,    "",    "",                  "📊", "Camera status",                      CMD_GROUP_MAIN },
+  { "info",       cmdStatus,    "",    "",                  "",   nullptr,                              CMD_GROUP_MAIN },
+  { "test",       cmdTest,      "",    "",                  "🔍", "Test connection",                    CMD_GROUP_MAIN },
+  { "settings",   cmdSettings,  "",    "",                  "⚙️", "Current settings",                   CMD_GROUP_MAIN },
+  { "reboot",     cmdReboot,    "",    "",                  "🔄", "Restart camera",                     CMD_GROUP_MAIN },
+  { "restart",    cmdReboot,    "",    "",                  "",   nullptr,                              CMD_GROUP_MAIN },
+  { "debug",      cmdDebug,     "",    "",                  "🔧", "Memory info",                        CMD_GROUP_MAIN },
+  { "metrics",    cmdMetrics,   "",    "",                  "⏱️", "Stage latency summary",              CMD_GROUP_MAIN },
+  { "log",        cmdLog,       "i",   "N",                 "📜", "Last N events (kept across reboots)", CMD_GROUP_MAIN },
+  { "stream",     cmdStream,    "",    "",                  "🌐", "Live stream URL",                    CMD_GROUP_MAIN },
+  { "mode",       cmdMode,      "I",   "0|1|2",             "🎛️", "0=motion, 1=time, 2=mixed",          CMD_GROUP_SETTINGS },
+  { "interval",   cmdInterval,  "I",   "N",                 "⏱️", "Minutes, 1..1000",                   CMD_GROUP_SETTINGS },
+  { "threshold",  cmdThreshold, "I",   "N",                 "🎚️", "1000..20000",                        CMD_GROUP_SETTINGS },
+  { "motion_on",  cmdMotionOn,  "",    "",                  "✅", "Enable motion detection",            CMD_GROUP_SETTINGS },
+  { "motion_off", cmdMotionOff, "",    "",                  "⭕", "Disable motion detection",           CMD_GROUP_SETTINGS },
+  { "prebuffer",  cmdPrebuffer, "III", "KB PRE POST",       "🎞️", "Ring size, frames before/after motion", CMD_GROUP_SETTINGS },
+  { "schedule",   cmdSchedule,  "r",   "add MIN [HH:MM HH:MM] [skip|catchup] | del N | clear", "🗓️", "Wall-clock captures", CMD_GROUP_SETTINGS },
+  { "dedup",      cmdDedup,     "ww",  "N [heartbeat|silent]", "🪞", "Skip unchanged scheduled photos", CMD_GROUP_SETTINGS },
+};
+
+static constexpr uint8_t CMD_COUNT = sizeof(telegramCommands) / sizeof(telegramCommands[0]);
+
+// FNV-1a; constexpr so the table below is computed by the compiler
+static constexpr uint32_t cmdHash(const char* s, uint32_t h = CMD_HASH_SEED) {
+  return *s ? cmdHash(s + 1, (h ^ (uint8_t)*s) * 16777619UL) : h;
+}
+
+static constexpr uint8_t cmdSlot(const char* s) {
+  return (uint8_t)(cmdHash(s) >> (32 - CMD_HASH_BITS));
+}
+
+static constexpr uint8_t cmdRowForSlot(uint8_t slot, uint8_t row = 0) {
+  return row >= CMD_COUNT ? CMD_NONE
+         : cmdSlot(telegramCommands[row].name) == slot ? row
+         : cmdRowForSlot(slot, row + 1);
+}
+
+static constexpr bool cmdSlotFree(uint8_t row, uint8_t other) {
+  return other >= CMD_COUNT ||
+         (cmdSlot(telegramCommands[row].name) != cmdSlot(telegramCommands[other].name) &&
+          cmdSlotFree(row, other + 1));
+}
+
+static constexpr bool cmdHashIsPerfect(uint8_t row = 0) {
+  return row >= CMD_COUNT || (cmdSlotFree(row, row + 1) && cmdHashIsPerfect(row + 1));
+}
+
+static_assert(CMD_COUNT < CMD_NONE, "too many commands");
+static_assert(CMD_COUNT <= CMD_HASH_SLOTS, "raise CMD_HASH_BITS");
+static_assert(cmdHashIsPerfect(), "command names collide: change CMD_HASH_SEED");
+
+#define CMD_SLOTS_8(b)                                                                  \
+  cmdRowForSlot(b), cmdRowForSlot(b + 1), cmdRowForSlot(b + 2), cmdRowForSlot(b + 3), \
+  cmdRowForSlot(b + 4), cmdRowForSlot(b + 5), cmdRowForSlot(b + 6), cmdRowForSlot(b + 7)
+
+static constexpr uint8_t cmdSlotTable[CMD_HASH_SLOTS] = {
+  CMD_SLOTS_8(0),  CMD_SLOTS_8(8),  CMD_SLOTS_8(16), CMD_SLOTS_8(24),
+  CMD_SLOTS_8(32), CMD_SLOTS_8(40), CMD_SLOTS_8(48), CMD_SLOTS_8(56)
+};
+static_assert(CMD_HASH_SLOTS == 64, "cmdSlotTable lists 64 slots");
+
+static uint8_t findCommand(const char* name) {
+  uint8_t row = cmdSlotTable[cmdSlot(name)];
+  if (row == CMD_NONE || strcmp(telegramCommands[row].name, name) != 0) return CMD_NONE;
+  return row;
+}
+
+// Tokenises `p` in place following `schema`. False on a missing, malformed or extra argument.
+static bool parseCommandArgs(char* p, const char* schema, CommandArgs& a) {
+  a.count = 0;
+  a.rest = "";
+  for (const char* t = schema; *t; t++) {
+    while (*p == ' ') p++;
+    bool required = *t >= 'A' && *t <= 'Z';
+    char kind = *t | 0x20;
+    if (kind == 'r') {
+      a.rest = p;
+      return !required || *p;
+    }
+    if (!*p) {
+      if (required) return false;
+      continue;
+    }
+    char* tok = p;
+    while (*p && *p != ' ') p++;
+    if (*p) *p++ = 0;
+    if (kind == 'i') {
+      char* end;
+      a.num[a.count] = (int32_t)strtol(tok, &end, 10);
+      if (*end) return false;
+    }
+    a.str[a.count++] = tok;
+  }
+  while (*p == ' ') p++;
+  return *p == 0;
+}
+
+static void cmdHelp(const CommandArgs& a) {
+  FixedText& help = beginReply();
+  help.add("🤖 ESP32-CAM Bot Commands:\n\n");
+  for (uint8_t g = CMD_GROUP_MAIN; g <= CMD_GROUP_SETTINGS; g++) {
+    if (g == CMD_GROUP_SETTINGS) help.add("\n--- Settings from Telegram ---\n");
+    for (uint8_t i = 0; i < CMD_COUNT; i++) {
+      const CommandSpec& c = telegramCommands[i];
+      if (c.group != g || !c.help) continue;
+      help.add(c.icon).add(" /").add(c.name);
+      for (uint8_t j = i + 1; j < CMD_COUNT && !telegramCommands[j].help; j++) {
+        if (telegramCommands[j].handler == c.handler) help.add(", /").add(telegramCommands[j].name);
+      }
+      if (*c.usage) help.add(" ").add(c.usage);
+      help.add(" - ").add(c.help).add("\n");
+    }
+  }
+  addLocalIp(help.add("\nIP: "));
+  help.addf("\nUptime: %s", uptimeText().c_str());
+  sendTelegramMessage(help.c_str());
+}
+
+void handleTelegramCommand(const char* text) {
+  Serial.printf("Handling command: %s\n", text);
+
+  char buf[sizeof(TelegramCommand::text)];
+  while (*text == ' ') text++;
+  strncpy(buf, text, sizeof(buf) - 1);
+  buf[sizeof(buf) - 1] = 0;
+  size_t len = strlen(buf);
+  while (len && buf[len - 1] == ' ') buf[--len] = 0;
+  for (char* p = buf; *p; p++) *p = tolower((unsigned char)*p);
+  setTelegramDebugf("Command: %s", buf);
+  {
+    // First 4 characters after the slash, unpacked again by /log
+    int32_t packed = 0;
+    const char* name = buf + (buf[0] == '/' ? 1 : 0);
+    memcpy(&packed, name, strnlen(name, sizeof(packed)));
+    logEvent(EV_COMMAND, packed, (int32_t)len);
+  }
+
+  // "/name args..." -> name and args, split in place
+  char* name = buf[0] == '/' ? buf + 1 : buf;
+  char* args = name;
+  while (*args && *args != ' ') args++;
+  if (*args) *args++ = 0;
+
+  uint32_t c0 = ESP.getCycleCount();
+  uint8_t row = buf[0] == '/' ? findCommand(name) : CMD_NONE;
+  uint32_t cycles = ESP.getCycleCount() - c0;
+  commandStats.lastLookupCycles = cycles;
+  commandStats.totalLookupCycles += cycles;
+  if (cycles > commandStats.maxLookupCycles) commandStats.maxLookupCycles = cycles;
+
+  if (row == CMD_NONE) {
+    commandStats.unknown++;
+    FixedText& r = beginReply();
+    r.addf("❓ Unknown command: %s\nType /help", text);
+    sendTelegramMessage(r.c_str());
+    return;
+  }
+
+  const CommandSpec& c = telegramCommands[row];
+  CommandArgs a;
+  if (!parseCommandArgs(args, c.schema, a)) {
+    commandStats.badArgs++;
+    FixedText& r = beginReply();
+    r.addf("❌ usage: /%s%s%s", c.name, *c.usage ? " " : "", c.usage);
+    sendTelegramMessage(r.c_str());
+    return;
+  }
+  commandStats.dispatched++;
+  c.handler(a);
+}
+
+void fillCommandStats(JsonObject o) {
+  uint32_t lookups = commandStats.dispatched + commandStats.unknown + commandStats.badArgs;
+  o["commands"] = CMD_COUNT;
+  o["dispatched"] = commandStats.dispatched;
+  o["unknown"] = commandStats.unknown;
+  o["badArgs"] = commandStats.badArgs;
+  o["lastLookupCycles"] = commandStats.lastLookupCycles;
+  o["maxLookupCycles"] = commandStats.maxLookupCycles;
+  o["avgLookupCycles"] = lookups ? (uint32_t)(commandStats.totalLookupCycles / lookups) : 0;
+  o["repliesParked"] = replyStats.parked;
+  o["repliesDropped"] = replyStats.dropped;
+  o["maxParkedBytes"] = replyStats.maxParkedBytes;
+}
+
+void commandStatsLine(FixedText& out) {
+  uint32_t lookups = commandStats.dispatched + commandStats.unknown + commandStats.badArgs;
+  out.addf("commands: %lu run, %lu unknown, %lu bad args, lookup %lu cycles avg",
+           (unsigned long)commandStats.dispatched, (unsigned long)commandStats.unknown,
+           (unsigned long)commandStats.badArgs,
+           lookups ? (unsigned long)(commandStats.totalLookupCycles / lookups) : 0UL);
+}
+
+#endif
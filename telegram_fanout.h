@@ -0,0 +1,246 @@
+#ifndef TELEGRAM_FANOUT_H
+#define TELEGRAM_FANOUT_H
+
+// ------------ One upload, several chats ------------
+// Photos and albums are uploaded once, to TELEGRAM_CHANNEL. That response is
+// scanned as it streams in for the file_id of every photo, and each chat in
+// TELEGRAM_FANOUT_CHATS then gets a sendPhoto / sendMediaGroup naming those
+// file_ids: a few hundred bytes per chat instead of the JPEGs again. The
+// extra requests go one after another over the warm keep-alive link; a
+// socket per chat would pay a TLS handshake each, which costs more than the
+// round trips it saves. A chat is uploaded to in full only when no file_id
+// could be read. /debug -> fanout compares the bytes sent per alert with a
+// separate upload per chat.
+
+#ifndef TELEGRAM_FANOUT_CHATS
+#define TELEGRAM_FANOUT_CHATS ""     // comma separated, e.g. "-1001234567890,@archive" (config.h)
+#endif
+#define FANOUT_CHAT_MAX 48
+#define FANOUT_FILE_ID_MAX 128       // Bot API file_ids are ~80 characters
+#define FANOUT_MEDIA_MAX 2048        // sendMediaGroup "media" JSON by file_id
+
+struct FanoutStats {
+  uint32_t alerts = 0;          // uploads that were fanned out
+  uint32_t sent = 0;            // chats reached by file_id
+  uint32_t failed = 0;
+  uint32_t fallbackUploads = 0; // chats uploaded to in full (no file_id)
+  uint64_t bytes = 0;           // request bodies actually sent, upload included
+  uint64_t naiveBytes = 0;      // the same alerts uploaded to every chat
+  uint32_t lastBytes = 0;
+  uint32_t lastNaiveBytes = 0;
+  unsigned long lastMs = 0;     // fan-out after the upload, all chats
+};
+
+// Keeps the last file_id of every message in a sendPhoto / sendMediaGroup
+// result (photo sizes are listed smallest first, so that is the full-size
+// one) and the first bytes of the body for the "ok" check and error output.
+class FileIdSink : public TelegramBodySink {
+ public:
+  void reset() {
+    headLen = 0;
+    head[0] = 0;
+    messages = 0;
+    msgMatch = idMatch = 0;
+    capturing = false;
+    for (int i = 0; i < TELEGRAM_ALBUM_MAX; i++) ids[i][0] = 0;
+  }
+
+  void onBody(const uint8_t* p, size_t n) override {
+    for (size_t i = 0; i < n; i++) {
+      char c = (char)p[i];
+      if (headLen + 1 < sizeof(head)) {
+        head[headLen++] = c;
+        head[headLen] = 0;
+      }
+      if (capturing) {
+        capture(c);
+        continue;
+      }
+      if (match(c, "\"message_id\":", msgMatch)) messages++;
+      if (match(c, "\"file_id\":\"", idMatch)) {
+        capturing = true;
+        curLen = 0;
+      }
+    }
+  }
+
+  bool ok() const { return strncmp(head, "{\"ok\":true", 10) == 0; }
+
+  // Full-size file_id of message i, nullptr when there is none
+  const char* fileId(int i) const {
+    return (i >= 0 && i < TELEGRAM_ALBUM_MAX && i < messages && ids[i][0]) ? ids[i] : nullptr;
+  }
+
+  char head[TELEGRAM_RESP_KEEP];
+
+ private:
+  // `at` characters of `pattern` seen so far. Its only prefix that is also a
+  // suffix is the leading quote, so a mismatch restarts at 0 or 1.
+  static bool match(char c, const char* pattern, uint8_t& at) {
+    if (c == pattern[at]) at++;
+    else at = (c == '"') ? 1 : 0;
+    if (pattern[at]) return false;
+    at = 0;
+    return true;
+  }
+
+  // file_ids are URL-safe base64: no escapes before the closing quote
+  void capture(char c) {
+    if (c != '"') {
+      if (curLen + 1 < sizeof(cur)) cur[curLen] = c;
+      curLen++;
+      return;
+    }
+    capturing = false;
+    int slot = messages - 1;
+    if (slot < 0 || slot >= TELEGRAM_ALBUM_MAX || curLen >= sizeof(cur)) return;
+    memcpy(ids[slot], cur, curLen);
+    ids[slot][curLen] = 0;
+  }
+
+  size_t headLen = 0;
+  int messages = 0;
+  uint8_t msgMatch = 0;
+  uint8_t idMatch = 0;
+  bool capturing = false;
+  char cur[FANOUT_FILE_ID_MAX];
+  size_t curLen = 0;
+  char ids[TELEGRAM_ALBUM_MAX][FANOUT_FILE_ID_MAX];
+};
+
+static FileIdSink fanoutSink;
+static char fanoutMedia[FANOUT_MEDIA_MAX];
+static SemaphoreHandle_t fanoutMutex = nullptr;
+static FanoutStats fanoutStats;
+
+// Chat n of TELEGRAM_FANOUT_CHATS, spaces trimmed; empty and overlong
+// entries are skipped. False past the end.
+static bool fanoutChat(int n, char* out, size_t cap) {
+  const char* p = TELEGRAM_FANOUT_CHATS;
+  int i = 0;
+  while (*p) {
+    const char* end = strchr(p, ',');
+    if (!end) end = p + strlen(p);
+    const char* a = p;
+    const char* b = end;
+    while (a < b && *a == ' ') a++;
+    while (b > a && b[-1] == ' ') b--;
+    size_t len = b - a;
+    if (len && len < cap) {
+      if (i == n) {
+        memcpy(out, a, len);
+        out[len] = 0;
+        return true;
+      }
+      i++;
+    }
+    p = *end ? end + 1 : end;
+  }
+  return false;
+}
+
+int fanoutChatCount() {
+  char chat[FANOUT_CHAT_MAX];
+  int n = 0;
+  while (fanoutChat(n, chat, sizeof(chat))) n++;
+  return n;
+}
+
+// One upload and its fan-out: holds the shared sink and media buffer. With
+// no extra chats it is inert and the response is read into resp.body as
+// before.
+class FanoutSession {
+ public:
+  FanoutSession() : active(fanoutMutex && fanoutChatCount() > 0) {
+    if (!active) return;
+    xSemaphoreTake(fanoutMutex, portMAX_DELAY);
+    fanoutSink.reset();
+  }
+  ~FanoutSession() {
+    if (active) xSemaphoreGive(fanoutMutex);
+  }
+
+  bool enabled() const { return active; }
+  TelegramBodySink* sink() const { return active ? &fanoutSink : nullptr; }
+  bool ok(const TelegramResponse& r) const { return active ? fanoutSink.ok() : r.ok(); }
+  const char* body(const TelegramResponse& r) const { return active ? fanoutSink.head : r.body; }
+
+ private:
+  bool active;
+};
+
+// sendPhoto / sendMediaGroup to `chat` naming already uploaded photos in
+// `field`; `bytes` gets the request body size
+static bool fanoutSend(const char* chat, const char* method, const char* field, const char* value,
+                       const char* caption, size_t& bytes) {
+  char path[96];
+  char framing[512];
+  MultipartBuilder body(framing, sizeof(framing));
+  body.field("chat_id", chat);
+  if (caption) body.field("caption", caption);
+  body.fieldRef(field, (const uint8_t*)value, strlen(value));
+  if (!telegramPath(path, sizeof(path), method) || !body.finish()) return false;
+  bytes = body.contentLength();
+
+  TelegramResponse resp;
+  int httpCode = telegramLink.request("POST", path, body.contentType(), body.parts(), body.partCount(), resp);
+  if (resp.ok()) return true;
+  Serial.printf("Fan-out %s to %s failed (http %d)\n", method, chat, httpCode);
+  if (httpCode > 0) Serial.println(resp.body);
+  return false;
+}
+
+// sendMediaGroup "media" for photos 0..n-1 of the last upload, or nullptr
+static const char* fanoutAlbumMedia(int n, const char* caption) {
+  FixedText media(fanoutMedia, sizeof(fanoutMedia));
+  media.add("[");
+  for (int i = 0; i < n; i++) {
+    const char* id = fanoutSink.fileId(i);
+    if (!id) return nullptr;
+    if (i) media.add(",");
+    media.add("{\"type\":\"photo\",\"media\":\"").add(id).add("\"");
+    if (i == 0) media.add(",\"caption\":\"").addJson(caption).add("\"");
+    media.add("}");
+  }
+  media.add("]");
+  return media.ok() ? media.c_str() : nullptr;
+}
+
+// One fanned-out alert: `bytes` sent in total, `naiveBytes` for an upload per chat
+static void fanoutReport(size_t bytes, size_t naiveBytes, unsigned long startMs) {
+  fanoutStats.alerts++;
+  fanoutStats.bytes += bytes;
+  fanoutStats.naiveBytes += naiveBytes;
+  fanoutStats.lastBytes = bytes;
+  fanoutStats.lastNaiveBytes = naiveBytes;
+  fanoutStats.lastMs = millis() - startMs;
+  logEvent(EV_FANOUT, fanoutChatCount(), (int32_t)(naiveBytes - bytes));
+}
+
+void startTelegramFanout() {
+  fanoutMutex = xSemaphoreCreateMutex();
+  int n = fanoutChatCount();
+  if (n) Serial.printf("Photos fan out to %d more chat(s) by file_id\n", n);
+}
+
+void fillFanoutStats(JsonObject o) {
+  o["chats"] = 1 + fanoutChatCount();
+  o["alerts"] = fanoutStats.alerts;
+  o["sent"] = fanoutStats.sent;
+  o["failed"] = fanoutStats.failed;
+  o["fallbackUploads"] = fanoutStats.fallbackUploads;
+  o["bytes"] = fanoutStats.bytes;
+  o["naiveBytes"] = fanoutStats.naiveBytes;
+  o["savedPct"] = fanoutStats.naiveBytes ? 100.0f - fanoutStats.bytes * 100.0f / fanoutStats.naiveBytes : 0.0f;
+  o["lastBytes"] = fanoutStats.lastBytes;
+  o["lastNaiveBytes"] = fanoutStats.lastNaiveBytes;
+  o["lastMs"] = fanoutStats.lastMs;
+}
+
+void fanoutStatsLine(FixedText& out) {
+  out.addf("fanout: %d chat(s), %lu alerts, %lu KB sent vs %lu KB per-chat upload", 1 + fanoutChatCount(),
+           (unsigned long)fanoutStats.alerts, (unsigned long)(fanoutStats.bytes / 1024),
+           (unsigned long)(fanoutStats.naiveBytes / 1024));
+}
+
+#endif
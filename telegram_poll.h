@@ -0,0 +1,236 @@
+#ifndef TELEGRAM_POLL_H
+#define TELEGRAM_POLL_H
+
+// ------------ Telegram long-polling ------------
+// A background task holds a getUpdates long poll open on its own connection
+// (so it never blocks uploads or replies on telegramLink), fetches up to
+// TELEGRAM_POLL_BATCH updates per request, commits the offset once per batch
+// and hands text commands to loop() in order through a FreeRTOS queue.
+// Responses are parsed while they stream in (telegram_update_parser.h), so
+// photos, long texts or entities can no longer overflow a JSON document.
+
+#ifndef TELEGRAM_LONG_POLL_S
+#define TELEGRAM_LONG_POLL_S 25        // 0 = short polls every TELEGRAM_POLL_INTERVAL
+#endif
+#ifndef TELEGRAM_POLL_BATCH
+#define TELEGRAM_POLL_BATCH 20
+#endif
+#define TELEGRAM_CMD_QUEUE 16
+#define TELEGRAM_POLL_STACK 8192
+
+struct TelegramCommand {
+  long updateId;
+  unsigned long receivedMs;
+  char text[64];
+  char sender[32];
+};
+
+struct TelegramPollStats {
+  uint32_t requests = 0;
+  uint32_t updates = 0;
+  uint32_t errors = 0;
+  uint16_t lastBatch = 0;
+  uint16_t maxBatch = 0;
+  uint32_t commands = 0;          // dispatched by loop()
+  unsigned long lastLatencyMs = 0; // fetched -> handler done, its reply sent or parked
+  unsigned long maxLatencyMs = 0;
+  unsigned long totalLatencyMs = 0;
+  size_t lastBodyBytes = 0;
+  size_t maxBodyBytes = 0;
+  unsigned long lastParseUs = 0;
+};
+
+TelegramLink telegramPollLink("poll");
+static QueueHandle_t telegramCmdQueue = nullptr;
+static TelegramPollStats pollStats;
+
+static void copyField(char* dst, size_t cap, const char* src) {
+  strncpy(dst, src ? src : "", cap - 1);
+  dst[cap - 1] = 0;
+}
+
+// Feeds the socket straight into the streaming parser and keeps the batch's
+// text commands (at most TELEGRAM_POLL_BATCH, fixed size) until it completes.
+class PollBodySink : public TelegramBodySink {
+ public:
+  TelegramUpdateParser parser;
+  TelegramCommand cmds[TELEGRAM_POLL_BATCH];
+  int ncmds = 0;
+  long maxId = 0;
+  size_t bytes = 0;
+  unsigned long parseUs = 0;
+
+  void reset() {
+    parser.begin(&PollBodySink::onUpdate, this);
+    ncmds = 0;
+    maxId = 0;
+    bytes = 0;
+    parseUs = 0;
+  }
+
+  void onBody(const uint8_t* p, size_t n) override {
+    unsigned long t0 = micros();
+    parser.feed(p, n);
+    parseUs += micros() - t0;
+    bytes += n;
+  }
+
+ private:
+  static void onUpdate(const TelegramUpdate& u, void* ctx) {
+    PollBodySink* self = (PollBodySink*)ctx;
+    if ((long)u.updateId > self->maxId) self->maxId = (long)u.updateId;
+    // Plain text is queued too: the dispatcher answers it "Unknown command"
+    if (!u.hasText || self->ncmds >= TELEGRAM_POLL_BATCH) return;
+
+    TelegramCommand& c = self->cmds[self->ncmds];
+    copyField(c.text, sizeof(c.text), u.text);
+    if (parseTelegramCommand(c.text) == 0) return;
+
+    self->ncmds++;
+    c.updateId = (long)u.updateId;
+    c.receivedMs = millis();
+    copyField(c.sender, sizeof(c.sender),
+              u.username[0] ? u.username : u.firstName[0] ? u.firstName : "Unknown");
+  }
+};
+
+static PollBodySink pollSink;   // only touched by the poll task
+
+static void telegramPollTask(void*) {
+  long offset = getLastUpdateID();
+
+  for (;;) {
+    if (WiFi.status() != WL_CONNECTED) {
+      vTaskDelay(pdMS_TO_TICKS(1000));
+      continue;
+    }
+
+    char path[160];
+    snprintf(path, sizeof(path), "/bot%s/getUpdates?offset=%ld&limit=%d&timeout=%d",
+             TELEGRAM_BOT_TOKEN, offset + 1, TELEGRAM_POLL_BATCH, TELEGRAM_LONG_POLL_S);
+
+    pollSink.reset();
+    TelegramResponse resp;
+    resp.sink = &pollSink;
+    unsigned long t0 = micros();
+    int httpCode = telegramPollLink.request("GET", path, nullptr, nullptr, 0, resp,
+                                            (TELEGRAM_LONG_POLL_S + 10) * 1000UL);
+    metricObserve(MET_GET_UPDATES, micros() - t0);
+    pollStats.requests++;
+    pollStats.lastBodyBytes = pollSink.bytes;
+    if (pollSink.bytes > pollStats.maxBodyBytes) pollStats.maxBodyBytes = pollSink.bytes;
+    pollStats.lastParseUs = pollSink.parseUs;
+
+    if (httpCode != 200) {
+      pollStats.errors++;
+      logEvent(EV_POLL_ERROR, httpCode);
+      if (httpCode > 0) {
+        Serial.printf("Telegram API error: %d\n", httpCode);
+        setTelegramDebugf("Telegram API error: %d", httpCode);
+      } else {
+        Serial.println("Telegram connection failed");
+        setTelegramDebug("Telegram connection failed");
+      }
+      vTaskDelay(pdMS_TO_TICKS(TELEGRAM_POLL_INTERVAL));
+      continue;
+    }
+
+    if (!pollSink.parser.ok()) {
+      pollStats.errors++;
+      vTaskDelay(pdMS_TO_TICKS(TELEGRAM_POLL_INTERVAL));
+      continue;
+    }
+
+    uint16_t n = (uint16_t)pollSink.parser.updates();
+    pollStats.updates += n;
+    pollStats.lastBatch = n;
+    if (n > pollStats.maxBatch) pollStats.maxBatch = n;
+
+    // ✅ CRITICAL FIX (kept): the offset is committed for the whole batch
+    // BEFORE any of its commands (reboot/capture etc.) can run. Batches with
+    // no command in them (joins, edits, ...) are write-behind. If the write
+    // fails the batch is not run; the same offset fetches it again.
+    if (pollSink.maxId > offset) {
+      if (!saveLastUpdateID(pollSink.maxId, pollSink.ncmds > 0)) {
+        pollStats.errors++;
+        setTelegramDebug("Offset not saved, batch held back");
+        vTaskDelay(pdMS_TO_TICKS(TELEGRAM_POLL_INTERVAL));
+        continue;
+      }
+      offset = pollSink.maxId;
+    }
+
+    // Blocks if loop() is behind; order is preserved
+    for (int i = 0; i < pollSink.ncmds; i++) {
+      xQueueSend(telegramCmdQueue, &pollSink.cmds[i], portMAX_DELAY);
+    }
+
+    if (TELEGRAM_LONG_POLL_S == 0) vTaskDelay(pdMS_TO_TICKS(TELEGRAM_POLL_INTERVAL));
+  }
+}
+
+void startTelegramPolling() {
+  telegramPollLink.begin();
+  telegramCmdQueue = xQueueCreate(TELEGRAM_CMD_QUEUE, sizeof(TelegramCommand));
+  xTaskCreatePinnedToCore(telegramPollTask, "tgpoll", TELEGRAM_POLL_STACK, nullptr, 1, nullptr, 0);
+}
+
+// Called from loop(): dispatch queued commands in arrival order
+void checkTelegramCommands() {
+  if (!telegramCmdQueue) return;
+
+  TelegramCommand c;
+  // A few per pass so a backlog doesn't starve the web server / motion checks
+  for (int i = 0; i < 4 && xQueueReceive(telegramCmdQueue, &c, 0) == pdTRUE; i++) {
+    Serial.printf("Telegram command from %s: %s\n", c.sender, c.text);
+    setTelegramDebugf("CMD from %s: %s", c.sender, c.text);
+
+    {
+      MetricTimer t(MET_COMMAND);
+      handleTelegramCommand(c.text);
+    }
+
+    unsigned long dt = millis() - c.receivedMs;
+    pollStats.commands++;
+    pollStats.lastLatencyMs = dt;
+    pollStats.totalLatencyMs += dt;
+    if (dt > pollStats.maxLatencyMs) pollStats.maxLatencyMs = dt;
+  }
+}
+
+// loop() idle: returns after `ms` or as soon as a command is queued
+void waitTelegramCommand(unsigned long ms) {
+  TelegramCommand c;
+  if (!telegramCmdQueue) {
+    delay(ms);
+    return;
+  }
+  xQueuePeek(telegramCmdQueue, &c, pdMS_TO_TICKS(ms));
+}
+
+void fillTelegramPollStats(JsonObject o) {
+  o["longPollS"] = TELEGRAM_LONG_POLL_S;
+  o["requests"] = pollStats.requests;
+  o["updates"] = pollStats.updates;
+  o["errors"] = pollStats.errors;
+  o["updatesPerRequest"] = pollStats.requests ? (float)pollStats.updates / pollStats.requests : 0.0f;
+  o["lastBatch"] = pollStats.lastBatch;
+  o["maxBatch"] = pollStats.maxBatch;
+  o["commands"] = pollStats.commands;
+  o["lastCmdLatencyMs"] = pollStats.lastLatencyMs;
+  o["maxCmdLatencyMs"] = pollStats.maxLatencyMs;
+  o["avgCmdLatencyMs"] = pollStats.commands ? pollStats.totalLatencyMs / pollStats.commands : 0;
+  o["lastBodyBytes"] = (unsigned)pollStats.lastBodyBytes;
+  o["maxBodyBytes"] = (unsigned)pollStats.maxBodyBytes;
+  o["lastParseUs"] = pollStats.lastParseUs;
+  telegramPollLink.fillStats(o.createNestedObject("link"));
+}
+
+void telegramPollStatsLine(FixedText& out) {
+  out.addf("poll: %lu upd / %lu req, cmd latency %lu ms avg, %lu ms max", (unsigned long)pollStats.updates,
+           (unsigned long)pollStats.requests,
+           pollStats.commands ? (unsigned long)(pollStats.totalLatencyMs / pollStats.commands) : 0UL,
+           (unsigned long)pollStats.maxLatencyMs);
+}
+
+#endif
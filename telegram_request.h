@@ -0,0 +1,109 @@
+#ifndef TELEGRAM_REQUEST_H
+#define TELEGRAM_REQUEST_H
+
+// ------------ Fixed-buffer request building ------------
+// Request lines, headers and multipart framing are written into caller
+// memory (a FixedText over a stack array sized for the call) instead of being
+// concatenated into Strings. Large values - the JPEG, a long message text -
+// are referenced as body parts, never copied, and Content-Length is the sum
+// of the part lengths. Nothing here touches the heap.
+
+#define TG_MULTIPART_MAX_PARTS 24
+#define TELEGRAM_ALBUM_MAX 10        // sendMediaGroup limit
+
+// One slice of a request body; TelegramLink writes them back to back
+struct TelegramBodyPart {
+  const uint8_t* data;
+  size_t len;
+};
+
+// "/bot<token>/<method>"
+static bool telegramPath(char* out, size_t cap, const char* method) {
+  int n = snprintf(out, cap, "/bot%s/%s", TELEGRAM_BOT_TOKEN, method);
+  return n > 0 && (size_t)n < cap;
+}
+
+// multipart/form-data body as a list of parts: framing and short fields live
+// in `mem`, payloads (files, long text) are referenced where they are.
+class MultipartBuilder {
+ public:
+  MultipartBuilder(char* mem, size_t cap) : text(mem, cap) {
+    snprintf(boundary, sizeof(boundary), "----ESP32CAM%08lx", (unsigned long)millis());
+    snprintf(type, sizeof(type), "multipart/form-data; boundary=%s", boundary);
+  }
+
+  // Short value, copied into the framing buffer
+  void field(const char* name, const char* value) {
+    open(name, nullptr, nullptr);
+    text.add(value);
+  }
+
+  // Value sent from where it is (message text, JSON array, ...)
+  void fieldRef(const char* name, const uint8_t* data, size_t n) {
+    open(name, nullptr, nullptr);
+    ref(data, n);
+  }
+
+  void file(const char* name, const char* filename, const char* mime, const uint8_t* data, size_t n) {
+    open(name, filename, mime);
+    ref(data, n);
+  }
+
+  // Closes the body; returns false if the framing buffer or part list overflowed
+  bool finish() {
+    text.add("\r\n--").add(boundary).add("--\r\n");
+    flushText();
+    return text.ok() && !tooMany;
+  }
+
+  const char* contentType() const { return type; }
+  const TelegramBodyPart* parts() const { return list; }
+  int partCount() const { return count; }
+
+  size_t contentLength() const {
+    size_t n = 0;
+    for (int i = 0; i < count; i++) n += list[i].len;
+    return n;
+  }
+
+ private:
+  FixedText text;
+  char boundary[24];
+  char type[64];
+  TelegramBodyPart list[TG_MULTIPART_MAX_PARTS];
+  int count = 0;
+  size_t segStart = 0;        // start of the framing text not yet in `list`
+  bool first = true;
+  bool tooMany = false;
+
+  void open(const char* name, const char* filename, const char* mime) {
+    if (!first) text.add("\r\n");
+    first = false;
+    text.add("--").add(boundary).add("\r\nContent-Disposition: form-data; name=\"").add(name).add("\"");
+    if (filename) text.add("; filename=\"").add(filename).add("\"");
+    text.add("\r\n");
+    if (mime) text.add("Content-Type: ").add(mime).add("\r\n");
+    text.add("\r\n");
+  }
+
+  void push(const uint8_t* p, size_t n) {
+    if (count == TG_MULTIPART_MAX_PARTS) { tooMany = true; return; }
+    list[count].data = p;
+    list[count].len = n;
+    count++;
+  }
+
+  void flushText() {
+    if (text.length() > segStart) {
+      push((const uint8_t*)text.c_str() + segStart, text.length() - segStart);
+      segStart = text.length();
+    }
+  }
+
+  void ref(const uint8_t* p, size_t n) {
+    flushText();
+    push(p, n);
+  }
+};
+
+#endif
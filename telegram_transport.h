@@ -0,0 +1,415 @@
+#ifndef TELEGRAM_TRANSPORT_H
+#define TELEGRAM_TRANSPORT_H
+
+// ------------ Shared keep-alive HTTPS link to api.telegram.org ------------
+// One WiFiClientSecure is kept open and every Bot API call (sendMessage,
+// sendPhoto, getUpdates) is sent over it as an HTTP/1.1 keep-alive request,
+// so the TLS handshake is paid only when the server drops the connection.
+// Callers from different tasks are serialised by the link's mutex.
+//
+// WiFiClientSecure has no TLS session-ticket API, so a reconnect is a full
+// handshake; the stats below show how rarely that now happens.
+
+// Overridable (config.h) to point a bench device at a local mock Bot API
+// server; the link always speaks TLS, so the mock needs a (self-signed) cert.
+#ifndef TELEGRAM_HOST
+#define TELEGRAM_HOST "api.telegram.org"
+#endif
+#ifndef TELEGRAM_PORT
+#define TELEGRAM_PORT 443
+#endif
+
+#ifndef TELEGRAM_IO_TIMEOUT_MS
+#define TELEGRAM_IO_TIMEOUT_MS 15000UL
+#endif
+#define TELEGRAM_RESP_KEEP 384     // leading body bytes kept ("ok", error description)
+#define TELEGRAM_LINE_MAX 128      // longer header lines are truncated
+#define TELEGRAM_RX_BUF 512        // bulk receive buffer per link
+#define TELEGRAM_SKIP_TIMEOUT_MS 2000UL   // for the unread tail of an early-returned body
+#define TELEGRAM_LINK_BUSY -2      // request(): another request kept the link past lockWait
+
+// Receives the response body as it arrives instead of buffering it
+class TelegramBodySink {
+ public:
+  virtual ~TelegramBodySink() {}
+  virtual void onBody(const uint8_t* p, size_t n) = 0;
+};
+
+// Fixed size: keeps the start of the body, which is where the Bot API puts
+// "ok" and any error description; the rest is counted and dropped.
+struct TelegramResponse {
+  int status = 0;       // HTTP status code, <= 0 on transport failure
+  char body[TELEGRAM_RESP_KEEP];   // empty when `sink` is set
+  size_t bodyLen = 0;
+  size_t bodyTotal = 0;
+  TelegramBodySink* sink = nullptr;
+  bool stopAtResult = true;   // return once "ok":true is seen (no sink only)
+
+  TelegramResponse() { body[0] = 0; }
+  bool ok() const { return status == 200 && strstr(body, "\"ok\":true") != nullptr; }
+};
+
+struct TelegramLinkStats {
+  uint32_t requests = 0;
+  uint32_t reused = 0;          // requests sent on an already-open connection
+  uint32_t handshakes = 0;
+  uint32_t connectFailures = 0;
+  uint32_t retries = 0;         // stale keep-alive socket, unanswered request re-sent once
+  unsigned long lastConnectMs = 0;
+  unsigned long maxConnectMs = 0;
+  unsigned long totalConnectMs = 0;
+  uint32_t results = 0;
+  uint32_t earlyReturns = 0;    // returned before the end of the body
+  uint32_t skippedBytes = 0;    // body tails skipped before the next request
+  unsigned long lastStatusMs = 0;   // request written -> status line
+  unsigned long lastResultMs = 0;   // request written -> result known
+  unsigned long totalResultMs = 0;
+};
+
+class TelegramLink {
+ public:
+  explicit TelegramLink(const char* name) : linkName(name) {}
+
+  void begin() {
+    mutex = xSemaphoreCreateMutex();
+    client.setInsecure();
+  }
+
+  // Sends one request; body parts are concatenated (Content-Length is their sum).
+  // Returns the HTTP status (<= 0 on failure); the body (or, for a success
+  // without a sink, just its start) is stored in `resp`. TELEGRAM_LINK_BUSY
+  // when another request held the link for longer than `lockWait` ticks.
+  int request(const char* method, const char* path, const char* contentType,
+              const TelegramBodyPart* parts, int nparts, TelegramResponse& resp,
+              unsigned long timeoutMs = TELEGRAM_IO_TIMEOUT_MS, TickType_t lockWait = portMAX_DELAY) {
+    if (!mutex) return -1;
+    if (xSemaphoreTake(mutex, lockWait) != pdTRUE) {
+      resp.status = TELEGRAM_LINK_BUSY;
+      return TELEGRAM_LINK_BUSY;
+    }
+    inUse = true;
+
+    int status = -1;
+    for (int attempt = 0; attempt < 2; attempt++) {
+      finishPrevious();
+      bool reusing = client.connected();
+      if (!reusing && !connect()) break;
+
+      stats.requests++;
+      if (reusing) stats.reused++;
+
+      resp.body[0] = 0;
+      resp.bodyLen = resp.bodyTotal = 0;
+      rxBytes = 0;
+      rxTimedOut = false;
+      bool sent = writeRequest(method, path, contentType, parts, nparts);
+      status = sent ? readResponse(resp, timeoutMs) : -1;
+      if (status > 0) break;
+
+      closeLink();
+      // A kept-alive socket may have been closed by the server while idle:
+      // retry exactly once on a fresh connection. Only when the request did
+      // not go out, or the socket dropped before a single response byte came
+      // back; otherwise the server may have it, and a second sendPhoto or
+      // sendMessage would post it twice.
+      bool unanswered = !sent || (rxBytes == 0 && !rxTimedOut);
+      if (!reusing || !unanswered) break;
+      stats.retries++;
+    }
+
+    resp.status = status;
+    inUse = false;
+    xSemaphoreGive(mutex);
+    return status;
+  }
+
+  // True while a request (typically a photo upload) holds the connection
+  bool busy() const { return inUse; }
+
+  const TelegramLinkStats& linkStats() const { return stats; }
+
+  void fillStats(JsonObject o) {
+    o["requests"] = stats.requests;
+    o["reused"] = stats.reused;
+    o["handshakes"] = stats.handshakes;
+    o["connectFailures"] = stats.connectFailures;
+    o["retries"] = stats.retries;
+    o["reuseRatio"] = stats.requests ? (float)stats.reused / stats.requests : 0.0f;
+    o["lastConnectMs"] = stats.lastConnectMs;
+    o["maxConnectMs"] = stats.maxConnectMs;
+    o["avgConnectMs"] = stats.handshakes ? stats.totalConnectMs / stats.handshakes : 0;
+    o["lastStatusMs"] = stats.lastStatusMs;
+    o["lastResultMs"] = stats.lastResultMs;
+    o["avgResultMs"] = stats.results ? stats.totalResultMs / stats.results : 0;
+    o["earlyReturns"] = stats.earlyReturns;
+    o["skippedBytes"] = stats.skippedBytes;
+  }
+
+  void statsLine(FixedText& out) {
+    unsigned pct = stats.requests ? (unsigned)(stats.reused * 100UL / stats.requests) : 0;
+    out.addf("%s: %lu req, %lu TLS, reuse %u%%, connect %lu ms avg, reply %lu ms avg", linkName,
+             (unsigned long)stats.requests, (unsigned long)stats.handshakes, pct,
+             stats.handshakes ? stats.totalConnectMs / stats.handshakes : 0UL,
+             stats.results ? stats.totalResultMs / stats.results : 0UL);
+  }
+
+ private:
+  const char* linkName;
+  WiFiClientSecure client;
+  SemaphoreHandle_t mutex = nullptr;
+  TelegramLinkStats stats;
+  volatile bool inUse = false;
+  bool keepAlive = false;
+
+  bool connect() {
+    if (WiFi.status() != WL_CONNECTED) return false;
+    unsigned long t0 = millis();
+    unsigned long t0us = micros();
+    client.setTimeout(TELEGRAM_IO_TIMEOUT_MS);
+    if (!client.connect(TELEGRAM_HOST, TELEGRAM_PORT)) {
+      stats.connectFailures++;
+      logEvent(EV_TLS_FAIL);
+      return false;
+    }
+    metricObserve(MET_TLS_CONNECT, micros() - t0us);
+    unsigned long dt = millis() - t0;
+    rxPos = rxLen = 0;
+    bodyMode = BODY_DONE;
+    stats.handshakes++;
+    stats.lastConnectMs = dt;
+    stats.totalConnectMs += dt;
+    if (dt > stats.maxConnectMs) stats.maxConnectMs = dt;
+    Serial.printf("[%s] TLS connected in %lu ms\n", linkName, dt);
+    logEvent(EV_TLS_CONNECT, (int32_t)dt);
+    return true;
+  }
+
+  bool writeAll(const uint8_t* p, size_t left) {
+    const size_t CHUNK = 1024;
+    while (left > 0) {
+      size_t n = (left > CHUNK) ? CHUNK : left;
+      size_t w = client.write(p, n);
+      if (w == 0) return false;
+      p += w;
+      left -= w;
+      delay(0);
+    }
+    return true;
+  }
+
+  bool writeRequest(const char* method, const char* path, const char* contentType,
+                    const TelegramBodyPart* parts, int nparts) {
+    size_t contentLength = 0;
+    for (int i = 0; i < nparts; i++) contentLength += parts[i].len;
+
+    char mem[384];
+    FixedText head(mem, sizeof(mem));
+    head.add(method).add(" ").add(path).add(" HTTP/1.1\r\n"
+             "Host: " TELEGRAM_HOST "\r\n"
+             "User-Agent: ESP32CAM\r\n"
+             "Connection: keep-alive\r\n");
+    if (contentType) {
+      head.add("Content-Type: ").add(contentType).add("\r\n");
+      head.add("Content-Length: ").addNum(contentLength).add("\r\n");
+    }
+    head.add("\r\n");
+    if (!head.ok()) return false;
+
+    if (!writeAll((const uint8_t*)head.c_str(), head.length())) return false;
+    for (int i = 0; i < nparts; i++) {
+      if (!writeAll(parts[i].data, parts[i].len)) return false;
+    }
+    return true;
+  }
+
+  // Receive side: bytes are pulled from the socket in bulk into `rx` and the
+  // response is parsed from there. The body framing state lives in the link,
+  // so a request can return as soon as its result is known and the rest of
+  // the body is skipped before the next request goes out on the socket.
+  enum BodyMode : uint8_t { BODY_DONE, BODY_LENGTH, BODY_CHUNKED, BODY_UNTIL_CLOSE };
+
+  uint8_t rx[TELEGRAM_RX_BUF];
+  size_t rxPos = 0;
+  size_t rxLen = 0;
+  BodyMode bodyMode = BODY_DONE;
+  size_t bodyLeft = 0;           // of the Content-Length body or the current chunk
+  bool chunkOpen = false;        // a chunk's data was read, its CRLF was not
+  size_t rxBytes = 0;            // received since the current request went out
+  bool rxTimedOut = false;       // the last fill() gave up waiting, the socket was still up
+
+  void closeLink() {
+    client.stop();
+    rxPos = rxLen = 0;
+    bodyMode = BODY_DONE;
+  }
+
+  // Makes at least one byte available in `rx`
+  bool fill(unsigned long start, unsigned long timeoutMs) {
+    if (rxPos < rxLen) return true;
+    while (!client.available()) {
+      if (!client.connected()) return false;
+      if (millis() - start >= timeoutMs) {
+        rxTimedOut = true;
+        return false;
+      }
+      delay(1);
+    }
+    int r = client.read(rx, sizeof(rx));
+    if (r <= 0) return false;
+    rxPos = 0;
+    rxLen = (size_t)r;
+    rxBytes += rxLen;
+    return true;
+  }
+
+  // Reads one line into `line` (CR/LF stripped); -1 if the socket ran dry first
+  int readLine(char* line, size_t cap, unsigned long start, unsigned long timeoutMs) {
+    size_t n = 0;
+    for (;;) {
+      if (!fill(start, timeoutMs)) {
+        line[n] = 0;
+        return -1;
+      }
+      const uint8_t* p = rx + rxPos;
+      const uint8_t* nl = (const uint8_t*)memchr(p, '\n', rxLen - rxPos);
+      size_t k = nl ? (size_t)(nl - p) : rxLen - rxPos;
+      for (size_t i = 0; i < k; i++) {
+        if (p[i] != '\r' && n + 1 < cap) line[n++] = (char)p[i];
+      }
+      rxPos += k;
+      if (nl) {
+        rxPos++;
+        line[n] = 0;
+        return (int)n;
+      }
+    }
+  }
+
+  static void deliver(TelegramResponse& resp, const uint8_t* p, size_t n) {
+    resp.bodyTotal += n;
+    if (resp.sink) {
+      resp.sink->onBody(p, n);
+      return;
+    }
+    size_t room = sizeof(resp.body) - 1 - resp.bodyLen;
+    if (n > room) n = room;
+    memcpy(resp.body + resp.bodyLen, p, n);
+    resp.bodyLen += n;
+    resp.body[resp.bodyLen] = 0;
+  }
+
+  // The Bot API puts "ok" first. A success needs nothing further; an error
+  // is read to the end so its description is kept.
+  static bool resultKnown(const TelegramResponse& resp) {
+    return resp.stopAtResult && !resp.sink && resp.status == 200 &&
+           resp.bodyLen >= 10 && strncmp(resp.body, "{\"ok\":true", 10) == 0;
+  }
+
+  // Feeds body bytes to `resp` until the body ends (true, bodyMode DONE),
+  // the result is known (true, bodyMode still set) or I/O fails (false).
+  bool readBody(TelegramResponse* resp, unsigned long start, unsigned long timeoutMs) {
+    char line[TELEGRAM_LINE_MAX];
+    while (bodyMode != BODY_DONE) {
+      if (resp && resultKnown(*resp)) return true;
+
+      if (bodyMode == BODY_CHUNKED && bodyLeft == 0) {
+        if (chunkOpen && readLine(line, sizeof(line), start, timeoutMs) != 0) return false;
+        chunkOpen = false;
+        if (readLine(line, sizeof(line), start, timeoutMs) <= 0) return false;
+        bodyLeft = strtoul(line, nullptr, 16);
+        if (bodyLeft == 0) {
+          // Trailers, then the empty line that ends the message
+          int n;
+          while ((n = readLine(line, sizeof(line), start, timeoutMs)) > 0) {}
+          if (n < 0) return false;
+          bodyMode = BODY_DONE;
+          break;
+        }
+        chunkOpen = true;
+      }
+
+      if (!fill(start, timeoutMs)) {
+        if (bodyMode != BODY_UNTIL_CLOSE) return false;
+        bodyMode = BODY_DONE;      // server closed: that was the whole body
+        break;
+      }
+      size_t k = rxLen - rxPos;
+      if (bodyMode != BODY_UNTIL_CLOSE && k > bodyLeft) k = bodyLeft;
+      if (resp) deliver(*resp, rx + rxPos, k);
+      else stats.skippedBytes += k;
+      rxPos += k;
+      if (bodyMode != BODY_UNTIL_CLOSE) {
+        bodyLeft -= k;
+        if (bodyMode == BODY_LENGTH && bodyLeft == 0) bodyMode = BODY_DONE;
+      }
+    }
+    return true;
+  }
+
+  // Skips what is left of an early-returned response so the socket can carry
+  // the next request; closes it when that is not possible.
+  void finishPrevious() {
+    if (bodyMode == BODY_DONE) return;
+    if (bodyMode == BODY_UNTIL_CLOSE || !readBody(nullptr, millis(), TELEGRAM_SKIP_TIMEOUT_MS) || !keepAlive) {
+      closeLink();
+    }
+  }
+
+  // Reads status line and headers, then the body up to its end or up to the
+  // point where the result is known. Returns the HTTP status, -1 on failure.
+  int readResponse(TelegramResponse& resp, unsigned long timeoutMs) {
+    unsigned long start = millis();
+    char line[TELEGRAM_LINE_MAX];
+    if (readLine(line, sizeof(line), start, timeoutMs) < 12 || strncmp(line, "HTTP/1.", 7) != 0) return -1;
+    resp.status = atoi(line + 9);
+    stats.lastStatusMs = millis() - start;
+
+    long contentLength = -1;
+    bool chunked = false;
+    keepAlive = line[7] == '1';
+    int n;
+    while ((n = readLine(line, sizeof(line), start, timeoutMs)) > 0) {
+      for (char* c = line; *c; c++) *c = tolower(*c);
+      if (!strncmp(line, "content-length:", 15)) contentLength = atol(line + 15);
+      else if (!strncmp(line, "transfer-encoding:", 18) && strstr(line, "chunked")) chunked = true;
+      else if (!strncmp(line, "connection:", 11)) keepAlive = strstr(line, "close") == nullptr;
+    }
+    if (n < 0) return -1;
+
+    if (chunked) {
+      bodyMode = BODY_CHUNKED;
+      bodyLeft = 0;
+      chunkOpen = false;
+    } else if (contentLength >= 0) {
+      bodyMode = contentLength > 0 ? BODY_LENGTH : BODY_DONE;
+      bodyLeft = (size_t)contentLength;
+    } else {
+      bodyMode = BODY_UNTIL_CLOSE;
+      keepAlive = false;
+    }
+
+    if (!readBody(&resp, start, timeoutMs)) {
+      closeLink();
+      return resp.status;
+    }
+    unsigned long dt = millis() - start;
+    stats.lastResultMs = dt;
+    stats.totalResultMs += dt;
+    stats.results++;
+    if (bodyMode != BODY_DONE) {
+      stats.earlyReturns++;
+      if (bodyMode == BODY_UNTIL_CLOSE) closeLink();   // nothing to reuse anyway
+    } else if (!keepAlive) {
+      closeLink();
+    }
+    return resp.status;
+  }
+};
+
+TelegramLink telegramLink("tg");
+
+void startTelegramTransport() {
+  telegramLink.begin();
+}
+
+#endif
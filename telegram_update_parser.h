@@ -0,0 +1,327 @@
+#ifndef TELEGRAM_UPDATE_PARSER_H
+#define TELEGRAM_UPDATE_PARSER_H
+
+// Streaming getUpdates parser.
+//
+// Consumes the JSON body in arbitrary chunks straight from the socket and
+// reports each element of "result" as soon as its object closes. Only
+// update_id, message.text and message.from.username/first_name are kept
+// (truncated to fixed buffers); everything else - photos, entities, long
+// captions - is skipped byte by byte, so memory use is constant no matter how
+// large the response is. Plain C++ (no Arduino headers) so it builds on a host.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define TG_TEXT_CAP 64
+#define TG_NAME_CAP 32
+#define TG_PARSER_MAX_DEPTH 24
+
+struct TelegramUpdate {
+  int64_t updateId;
+  bool hasText;
+  bool textTruncated;
+  char text[TG_TEXT_CAP];
+  char username[TG_NAME_CAP];
+  char firstName[TG_NAME_CAP];
+};
+
+class TelegramUpdateParser {
+ public:
+  typedef void (*Callback)(const TelegramUpdate& u, void* ctx);
+
+  void begin(Callback cb, void* ctx) {
+    onUpdate = cb;
+    cbCtx = ctx;
+    state = S_VALUE;
+    depth = 0;
+    okTrue = false;
+    error = false;
+    done = false;
+    count = 0;
+    target = T_NONE;
+  }
+
+  void feed(const uint8_t* p, size_t n) {
+    for (size_t i = 0; i < n && !error; i++) step((char)p[i]);
+  }
+
+  bool ok() const { return okTrue && done && !error; }   // "ok":true and a complete document
+  bool failed() const { return error; }
+  uint32_t updates() const { return count; }
+
+ private:
+  enum State : uint8_t {
+    S_VALUE, S_KEY_OR_END, S_KEY, S_KEY_ESC, S_COLON, S_AFTER_VALUE,
+    S_STRING, S_STRING_ESC, S_STRING_U, S_NUMBER, S_LITERAL, S_DONE
+  };
+  enum Ctx : uint8_t { C_OTHER, C_ROOT, C_RESULT, C_UPDATE, C_MESSAGE, C_FROM };
+  enum Key : uint8_t { K_OTHER, K_OK, K_RESULT, K_UPDATE_ID, K_MESSAGE, K_TEXT, K_FROM, K_USERNAME, K_FIRST_NAME };
+  enum Target : uint8_t { T_NONE, T_OK, T_UPDATE_ID, T_TEXT, T_USERNAME, T_FIRST_NAME };
+
+  Callback onUpdate = nullptr;
+  void* cbCtx = nullptr;
+
+  State state = S_VALUE;
+  bool isArray[TG_PARSER_MAX_DEPTH];
+  Ctx ctx[TG_PARSER_MAX_DEPTH];
+  Key key[TG_PARSER_MAX_DEPTH];
+  uint8_t depth = 0;
+
+  char keyBuf[12];
+  uint8_t keyLen = 0;
+  bool keyOverflow = false;
+
+  Target target = T_NONE;
+  char* strDst = nullptr;
+  size_t strCap = 0, strLen = 0;
+  bool strTrunc = false;
+  uint32_t uAcc = 0;           // \uXXXX accumulator
+  uint8_t uDigits = 0;
+  uint32_t uHigh = 0;          // pending high surrogate
+  int64_t num = 0;
+  bool numNeg = false;
+  char litFirst = 0;
+
+  TelegramUpdate cur;
+  bool okTrue = false, error = false, done = false;
+  uint32_t count = 0;
+
+  static bool isWs(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+  Key classify() const {
+    if (keyOverflow) return K_OTHER;
+    if (!strcmp(keyBuf, "ok")) return K_OK;
+    if (!strcmp(keyBuf, "result")) return K_RESULT;
+    if (!strcmp(keyBuf, "update_id")) return K_UPDATE_ID;
+    if (!strcmp(keyBuf, "message")) return K_MESSAGE;
+    if (!strcmp(keyBuf, "text")) return K_TEXT;
+    if (!strcmp(keyBuf, "from")) return K_FROM;
+    if (!strcmp(keyBuf, "username")) return K_USERNAME;
+    if (!strcmp(keyBuf, "first_name")) return K_FIRST_NAME;
+    return K_OTHER;
+  }
+
+  // What the value about to start means, given where we are
+  Ctx childCtx(bool array) const {
+    if (depth == 0) return array ? C_OTHER : C_ROOT;
+    Ctx pc = ctx[depth - 1];
+    Key k = key[depth - 1];
+    if (pc == C_ROOT && k == K_RESULT && array) return C_RESULT;
+    if (pc == C_RESULT && !array) return C_UPDATE;
+    if (pc == C_UPDATE && k == K_MESSAGE && !array) return C_MESSAGE;
+    if (pc == C_MESSAGE && k == K_FROM && !array) return C_FROM;
+    return C_OTHER;
+  }
+
+  Target scalarTarget() const {
+    if (depth == 0 || isArray[depth - 1]) return T_NONE;
+    Ctx pc = ctx[depth - 1];
+    Key k = key[depth - 1];
+    if (pc == C_ROOT && k == K_OK) return T_OK;
+    if (pc == C_UPDATE && k == K_UPDATE_ID) return T_UPDATE_ID;
+    if (pc == C_MESSAGE && k == K_TEXT) return T_TEXT;
+    if (pc == C_FROM && k == K_USERNAME) return T_USERNAME;
+    if (pc == C_FROM && k == K_FIRST_NAME) return T_FIRST_NAME;
+    return T_NONE;
+  }
+
+  void push(bool array) {
+    if (depth >= TG_PARSER_MAX_DEPTH) { error = true; return; }
+    Ctx c = childCtx(array);
+    if (c == C_UPDATE) memset(&cur, 0, sizeof(cur));
+    isArray[depth] = array;
+    ctx[depth] = c;
+    key[depth] = K_OTHER;
+    depth++;
+    state = array ? S_VALUE : S_KEY_OR_END;
+  }
+
+  void pop(bool array) {
+    if (depth == 0 || isArray[depth - 1] != array) { error = true; return; }
+    depth--;
+    if (ctx[depth] == C_UPDATE) {
+      count++;
+      if (onUpdate) onUpdate(cur, cbCtx);
+    }
+    valueDone();
+  }
+
+  void valueDone() {
+    target = T_NONE;
+    if (depth == 0) { state = S_DONE; done = true; }
+    else state = S_AFTER_VALUE;
+  }
+
+  void beginString() {
+    target = scalarTarget();
+    strDst = nullptr;
+    strCap = 0;
+    if (target == T_TEXT) { strDst = cur.text; strCap = sizeof(cur.text); cur.hasText = true; }
+    else if (target == T_USERNAME) { strDst = cur.username; strCap = sizeof(cur.username); }
+    else if (target == T_FIRST_NAME) { strDst = cur.firstName; strCap = sizeof(cur.firstName); }
+    strLen = 0;
+    strTrunc = false;
+    uHigh = 0;
+    state = S_STRING;
+  }
+
+  void putByte(uint8_t b) {
+    if (!strDst || strTrunc) return;
+    if (strLen + 1 < strCap) { strDst[strLen++] = (char)b; strDst[strLen] = 0; return; }
+    strTrunc = true;
+    // Don't leave half a UTF-8 sequence at the cut
+    size_t i = strLen;
+    while (i > 0 && ((uint8_t)strDst[i - 1] & 0xC0) == 0x80) i--;
+    if (i > 0 && ((uint8_t)strDst[i - 1] & 0x80)) {
+      uint8_t lead = (uint8_t)strDst[i - 1];
+      size_t need = (lead >= 0xF0) ? 4 : (lead >= 0xE0) ? 3 : 2;
+      if (strLen - (i - 1) < need) { strLen = i - 1; strDst[strLen] = 0; }
+    }
+  }
+
+  void putCodepoint(uint32_t cp) {
+    if (cp < 0x80) putByte((uint8_t)cp);
+    else if (cp < 0x800) { putByte(0xC0 | (cp >> 6)); putByte(0x80 | (cp & 0x3F)); }
+    else if (cp < 0x10000) { putByte(0xE0 | (cp >> 12)); putByte(0x80 | ((cp >> 6) & 0x3F)); putByte(0x80 | (cp & 0x3F)); }
+    else { putByte(0xF0 | (cp >> 18)); putByte(0x80 | ((cp >> 12) & 0x3F)); putByte(0x80 | ((cp >> 6) & 0x3F)); putByte(0x80 | (cp & 0x3F)); }
+  }
+
+  void endString() {
+    if (target == T_TEXT) cur.textTruncated = strTrunc;
+    valueDone();
+  }
+
+  void startValue(char c) {
+    if (c == '{') push(false);
+    else if (c == '[') push(true);
+    else if (c == '"') beginString();
+    else if (c == '-' || (c >= '0' && c <= '9')) {
+      target = scalarTarget();
+      num = 0;
+      numNeg = (c == '-');
+      if (!numNeg) num = c - '0';
+      state = S_NUMBER;
+    } else if (c == 't' || c == 'f' || c == 'n') {
+      target = scalarTarget();
+      litFirst = c;
+      state = S_LITERAL;
+    } else {
+      error = true;
+    }
+  }
+
+  void step(char c) {
+    switch (state) {
+      case S_VALUE:
+        if (isWs(c)) return;
+        if (c == ']' && depth > 0 && isArray[depth - 1]) { pop(true); return; }   // empty array
+        startValue(c);
+        return;
+
+      case S_KEY_OR_END:
+        if (isWs(c)) return;
+        if (c == '}') { pop(false); return; }
+        if (c != '"') { error = true; return; }
+        keyLen = 0; keyOverflow = false; keyBuf[0] = 0;
+        state = S_KEY;
+        return;
+
+      case S_KEY:
+        if (c == '\\') { state = S_KEY_ESC; keyOverflow = true; return; }
+        if (c == '"') { key[depth - 1] = classify(); state = S_COLON; return; }
+        if ((size_t)keyLen + 1 < sizeof(keyBuf)) { keyBuf[keyLen++] = c; keyBuf[keyLen] = 0; }
+        else keyOverflow = true;
+        return;
+
+      case S_KEY_ESC:
+        state = S_KEY;   // escaped keys are never ones we care about
+        return;
+
+      case S_COLON:
+        if (isWs(c)) return;
+        if (c != ':') { error = true; return; }
+        state = S_VALUE;
+        return;
+
+      case S_AFTER_VALUE:
+        if (isWs(c)) return;
+        if (c == ',') { state = isArray[depth - 1] ? S_VALUE : S_KEY_OR_END; return; }
+        if (c == '}') { pop(false); return; }
+        if (c == ']') { pop(true); return; }
+        error = true;
+        return;
+
+      case S_STRING:
+        if (c == '"') { endString(); return; }
+        if (c == '\\') { state = S_STRING_ESC; return; }
+        if (uHigh) { putCodepoint(0xFFFD); uHigh = 0; }
+        putByte((uint8_t)c);
+        return;
+
+      case S_STRING_ESC: {
+        char out = 0;
+        switch (c) {
+          case '"': out = '"'; break;
+          case '\\': out = '\\'; break;
+          case '/': out = '/'; break;
+          case 'b': out = '\b'; break;
+          case 'f': out = '\f'; break;
+          case 'n': out = '\n'; break;
+          case 'r': out = '\r'; break;
+          case 't': out = '\t'; break;
+          case 'u': uAcc = 0; uDigits = 0; state = S_STRING_U; return;
+          default: error = true; return;
+        }
+        if (uHigh) { putCodepoint(0xFFFD); uHigh = 0; }
+        putByte((uint8_t)out);
+        state = S_STRING;
+        return;
+      }
+
+      case S_STRING_U: {
+        int v;
+        if (c >= '0' && c <= '9') v = c - '0';
+        else if (c >= 'a' && c <= 'f') v = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') v = c - 'A' + 10;
+        else { error = true; return; }
+        uAcc = (uAcc << 4) | (uint32_t)v;
+        if (++uDigits < 4) return;
+        state = S_STRING;
+        if (uAcc >= 0xD800 && uAcc <= 0xDBFF) {
+          if (uHigh) putCodepoint(0xFFFD);
+          uHigh = uAcc;
+        } else if (uAcc >= 0xDC00 && uAcc <= 0xDFFF) {
+          putCodepoint(uHigh ? 0x10000 + ((uHigh - 0xD800) << 10) + (uAcc - 0xDC00) : 0xFFFD);
+          uHigh = 0;
+        } else {
+          if (uHigh) { putCodepoint(0xFFFD); uHigh = 0; }
+          putCodepoint(uAcc);
+        }
+        return;
+      }
+
+      case S_NUMBER:
+        if (c >= '0' && c <= '9') { num = num * 10 + (c - '0'); return; }
+        if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') return;   // not an id; just skip
+        if (target == T_UPDATE_ID) cur.updateId = numNeg ? -num : num;
+        valueDone();
+        step(c);   // the delimiter belongs to the container
+        return;
+
+      case S_LITERAL:
+        if (c >= 'a' && c <= 'z') return;
+        if (target == T_OK) okTrue = (litFirst == 't');
+        valueDone();
+        step(c);
+        return;
+
+      case S_DONE:
+        if (!isWs(c)) error = true;
+        return;
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""Regenerates html_page_gz.h from the INDEX_HTML literal in html_page.h.
+
+Run it from anywhere after editing the page:
+
+    python3 tools/gzip_html.py
+
+The output is deterministic (no timestamp in the gzip header), so an
+unchanged page gives an unchanged header. html_page_gz.h records the length
+of the source it was built from; a static_assert fails the sketch build when
+html_page.h no longer matches it.
+"""
+
+import gzip
+import os
+import sys
+import zlib
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SOURCE = os.path.join(ROOT, "html_page.h")
+TARGET = os.path.join(ROOT, "html_page_gz.h")
+OPEN = 'R"rawliteral('
+CLOSE = ')rawliteral"'
+
+
+def main():
+    with open(SOURCE, "rb") as f:
+        text = f.read()
+    start = text.find(OPEN.encode())
+    end = text.find(CLOSE.encode(), start)
+    if start < 0 or end < 0:
+        sys.exit("INDEX_HTML raw literal not found in html_page.h")
+    html = text[start + len(OPEN):end]
+    packed = gzip.compress(html, compresslevel=9, mtime=0)
+    crc = zlib.crc32(html) & 0xFFFFFFFF
+
+    lines = [
+        "#ifndef HTML_PAGE_GZ_H",
+        "#define HTML_PAGE_GZ_H",
+        "",
+        "// Generated by tools/gzip_html.py from html_page.h - do not edit.",
+        "// INDEX_HTML, gzip -9: %d -> %d bytes." % (len(html), len(packed)),
+        "",
+        "#define INDEX_HTML_SOURCE_LEN %d" % len(html),
+        '#define INDEX_HTML_ETAG "\\"%08x\\""' % crc,
+        '#define INDEX_HTML_GZ_ETAG "\\"%08x-gz\\""' % crc,
+        "",
+        "const size_t INDEX_HTML_GZ_LEN = %d;" % len(packed),
+        "const uint8_t INDEX_HTML_GZ[] PROGMEM = {",
+    ]
+    for i in range(0, len(packed), 16):
+        chunk = packed[i:i + 16]
+        lines.append("  " + ", ".join("0x%02x" % b for b in chunk) + ",")
+    lines += [
+        "};",
+        "",
+        "static_assert(sizeof(INDEX_HTML) - 1 == INDEX_HTML_SOURCE_LEN,",
+        '              "html_page.h changed: run tools/gzip_html.py");',
+        "",
+        "#endif",
+        "",
+    ]
+    with open(TARGET, "w", newline="\n") as f:
+        f.write("\n".join(lines))
+    print("html_page_gz.h: %d -> %d bytes" % (len(html), len(packed)))
+
+
+if __name__ == "__main__":
+    main()
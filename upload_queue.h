@@ -0,0 +1,227 @@
+#ifndef UPLOAD_QUEUE_H
+#define UPLOAD_QUEUE_H
+
+// ------------ Capture -> upload pipeline ------------
+// captureImage() copies the JPEG into PSRAM and returns the camera frame
+// buffer immediately; a dedicated task drains this bounded queue and does
+// the (slow) Telegram upload, so loop() keeps serving web/commands/motion.
+// Failed uploads go to the flash outbox, which the task drains when idle.
+
+#ifndef UPLOAD_QUEUE_DEPTH
+#define UPLOAD_QUEUE_DEPTH 4
+#endif
+#ifndef UPLOAD_DROP_OLDEST
+#define UPLOAD_DROP_OLDEST 1        // 1 = evict oldest when full, 0 = reject newest
+#endif
+#define UPLOAD_HISTORY 6
+#define UPLOAD_TASK_STACK 8192
+
+struct UploadItem {
+  uint32_t id;
+  uint8_t* buf;
+  size_t len;
+  int8_t event;          // >= 0: pre-event album sent from the ring (prebuffer.h), buf unused
+  int8_t burst;          // >= 0: burst set (burst.h), buf unused
+  char caption[96];
+  unsigned long enqueuedMs;
+  unsigned long dequeuedMs;
+  unsigned long doneMs;
+  bool ok;
+};
+
+static UploadItem uploadRing[UPLOAD_QUEUE_DEPTH];
+static UploadItem uploadHistory[UPLOAD_HISTORY];   // finished items (buf == nullptr)
+static int uploadHead = 0;
+static int uploadCount = 0;
+static int uploadHistoryNext = 0;
+static uint32_t uploadNextId = 1;
+static uint32_t uploadDropped = 0;
+static uint32_t uploadOk = 0;
+static uint32_t uploadFailed = 0;
+static UploadItem uploadInFlight;
+static bool uploadBusy = false;
+
+static SemaphoreHandle_t uploadMutex = nullptr;
+static SemaphoreHandle_t uploadSignal = nullptr;
+
+static void* uploadAlloc(size_t n) {
+  void* p = psramFound() ? ps_malloc(n) : nullptr;
+  return p ? p : malloc(n);
+}
+
+// Frees what an item owns: its copy, or its pinned ring frames
+static void releaseUploadItem(const UploadItem& it) {
+  if (it.event >= 0) releasePreEvent(it.event);
+  else if (it.burst >= 0) releaseBurst(it.burst);
+  else free(it.buf);
+}
+
+// Takes ownership of `copy` / `event` / `burst`; false when the queue is full
+// under the drop-newest policy (nothing is released then).
+static bool pushUpload(uint8_t* copy, size_t len, int event, int burst, const char* caption) {
+  UploadItem evicted;
+  bool haveEvicted = false;
+  xSemaphoreTake(uploadMutex, portMAX_DELAY);
+  if (uploadCount == UPLOAD_QUEUE_DEPTH) {
+    if (!UPLOAD_DROP_OLDEST) {
+      uploadDropped++;
+      logEvent(EV_QUEUE_DROP, uploadDropped);
+      xSemaphoreGive(uploadMutex);
+      return false;
+    }
+    evicted = uploadRing[uploadHead];
+    haveEvicted = true;
+    uploadHead = (uploadHead + 1) % UPLOAD_QUEUE_DEPTH;
+    uploadCount--;
+    uploadDropped++;
+    logEvent(EV_QUEUE_DROP, uploadDropped);
+  }
+
+  UploadItem& it = uploadRing[(uploadHead + uploadCount) % UPLOAD_QUEUE_DEPTH];
+  it.id = uploadNextId++;
+  it.buf = copy;
+  it.len = len;
+  it.event = (int8_t)event;
+  it.burst = (int8_t)burst;
+  strncpy(it.caption, caption, sizeof(it.caption) - 1);
+  it.caption[sizeof(it.caption) - 1] = 0;
+  it.enqueuedMs = millis();
+  it.dequeuedMs = 0;
+  it.doneMs = 0;
+  it.ok = false;
+  uploadCount++;
+  xSemaphoreGive(uploadMutex);
+
+  if (haveEvicted) releaseUploadItem(evicted);
+  xSemaphoreGive(uploadSignal);
+  return true;
+}
+
+// Copies `len` bytes; returns false when the copy could not be allocated or
+// the queue is full under the drop-newest policy.
+bool enqueueUpload(const uint8_t* buf, size_t len, const char* caption) {
+  if (!uploadMutex) return false;
+
+  uint8_t* copy = (uint8_t*)uploadAlloc(len);
+  if (!copy) return false;
+  memcpy(copy, buf, len);
+
+  if (pushUpload(copy, len, -1, -1, caption)) return true;
+  free(copy);
+  return false;
+}
+
+// A closed pre-event album; no copy, the frames stay pinned in the ring
+bool enqueueAlbum(int event, const char* caption) {
+  if (!uploadMutex) return false;
+  return pushUpload(nullptr, 0, event, -1, caption);
+}
+
+// A burst set; its PSRAM copies are released after the upload
+bool enqueueBurst(int burst, size_t bytes, const char* caption) {
+  if (!uploadMutex) return false;
+  return pushUpload(nullptr, bytes, -1, burst, caption);
+}
+
+static void uploadTask(void*) {
+  for (;;) {
+    xSemaphoreTake(uploadSignal, pdMS_TO_TICKS(1000));
+
+    for (;;) {
+      xSemaphoreTake(uploadMutex, portMAX_DELAY);
+      if (uploadCount == 0) {
+        xSemaphoreGive(uploadMutex);
+        break;
+      }
+      uploadInFlight = uploadRing[uploadHead];
+      uploadHead = (uploadHead + 1) % UPLOAD_QUEUE_DEPTH;
+      uploadCount--;
+      uploadInFlight.dequeuedMs = millis();
+      uploadBusy = true;
+      xSemaphoreGive(uploadMutex);
+
+      bool ok;
+      if (uploadInFlight.event >= 0) ok = sendPreEventAlbum(uploadInFlight.event);
+      else if (uploadInFlight.burst >= 0) ok = sendBurst(uploadInFlight.burst);
+      else ok = sendPhotoBuffer(uploadInFlight.buf, uploadInFlight.len, uploadInFlight.caption);
+      if (ok) {
+        outboxKick();
+      } else if (!uploadFailureRetryable()) {
+        outboxRefused();
+      } else if (uploadInFlight.event >= 0) {
+        storePreEventInOutbox(uploadInFlight.event);
+      } else if (uploadInFlight.burst >= 0) {
+        storeBurstInOutbox(uploadInFlight.burst);
+      } else {
+        outboxStore(uploadInFlight.buf, uploadInFlight.len, uploadInFlight.caption);
+      }
+      releaseUploadItem(uploadInFlight);
+
+      xSemaphoreTake(uploadMutex, portMAX_DELAY);
+      uploadInFlight.buf = nullptr;
+      uploadInFlight.doneMs = millis();
+      uploadInFlight.ok = ok;
+      uploadHistory[uploadHistoryNext] = uploadInFlight;
+      uploadHistoryNext = (uploadHistoryNext + 1) % UPLOAD_HISTORY;
+      uploadBusy = false;
+      if (ok) uploadOk++; else uploadFailed++;
+      xSemaphoreGive(uploadMutex);
+
+      onUploadFinished(ok);
+    }
+
+    // Idle: retry photos parked on flash (outbox.h), oldest captures first;
+    // a fresh capture in the RAM queue still goes ahead of them
+    while (uploadCount == 0 && outboxDrainOne()) {}
+  }
+}
+
+void startUploadPipeline() {
+  uploadMutex = xSemaphoreCreateMutex();
+  uploadSignal = xSemaphoreCreateBinary();
+  // Core 0 next to the WiFi stack; loop() stays on core 1
+  xTaskCreatePinnedToCore(uploadTask, "upload", UPLOAD_TASK_STACK, nullptr, 1, nullptr, 0);
+}
+
+static void addUploadItemJson(JsonArray& arr, const UploadItem& it, const char* state) {
+  JsonObject o = arr.createNestedObject();
+  o["id"] = it.id;
+  o["state"] = state;
+  if (it.event >= 0) o["album"] = true;
+  if (it.burst >= 0) o["burst"] = true;
+  o["bytes"] = (unsigned)it.len;
+  o["enqueuedMs"] = it.enqueuedMs;
+  o["dequeuedMs"] = it.dequeuedMs;
+  o["doneMs"] = it.doneMs;
+  if (it.doneMs) o["waitMs"] = it.dequeuedMs - it.enqueuedMs;
+  if (it.doneMs) o["uploadMs"] = it.doneMs - it.dequeuedMs;
+}
+
+void fillUploadQueueStatus(JsonObject q) {
+  if (!uploadMutex) return;
+  xSemaphoreTake(uploadMutex, portMAX_DELAY);
+  q["depth"] = uploadCount;
+  q["capacity"] = UPLOAD_QUEUE_DEPTH;
+  q["dropPolicy"] = UPLOAD_DROP_OLDEST ? "oldest" : "newest";
+  q["dropped"] = uploadDropped;
+  q["uploaded"] = uploadOk;
+  q["failed"] = uploadFailed;
+
+  JsonArray items = q.createNestedArray("items");
+  for (int i = 0; i < uploadCount; i++) {
+    addUploadItemJson(items, uploadRing[(uploadHead + i) % UPLOAD_QUEUE_DEPTH], "queued");
+  }
+  if (uploadBusy) addUploadItemJson(items, uploadInFlight, "uploading");
+  for (int i = 1; i <= UPLOAD_HISTORY; i++) {
+    const UploadItem& h = uploadHistory[(uploadHistoryNext - i + UPLOAD_HISTORY) % UPLOAD_HISTORY];
+    if (h.id == 0) break;
+    addUploadItemJson(items, h, h.ok ? "sent" : "failed");
+  }
+  xSemaphoreGive(uploadMutex);
+}
+
+int uploadQueueDepth() {
+  return uploadCount + (uploadBusy ? 1 : 0);
+}
+
+#endif
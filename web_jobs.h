@@ -0,0 +1,272 @@
+#ifndef WEB_JOBS_H
+#define WEB_JOBS_H
+
+// ------------ Web server task, background jobs, handler latency ------------
+// server.handleClient() runs in its own task, so a slow browser no longer
+// stalls loop() (motion, commands) and a long Telegram reply in loop() no
+// longer stalls the web UI. Handlers only do quick work: /capture-now and
+// /test-telegram enqueue a job, answer 202 with its ID right away, and the
+// page polls /job?id=N until the job worker reports the result.
+//
+// Every route is timed into a log2 histogram; /debug -> web shows count,
+// average, p99 and max per route. Build with WEB_SERVER_TASK 0 (see
+// definitions.h) to service the server from loop() as before and compare.
+
+#define WEB_JOB_SLOTS 8
+#define WEB_MAX_ROUTES 16
+#define WEB_HIST_BUCKETS 24          // bucket b: < 2^b us (last one open-ended)
+#define WEB_TASK_STACK 8192
+#define WEB_JOB_STACK 8192
+
+enum WebJobKind : uint8_t { JOB_CAPTURE, JOB_TELEGRAM_TEST, JOB_BURST };
+enum WebJobState : uint8_t { JOB_QUEUED, JOB_RUNNING, JOB_DONE, JOB_FAILED };
+
+struct WebJob {
+  uint32_t id;                 // 0 = free slot
+  WebJobKind kind;
+  uint32_t arg[3];             // JOB_BURST: frames, interval ms, single
+  volatile WebJobState state;
+  unsigned long queuedMs;
+  unsigned long startedMs;
+  unsigned long doneMs;
+  char result[80];
+};
+
+struct WebRouteStats {
+  const char* path;
+  uint32_t count;
+  uint32_t maxUs;
+  uint64_t totalUs;
+  uint16_t hist[WEB_HIST_BUCKETS];
+};
+
+static WebJob webJobs[WEB_JOB_SLOTS];
+static uint32_t webNextJobId = 1;
+static uint32_t webJobsRejected = 0;
+static SemaphoreHandle_t webJobMutex = nullptr;
+static QueueHandle_t webJobQueue = nullptr;
+
+static WebRouteStats webRoutes[WEB_MAX_ROUTES];
+static int webRouteCount = 0;
+static uint32_t webRequests = 0;
+static unsigned long webLastServiceMs = 0;
+static unsigned long webMaxServiceGapMs = 0;  // longest time nobody called handleClient()
+
+static const char* webJobKindName(WebJobKind k) {
+  return k == JOB_CAPTURE ? "capture" : k == JOB_BURST ? "burst" : "telegram-test";
+}
+
+static const char* webJobStateName(WebJobState s) {
+  return s == JOB_QUEUED ? "queued" : s == JOB_RUNNING ? "running" : s == JOB_DONE ? "done" : "failed";
+}
+
+// Returns the job ID, or 0 when every slot holds an unfinished job
+uint32_t enqueueWebJob(WebJobKind kind, uint32_t a0 = 0, uint32_t a1 = 0, uint32_t a2 = 0) {
+  if (!webJobMutex) return 0;
+  xSemaphoreTake(webJobMutex, portMAX_DELAY);
+  int slot = -1;
+  uint32_t oldest = 0;
+  for (int i = 0; i < WEB_JOB_SLOTS; i++) {
+    const WebJob& j = webJobs[i];
+    if (j.id == 0) { slot = i; break; }
+    bool finished = j.state == JOB_DONE || j.state == JOB_FAILED;
+    if (finished && (oldest == 0 || j.id < oldest)) { oldest = j.id; slot = i; }
+  }
+  uint32_t id = 0;
+  if (slot >= 0) {
+    WebJob& j = webJobs[slot];
+    id = webNextJobId++;
+    j.id = id;
+    j.kind = kind;
+    j.arg[0] = a0;
+    j.arg[1] = a1;
+    j.arg[2] = a2;
+    j.state = JOB_QUEUED;
+    j.queuedMs = millis();
+    j.startedMs = j.doneMs = 0;
+    j.result[0] = 0;
+    int s = slot;
+    xQueueSend(webJobQueue, &s, 0);   // queue length == slot count, never full
+  } else {
+    webJobsRejected++;
+  }
+  xSemaphoreGive(webJobMutex);
+  return id;
+}
+
+static void webJobTask(void*) {
+  int slot;
+  for (;;) {
+    if (xQueueReceive(webJobQueue, &slot, portMAX_DELAY) != pdTRUE) continue;
+    WebJob& j = webJobs[slot];
+    xSemaphoreTake(webJobMutex, portMAX_DELAY);
+    j.startedMs = millis();
+    j.state = JOB_RUNNING;
+    WebJobKind kind = j.kind;
+    uint32_t arg[3] = { j.arg[0], j.arg[1], j.arg[2] };
+    xSemaphoreGive(webJobMutex);
+
+    bool ok;
+    InlineText<sizeof(j.result)> detail;
+    if (kind == JOB_CAPTURE) {
+      ok = captureImage("Manual");
+    } else if (kind == JOB_BURST) {
+      ok = captureBurst((int)arg[0], arg[1], arg[2] != 0, detail);
+    } else {
+      ok = testTelegramConnection();
+    }
+    if (kind == JOB_CAPTURE) {
+      detail = ok ? "Capture queued for upload" : "Capture failed (camera or upload queue)";
+    } else if (kind == JOB_TELEGRAM_TEST) {
+      StatusLock lock;
+      detail = telegramDebug;
+    }
+
+    xSemaphoreTake(webJobMutex, portMAX_DELAY);
+    memcpy(j.result, detail.c_str(), detail.length() + 1);
+    j.doneMs = millis();
+    j.state = ok ? JOB_DONE : JOB_FAILED;
+    xSemaphoreGive(webJobMutex);
+  }
+}
+
+// 202 {"job":N} or 503 when the job table is full of unfinished work
+static void replyJobQueued(uint32_t id) {
+  if (id == 0) {
+    server.send(503, "application/json", "{\"error\":\"busy\"}");
+    return;
+  }
+  char body[24];
+  int n = snprintf(body, sizeof(body), "{\"job\":%lu}", (unsigned long)id);
+  server.send_P(202, "application/json", body, n);
+}
+
+static void handleJobStatus() {
+  uint32_t id = (uint32_t)server.arg("id").toInt();
+  StaticJsonDocument<256> doc;
+  bool found = false;
+  xSemaphoreTake(webJobMutex, portMAX_DELAY);
+  for (int i = 0; i < WEB_JOB_SLOTS; i++) {
+    const WebJob& j = webJobs[i];
+    if (id == 0 || j.id != id) continue;
+    found = true;
+    doc["job"] = j.id;
+    doc["kind"] = webJobKindName(j.kind);
+    doc["state"] = webJobStateName(j.state);
+    doc["result"] = (const char*)j.result;
+    doc["waitMs"] = (j.startedMs ? j.startedMs : millis()) - j.queuedMs;
+    doc["runMs"] = j.startedMs ? (j.doneMs ? j.doneMs : millis()) - j.startedMs : 0;
+  }
+  xSemaphoreGive(webJobMutex);
+
+  if (!found) {
+    server.send(404, "application/json", "{\"error\":\"unknown job\"}");
+    return;
+  }
+  char response[256];
+  size_t n = serializeJson(doc, response, sizeof(response));
+  server.send_P(200, "application/json", response, n);
+}
+
+static uint8_t webHistBucket(uint32_t us) {
+  uint8_t b = 0;
+  while (b < WEB_HIST_BUCKETS - 1 && us >= (1UL << b)) b++;
+  return b;
+}
+
+// Upper bound (us) of the bucket holding the p-th percentile
+static uint32_t webPercentileUs(const WebRouteStats& r, uint8_t pct) {
+  if (r.count == 0) return 0;
+  uint32_t want = (r.count * pct + 99) / 100;
+  uint32_t seen = 0;
+  for (uint8_t b = 0; b < WEB_HIST_BUCKETS; b++) {
+    seen += r.hist[b];
+    if (seen >= want) return b == WEB_HIST_BUCKETS - 1 ? r.maxUs : (1UL << b);
+  }
+  return r.maxUs;
+}
+
+// server.on() with per-route timing
+void webRoute(const char* path, HTTPMethod method, std::function<void(void)> fn) {
+  if (webRouteCount >= WEB_MAX_ROUTES) {
+    server.on(path, method, fn);
+    return;
+  }
+  WebRouteStats* r = &webRoutes[webRouteCount++];
+  r->path = path;
+  server.on(path, method, [r, fn]() {
+    unsigned long t0 = micros();
+    fn();
+    uint32_t dt = micros() - t0;
+    webRequests++;
+    r->count++;
+    r->totalUs += dt;
+    if (dt > r->maxUs) r->maxUs = dt;
+    uint16_t& h = r->hist[webHistBucket(dt)];
+    if (h < 0xFFFF) h++;
+  });
+}
+
+// From the web task, or from loop() when WEB_SERVER_TASK is 0
+void serviceWebServer() {
+  unsigned long now = millis();
+  if (webLastServiceMs && now - webLastServiceMs > webMaxServiceGapMs) {
+    webMaxServiceGapMs = now - webLastServiceMs;
+  }
+  server.handleClient();
+  liveEventsTick();
+  webLastServiceMs = millis();
+}
+
+#if WEB_SERVER_TASK
+static void webServerTask(void*) {
+  for (;;) {
+    serviceWebServer();
+    vTaskDelay(pdMS_TO_TICKS(2));
+  }
+}
+#endif
+
+// Called from setup() after setupServerRoutes()
+void startWebServer() {
+  webJobMutex = xSemaphoreCreateMutex();
+  webJobQueue = xQueueCreate(WEB_JOB_SLOTS, sizeof(int));
+  xTaskCreatePinnedToCore(webJobTask, "webjobs", WEB_JOB_STACK, nullptr, 1, nullptr, 1);
+#if WEB_SERVER_TASK
+  xTaskCreatePinnedToCore(webServerTask, "web", WEB_TASK_STACK, nullptr, 1, nullptr, 1);
+#endif
+}
+
+void fillWebStats(JsonObject o) {
+  unsigned long upMs = millis();
+  o["serverTask"] = WEB_SERVER_TASK;
+  o["requests"] = webRequests;
+  o["requestsPerMin"] = upMs ? (float)webRequests * 60000.0f / upMs : 0.0f;
+  o["maxServiceGapMs"] = webMaxServiceGapMs;
+  o["jobsRejected"] = webJobsRejected;
+
+  JsonArray a = o.createNestedArray("routes");
+  for (int i = 0; i < webRouteCount; i++) {
+    const WebRouteStats& r = webRoutes[i];
+    if (r.count == 0) continue;
+    JsonObject e = a.createNestedObject();
+    e["path"] = r.path;
+    e["count"] = r.count;
+    e["avgUs"] = (uint32_t)(r.totalUs / r.count);
+    e["p99Us"] = webPercentileUs(r, 99);
+    e["maxUs"] = r.maxUs;
+  }
+}
+
+void webStatsLine(FixedText& out) {
+  uint32_t worst = 0;
+  const char* worstPath = "-";
+  for (int i = 0; i < webRouteCount; i++) {
+    uint32_t p = webPercentileUs(webRoutes[i], 99);
+    if (p > worst) { worst = p; worstPath = webRoutes[i].path; }
+  }
+  out.addf("web: %lu req, worst p99 %lu ms (%s), service gap %lu ms max", (unsigned long)webRequests,
+           (unsigned long)(worst / 1000UL), worstPath, webMaxServiceGapMs);
+}
+
+#endif
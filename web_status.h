@@ -0,0 +1,267 @@
+#ifndef WEB_STATUS_H
+#define WEB_STATUS_H
+
+// ------------ Cached /status snapshot and the compressed page ------------
+// Every open dashboard polls /status every 4 s. The JSON is serialized once
+// into a snapshot buffer and served from there until something changes:
+// markStatusChanged() (status text, counters, settings) bumps statusVersion,
+// and the snapshot is also rebuilt once it is STATUS_SNAPSHOT_MAX_AGE_MS old
+// so uptime, motion and ring figures keep moving. The ETag is the CRC32 of
+// the snapshot bytes; a poll carrying it in If-None-Match gets an empty 304.
+//
+// "/" serves INDEX_HTML gzip-compressed from html_page_gz.h (generated by
+// tools/gzip_html.py) with a long max-age and an ETag, or uncompressed when
+// the browser does not accept gzip.
+//
+// /debug -> webCache counts 200s, 304s and body bytes per minute for both;
+// build with STATUS_CACHE 0 to serve every poll in full (the old behaviour)
+// and compare.
+
+#ifndef STATUS_CACHE
+#define STATUS_CACHE 1
+#endif
+#ifndef STATUS_SNAPSHOT_MAX_AGE_MS
+#define STATUS_SNAPSHOT_MAX_AGE_MS 10000UL
+#endif
+#define STATUS_SNAPSHOT_MAX 4096
+#ifndef INDEX_CACHE_MAX_AGE_S
+#define INDEX_CACHE_MAX_AGE_S 86400UL
+#endif
+
+struct StatusSnapshot {
+  char* json = nullptr;          // STATUS_SNAPSHOT_MAX bytes, allocated once
+  size_t len = 0;
+  uint32_t version = 0;          // statusVersion it was built from
+  unsigned long builtMs = 0;
+  char etag[12] = "";
+};
+
+struct WebCacheStats {
+  uint32_t statusFull = 0;       // 200 with a body
+  uint32_t statusNotModified = 0;
+  uint32_t statusRebuilds = 0;
+  uint32_t statusTooBig = 0;     // streamed uncached
+  uint32_t docOverflows = 0;     // webJsonDoc ran out of room: members silently missing
+  size_t docPeakBytes = 0;       // webJsonDoc high-water mark
+  uint32_t indexFull = 0;
+  uint32_t indexNotModified = 0;
+  uint64_t bodyBytes = 0;
+  uint32_t minuteBytes = 0;
+  uint32_t lastMinuteBytes = 0;  // body bytes of /status and / in the last full minute
+  unsigned long minuteStartMs = 0;
+};
+
+static volatile uint32_t statusVersion = 1;
+static StatusSnapshot statusSnap;
+static WebCacheStats webCache;
+
+// Web handlers run one at a time, so /status and /debug share one document
+// that lives for the whole uptime, and uncached text goes out in small
+// chunks from the stack: no document or response String per request.
+// /debug is the worst case: two dozen top-level members, 13 stats objects
+// (plus the poll link's), the per-route table and the MJPEG / SSE viewer
+// lists, all full at once, with room for copied strings.
+#define WEB_JSON_SSE_CLIENTS 4   // SSE_MAX_CLIENTS the size allows (live_events.h checks)
+#define WEB_JSON_DOC_SIZE                                                                        \
+  (JSON_OBJECT_SIZE(25) + 14 * JSON_OBJECT_SIZE(18) +                                            \
+   JSON_ARRAY_SIZE(WEB_MAX_ROUTES) + WEB_MAX_ROUTES * JSON_OBJECT_SIZE(5) +                      \
+   JSON_ARRAY_SIZE(MJPEG_MAX_CLIENTS) + MJPEG_MAX_CLIENTS * JSON_OBJECT_SIZE(6) +                \
+   JSON_ARRAY_SIZE(WEB_JSON_SSE_CLIENTS) + WEB_JSON_SSE_CLIENTS * JSON_OBJECT_SIZE(4) + 512)
+static StaticJsonDocument<WEB_JSON_DOC_SIZE> webJsonDoc;
+
+class WebChunkWriter : public Print {
+ public:
+  size_t write(uint8_t c) override {
+    buf[n++] = c;
+    if (n == sizeof(buf)) flush();
+    return 1;
+  }
+
+  size_t write(const uint8_t* p, size_t len) override {
+    for (size_t i = 0; i < len; i++) write(p[i]);
+    return len;
+  }
+
+  void flush() {
+    if (n) server.sendContent((const char*)buf, n);
+    n = 0;
+  }
+
+ private:
+  uint8_t buf[512];
+  size_t n = 0;
+};
+
+static size_t sendJsonDoc(const JsonDocument& doc, bool pretty) {
+  size_t len = pretty ? measureJsonPretty(doc) : measureJson(doc);
+  server.setContentLength(len);
+  server.send(200, "application/json", "");
+  WebChunkWriter out;
+  if (pretty) serializeJsonPretty(doc, out);
+  else serializeJson(doc, out);
+  out.flush();
+  return len;
+}
+
+// After filling webJsonDoc: count a document that ran out of room, as
+// statusTooBig counts one that did not fit the snapshot
+static void noteWebJsonDoc() {
+  if (webJsonDoc.overflowed()) webCache.docOverflows++;
+  if (webJsonDoc.memoryUsage() > webCache.docPeakBytes) webCache.docPeakBytes = webJsonDoc.memoryUsage();
+}
+
+// Any task; cheap enough for every status change
+void markStatusChanged() {
+  __atomic_add_fetch(&statusVersion, 1, __ATOMIC_RELAXED);
+}
+
+static void countWebBytes(size_t n) {
+  unsigned long now = millis();
+  if (now - webCache.minuteStartMs >= 60000UL) {
+    webCache.lastMinuteBytes = webCache.minuteBytes;
+    webCache.minuteBytes = 0;
+    webCache.minuteStartMs = now;
+  }
+  webCache.minuteBytes += n;
+  webCache.bodyBytes += n;
+}
+
+static bool clientHasEtag(const char* etag) {
+  if (!STATUS_CACHE || !server.hasHeader("If-None-Match")) return false;
+  return strstr(server.header("If-None-Match").c_str(), etag) != nullptr;
+}
+
+// The status text is copied into the document ((char*) makes ArduinoJson
+// copy), so it can be serialized after the lock is gone
+static void fillStatusDoc(JsonDocument& doc, const char* uptime) {
+  StatusLock lock;
+  doc["capturedCount"] = capturedCount;
+  doc["sentCount"] = sentCount;
+  doc["lastCaptureTime"] = (char*)lastCaptureTime.c_str();
+  doc["lastCaptureType"] = (char*)lastCaptureType.c_str();
+  doc["lastTelegramResult"] = (char*)lastTelegramResult.c_str();
+  doc["captureMode"] = captureMode;
+  doc["timeInterval"] = timeInterval;
+  doc["motionThreshold"] = motionThreshold;
+  doc["uptime"] = (char*)uptime;
+  doc["telegramDebug"] = (char*)telegramDebug.c_str();
+  doc["motionCells"] = lastMotion.changedCells;
+  doc["motionShift"] = lastMotion.globalShift;
+  doc["motionCostUs"] = lastMotionCostUs;
+  doc["motionGapMs"] = motionGapMs;
+  doc["motionMaxGapMs"] = motionMaxGapMs;
+  doc["motionFromStream"] = motionFromStream;
+  JsonArray box = doc.createNestedArray("motionBox");
+  box.add(lastMotion.boxX);
+  box.add(lastMotion.boxY);
+  box.add(lastMotion.boxW);
+  box.add(lastMotion.boxH);
+  doc["currentMode"] = (captureMode == 0) ? "Motion Detection" :
+                       (captureMode == 1) ? "Time Based" : "Mixed Mode";
+  fillUploadQueueStatus(doc.createNestedObject("uploadQueue"));
+  fillPrebufferStatus(doc.createNestedObject("prebuffer"));
+  fillOutboxStatus(doc.createNestedObject("outbox"));
+  fillScheduleStatus(doc.createNestedObject("schedule"));
+  fillDedupStatus(doc.createNestedObject("dedup"));
+}
+
+// Rebuilds the snapshot when it is stale. False when the JSON did not fit;
+// webJsonDoc then still holds it for the caller to stream.
+static bool buildStatusSnapshot() {
+  uint32_t version = statusVersion;
+  unsigned long now = millis();
+  if (STATUS_CACHE && statusSnap.len && version == statusSnap.version &&
+      now - statusSnap.builtMs < STATUS_SNAPSHOT_MAX_AGE_MS) {
+    return true;
+  }
+
+  if (!statusSnap.json) statusSnap.json = (char*)uploadAlloc(STATUS_SNAPSHOT_MAX);
+  JsonDocument& doc = webJsonDoc;
+  doc.clear();
+  InlineText<24> uptime = uptimeText();
+  fillStatusDoc(doc, uptime.c_str());
+  noteWebJsonDoc();
+  if (!statusSnap.json || measureJson(doc) >= STATUS_SNAPSHOT_MAX) {
+    webCache.statusTooBig++;
+    statusSnap.len = 0;
+    return false;
+  }
+  statusSnap.len = serializeJson(doc, statusSnap.json, STATUS_SNAPSHOT_MAX);
+  statusSnap.version = version;
+  statusSnap.builtMs = now;
+  uint32_t crc = crc32Update(0, (const uint8_t*)statusSnap.json, statusSnap.len);
+  snprintf(statusSnap.etag, sizeof(statusSnap.etag), "\"%08lx\"", (unsigned long)crc);
+  webCache.statusRebuilds++;
+  return true;
+}
+
+// GET /status
+void handleStatus() {
+  if (!buildStatusSnapshot()) {
+    countWebBytes(sendJsonDoc(webJsonDoc, false));
+    return;
+  }
+  server.sendHeader("Cache-Control", "no-cache");
+  if (STATUS_CACHE) server.sendHeader("ETag", statusSnap.etag);
+  if (clientHasEtag(statusSnap.etag)) {
+    webCache.statusNotModified++;
+    server.send(304);
+    return;
+  }
+  webCache.statusFull++;
+  server.send_P(200, "application/json", statusSnap.json, statusSnap.len);
+  countWebBytes(statusSnap.len);
+}
+
+// GET /
+void handleIndex() {
+  bool gzip = server.header("Accept-Encoding").indexOf("gzip") >= 0;
+  const char* etag = gzip ? INDEX_HTML_GZ_ETAG : INDEX_HTML_ETAG;
+  char maxAge[32];
+  snprintf(maxAge, sizeof(maxAge), "max-age=%lu", (unsigned long)INDEX_CACHE_MAX_AGE_S);
+  server.sendHeader("Cache-Control", maxAge);
+  server.sendHeader("Vary", "Accept-Encoding");
+  server.sendHeader("ETag", etag);
+  if (clientHasEtag(etag)) {
+    webCache.indexNotModified++;
+    server.send(304);
+    return;
+  }
+  webCache.indexFull++;
+  if (gzip) {
+    server.sendHeader("Content-Encoding", "gzip");
+    server.send_P(200, "text/html", (const char*)INDEX_HTML_GZ, INDEX_HTML_GZ_LEN);
+    countWebBytes(INDEX_HTML_GZ_LEN);
+  } else {
+    server.send_P(200, "text/html", INDEX_HTML, sizeof(INDEX_HTML) - 1);
+    countWebBytes(sizeof(INDEX_HTML) - 1);
+  }
+}
+
+// setupServerRoutes(): the request headers the handlers above look at
+void collectWebCacheHeaders() {
+  static const char* headers[] = { "If-None-Match", "Accept-Encoding" };
+  server.collectHeaders(headers, 2);
+}
+
+void fillWebCacheStats(JsonObject o) {
+  o["enabled"] = STATUS_CACHE;
+  o["statusVersion"] = statusVersion;
+  o["statusBytes"] = statusSnap.len;
+  o["statusEtag"] = (const char*)statusSnap.etag;
+  o["statusFull"] = webCache.statusFull;
+  o["statusNotModified"] = webCache.statusNotModified;
+  o["statusRebuilds"] = webCache.statusRebuilds;
+  o["statusTooBig"] = webCache.statusTooBig;
+  o["docBytes"] = WEB_JSON_DOC_SIZE;
+  o["docPeakBytes"] = webCache.docPeakBytes;
+  o["docOverflows"] = webCache.docOverflows;
+  o["indexFull"] = webCache.indexFull;
+  o["indexNotModified"] = webCache.indexNotModified;
+  o["indexGzipBytes"] = INDEX_HTML_GZ_LEN;
+  o["indexBytes"] = sizeof(INDEX_HTML) - 1;
+  o["bodyBytes"] = webCache.bodyBytes;
+  o["bodyBytesLastMinute"] = webCache.lastMinuteBytes;
+}
+
+#endif